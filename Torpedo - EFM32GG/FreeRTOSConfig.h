@@ -92,6 +92,11 @@ extern "C" {
 /* Modes of operations of operation system*/
 #define configUSE_PREEMPTION                      ( 1 )
 #define configUSE_TIME_SLICING                    ( 1 )
+
+/* Tickless idle. 2 selects the implementation in src/low_power.c, which
+ * suppresses the tick and sleeps in EM2 on the RTC, 0 keeps the tick running.
+ * In EM2 only a falling edge on the UART RX pin wakes the board, so the host
+ * must send the wake byte of pep_hf_unix before its commands. */
 #define configUSE_TICKLESS_IDLE                   ( 0 )
 
 /* The frequency of the RTOS tick interrupt */
@@ -102,10 +107,12 @@ extern "C" {
 
 /* Main functions*/
 #define configMAX_PRIORITIES                      ( 5 )
-#define configMINIMAL_STACK_SIZE                  (( unsigned short ) 140)
+/* The idle task gets configMINIMAL_STACK_SIZE words. In the co-routine build it
+ * also runs the display, telemetry and history co-routines, so it gets more. */
+#define configMINIMAL_STACK_SIZE                  (( unsigned short ) ( configUSE_CO_ROUTINES ? 200 : 140 ))
 #define configTOTAL_HEAP_SIZE                     (( size_t )(9000))
 #define configMAX_TASK_NAME_LEN                   ( 16 )
-#define configUSE_TRACE_FACILITY                  ( 0 )
+#define configUSE_TRACE_FACILITY                  ( configGENERATE_RUN_TIME_STATS || configUSE_EVENT_TRACE )
 #define configUSE_16_BIT_TICKS                    ( 0 )
 #define configIDLE_SHOULD_YIELD                   ( 0 )
 #define configUSE_MUTEXES                         ( 1 )
@@ -115,21 +122,57 @@ extern "C" {
 #define configQUEUE_REGISTRY_SIZE                 ( 10 )
 #define configUSE_QUEUE_SETS                      ( 0 )
 
-/* Hook function related definitions. */
+/* Memory allocation related definitions. The Static build configuration of
+ * the project defines configSUPPORT_STATIC_ALLOCATION as 1 for the zero-heap
+ * build: every task, queue and stream buffer is then created from statically
+ * allocated storage, and heap_1.c is excluded from that configuration. */
+#ifndef configSUPPORT_STATIC_ALLOCATION
+#define configSUPPORT_STATIC_ALLOCATION           ( 0 )
+#endif
+#define configSUPPORT_DYNAMIC_ALLOCATION          ( configSUPPORT_STATIC_ALLOCATION == 0 )
+
+/* Hook function related definitions. The idle hook schedules the co-routines. */
 #define configUSE_TICK_HOOK                       ( 0 )
 #define configCHECK_FOR_STACK_OVERFLOW            ( 0 )
 #define configUSE_MALLOC_FAILED_HOOK              ( 0 )
-#define configUSE_IDLE_HOOK                       ( 0 )
+#define configUSE_IDLE_HOOK                       ( configUSE_CO_ROUTINES )
 
-/* Run time stats gathering related definitions. */
+/* Run time stats gathering related definitions. Set configGENERATE_RUN_TIME_STATS
+ * to 1 for the runtime-stats build: the run time of the tasks is counted by
+ * TIMER1, and the statistics of every task are sent to the host periodically. */
 #define configGENERATE_RUN_TIME_STATS             ( 0 )
 
-/* Co-routine related definitions. */
+#if configGENERATE_RUN_TIME_STATS
+#include <stdint.h>
+void vConfigureRunTimeStatsTimer( void );
+uint32_t ulGetRunTimeCounterValue( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()  vConfigureRunTimeStatsTimer()
+#define portGET_RUN_TIME_COUNTER_VALUE()          ulGetRunTimeCounterValue()
+#endif
+
+/* Event trace related definitions. Set configUSE_EVENT_TRACE to 1 to record
+ * task switches, queue operations and interrupts into a RAM ring, which the
+ * host can dump over the UART. The hooks are defined in src/event_trace.h. */
+#define configUSE_EVENT_TRACE                     ( 0 )
+
+/* Co-routine related definitions. Set configUSE_CO_ROUTINES to 1 for the
+ * co-routine build: the display refresh, the telemetry transmit and the
+ * history writes run as co-routines on the stack of the idle task instead
+ * of in their own tasks, and the timer task is only created for the
+ * runtime-stats build: four stacks and TCBs less, for three co-routine
+ * control blocks and a larger idle stack. The runtime-stats build reports
+ * the stack high-water mark of the idle task with the other tasks. The
+ * co-routine control blocks come from the heap, so the zero-heap build
+ * cannot be combined with it. */
 #define configUSE_CO_ROUTINES                     ( 0 )
 #define configMAX_CO_ROUTINE_PRIORITIES           ( 1 )
 
+#if configUSE_CO_ROUTINES && configSUPPORT_STATIC_ALLOCATION
+#error "The co-routine build needs configSUPPORT_DYNAMIC_ALLOCATION"
+#endif
+
 /* Software timer related definitions. */
-#define configUSE_TIMERS                          ( 1 )
+#define configUSE_TIMERS                          ( configGENERATE_RUN_TIME_STATS || !configUSE_CO_ROUTINES )
 #define configTIMER_TASK_PRIORITY                 ( configMAX_PRIORITIES - 1 ) /* Highest priority */
 #define configTIMER_QUEUE_LENGTH                  ( 10 )
 #define configTIMER_TASK_STACK_DEPTH              ( configMINIMAL_STACK_SIZE )
@@ -163,6 +206,9 @@ extern "C" {
 #define xPortPendSVHandler     PendSV_Handler
 #define xPortSysTickHandler    SysTick_Handler
 
+/* Trace hook definitions. */
+#include "src/event_trace.h"
+
 
 #ifdef __cplusplus
 }
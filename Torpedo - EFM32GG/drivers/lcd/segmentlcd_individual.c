@@ -186,7 +186,8 @@ void SegmentLCD_UpperSegments(SegmentLCD_UpperCharSegments_TypeDef upperCharSegm
 
     for (c = 0; c < SEGMENT_LCD_NUM_OF_UPPER_CHARS; c++)
     {
-       for (s = 0; s < 14; s++)
+       /* The upper characters have seven segments */
+       for (s = 0; s < 7; s++)
           {
             bit = Number[c].bit[s];
             com = Number[c].com[s];
@@ -236,3 +237,122 @@ void SegmentLCD_LowerSegments(SegmentLCD_LowerCharSegments_TypeDef lowerCharSegm
     LCD_FreezeEnable(false);
 }
 
+
+void SegmentLCD_LowerSegmentLocation(int c, int s, SegmentLCD_SegmentLocation_TypeDef *location)
+{
+    uint32_t bit = Text[c].bit[s];
+
+    location->com  = Text[c].com[s];
+    location->high = bit >= 32;
+    location->mask = 1UL << (bit & 31);
+}
+
+void SegmentLCD_UpperSegmentLocation(int c, int s, SegmentLCD_SegmentLocation_TypeDef *location)
+{
+    uint32_t bit = Number[c].bit[s];
+
+    location->com  = Number[c].com[s];
+    location->high = bit >= 32;
+    location->mask = 1UL << (bit & 31);
+}
+
+void SegmentLCD_UpperFrameMask(SegmentLCD_Frame_TypeDef *mask)
+{
+    SegmentLCD_SegmentLocation_TypeDef location;
+    uint8_t s, c, com;
+
+    for (com = 0; com < SEGMENT_LCD_NUM_OF_COMS; com++)
+    {
+        mask->segd[com][0] = 0;
+        mask->segd[com][1] = 0;
+    }
+
+    for (c = 0; c < SEGMENT_LCD_NUM_OF_UPPER_CHARS; c++)
+    {
+        for (s = 0; s < 7; s++)
+        {
+            SegmentLCD_UpperSegmentLocation(c, s, &location);
+            mask->segd[location.com][location.high] |= location.mask;
+        }
+    }
+}
+
+void SegmentLCD_LowerFrameMask(SegmentLCD_Frame_TypeDef *mask)
+{
+    SegmentLCD_SegmentLocation_TypeDef location;
+    uint8_t s, c, com;
+
+    for (com = 0; com < SEGMENT_LCD_NUM_OF_COMS; com++)
+    {
+        mask->segd[com][0] = 0;
+        mask->segd[com][1] = 0;
+    }
+
+    for (c = 0; c < SEGMENT_LCD_NUM_OF_LOWER_CHARS; c++)
+    {
+        for (s = 0; s < 14; s++)
+        {
+            SegmentLCD_LowerSegmentLocation(c, s, &location);
+            mask->segd[location.com][location.high] |= location.mask;
+        }
+    }
+}
+
+bool SegmentLCD_FrameCommit(const SegmentLCD_Frame_TypeDef *frame,
+                            const SegmentLCD_Frame_TypeDef *mask,
+                            SegmentLCD_Frame_TypeDef *committed)
+{
+    uint32_t bits, changed = 0;
+    uint8_t com, high;
+
+    /* Checking for changed registers first, an unchanged frame needs no sync */
+    for (com = 0; com < SEGMENT_LCD_NUM_OF_COMS; com++)
+    {
+        for (high = 0; high < 2; high++)
+        {
+            bits = frame->segd[com][high] & mask->segd[com][high];
+            changed |= bits ^ committed->segd[com][high];
+        }
+    }
+
+    if (!changed)
+    {
+        return true;
+    }
+
+    /* If an update is in progress, defer instead of blocking to avoid tearing */
+    if (LCD_SyncBusyGet())
+    {
+        return false;
+    }
+
+    /* Freeze LCD to avoid partial updates */
+    LCD_FreezeEnable(true);
+
+    for (com = 0; com < SEGMENT_LCD_NUM_OF_COMS; com++)
+    {
+        for (high = 0; high < 2; high++)
+        {
+            bits = frame->segd[com][high] & mask->segd[com][high];
+
+            /* Skip registers that are not owned or did not change */
+            if (mask->segd[com][high] == 0 || bits == committed->segd[com][high])
+            {
+                continue;
+            }
+
+            if (high)
+            {
+                LCD_SegmentSetHigh(com, mask->segd[com][high], bits);
+            } else {
+                LCD_SegmentSetLow(com, mask->segd[com][high], bits);
+            }
+
+            committed->segd[com][high] = bits;
+        }
+    }
+
+    LCD_FreezeEnable(false);
+
+    return true;
+}
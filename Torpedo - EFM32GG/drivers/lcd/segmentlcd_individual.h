@@ -17,6 +17,7 @@
  *  INCLUDES
  * ------------------------------------------------------------------------- */
 #include <stdint.h>
+#include <stdbool.h>
 
 /* ----------------------------------------------------------------------------
  *  DEFINES
@@ -36,6 +37,12 @@
  ******************************************************************************/
 #define SEGMENT_LCD_NUM_OF_LOWER_CHARS 7
 
+/**************************************************************************//**
+ * @brief
+ *   Defines the number of COM lines driven by the LCD controller.
+ ******************************************************************************/
+#define SEGMENT_LCD_NUM_OF_COMS 8
+
 /* ----------------------------------------------------------------------------
  *  TYPEDEFS
  * ------------------------------------------------------------------------- */
@@ -130,6 +137,37 @@ typedef union
    };
 } SegmentLCD_LowerCharSegments_TypeDef;
 
+/**************************************************************************//**
+ * @brief
+ *   Typedef to store the register location of a single LCD segment.
+ *
+ * @details
+ *   A segment is driven by one bit of the SEGDxL (segments 0-31) or the
+ *   SEGDxH (segments 32-39) register of its COM line. The location stores
+ *   the COM line, the register half and the bitmask inside that register,
+ *   so the segment can be applied to a frame with a single OR operation.
+ *
+ ******************************************************************************/
+typedef struct {
+   uint8_t  com;  /**< LCD COM line (for multiplexing)             */
+   uint8_t  high; /**< 0: SEGDxL register, 1: SEGDxH register      */
+   uint32_t mask; /**< Bitmask of the segment inside the register */
+} SegmentLCD_SegmentLocation_TypeDef;
+
+/**************************************************************************//**
+ * @brief
+ *   Typedef to store the content of the segment data registers.
+ *
+ * @details
+ *   segd[com][0] mirrors the SEGDxL register, segd[com][1] mirrors the
+ *   SEGDxH register of the given COM line. A frame is assembled in RAM
+ *   and written to the LCD controller with SegmentLCD_FrameCommit().
+ *
+ ******************************************************************************/
+typedef struct {
+   uint32_t segd[SEGMENT_LCD_NUM_OF_COMS][2];
+} SegmentLCD_Frame_TypeDef;
+
 /* ----------------------------------------------------------------------------
  *  FUNCTION PROTOTYPES
  * ------------------------------------------------------------------------- */
@@ -173,4 +211,106 @@ void SegmentLCD_LowerSegments(
       SegmentLCD_LowerCharSegments_TypeDef lowerCharSegments[SEGMENT_LCD_NUM_OF_LOWER_CHARS]
 );
 
+/**************************************************************************//**
+ * @brief
+ *   Look up the register location of a segment on the lower part of the LCD.
+ *
+ * @param[in] c
+ *   The index of the alphanumeric character (0..SEGMENT_LCD_NUM_OF_LOWER_CHARS-1).
+ *
+ * @param[in] s
+ *   The index of the segment inside the character (0..13), using the bit
+ *   numbering of SegmentLCD_LowerCharSegments_TypeDef.
+ *
+ * @param[out] location
+ *   The register location of the segment.
+ *
+ * @return
+ *   None.
+ *
+ *****************************************************************************/
+void SegmentLCD_LowerSegmentLocation(int c, int s, SegmentLCD_SegmentLocation_TypeDef *location);
+
+/**************************************************************************//**
+ * @brief
+ *   Look up the register location of a segment on the upper part of the LCD.
+ *
+ * @param[in] c
+ *   The index of the digit (0..SEGMENT_LCD_NUM_OF_UPPER_CHARS-1).
+ *
+ * @param[in] s
+ *   The index of the segment inside the digit (0..6), using the bit
+ *   numbering of SegmentLCD_UpperCharSegments_TypeDef.
+ *
+ * @param[out] location
+ *   The register location of the segment.
+ *
+ * @return
+ *   None.
+ *
+ *****************************************************************************/
+void SegmentLCD_UpperSegmentLocation(int c, int s, SegmentLCD_SegmentLocation_TypeDef *location);
+
+/**************************************************************************//**
+ * @brief
+ *   Assemble the register mask of every segment on the upper part of the LCD.
+ *
+ * @param[out] mask
+ *   The frame receiving the mask. Bits belonging to the upper part of the LCD
+ *   are set, all other bits are cleared.
+ *
+ * @return
+ *   None.
+ *
+ *****************************************************************************/
+void SegmentLCD_UpperFrameMask(SegmentLCD_Frame_TypeDef *mask);
+
+/**************************************************************************//**
+ * @brief
+ *   Assemble the register mask of every segment on the lower part of the LCD.
+ *
+ * @param[out] mask
+ *   The frame receiving the mask. Bits belonging to the lower part of the LCD
+ *   are set, all other bits are cleared.
+ *
+ * @return
+ *   None.
+ *
+ *****************************************************************************/
+void SegmentLCD_LowerFrameMask(SegmentLCD_Frame_TypeDef *mask);
+
+/**************************************************************************//**
+ * @brief
+ *   Write a frame to the segment data registers using masked register writes.
+ *
+ * @details
+ *   Only the bits selected by the mask are modified. Registers whose masked
+ *   content equals the last committed content are skipped, so COM lines that
+ *   did not change are not written at all.
+ *
+ *   The function never waits for the LCD controller. If a previous update is
+ *   still being synchronized to the low energy domain, nothing is written
+ *   and the commit has to be retried later. The function is safe to call
+ *   from an interrupt handler.
+ *
+ * @param[in] frame
+ *   The frame to display.
+ *
+ * @param[in] mask
+ *   The bits of the frame owned by the caller.
+ *
+ * @param[in,out] committed
+ *   The masked content last written to the registers. Updated on return.
+ *
+ * @return
+ *   False if the commit was deferred because of a pending synchronization,
+ *   true if the registers hold the frame on return.
+ *
+ *****************************************************************************/
+bool SegmentLCD_FrameCommit(
+      const SegmentLCD_Frame_TypeDef *frame,
+      const SegmentLCD_Frame_TypeDef *mask,
+      SegmentLCD_Frame_TypeDef *committed
+);
+
 #endif /* SRC_SEGMENTLCD_INDIVIDUAL_H_ */
@@ -0,0 +1,160 @@
+#include "animation.h"
+
+/**
+ * The number of frame counter events left until the current
+ * animation finishes. Zero when no animation is in progress.
+ */
+static volatile uint8_t remainingSteps;
+
+/**
+ * Indicating whether the current animation blinks the whole ring.
+ */
+static volatile bool ringBlinking;
+
+/**
+ * Indicating whether the frame counter interrupt is enabled. It is
+ * disabled while nothing is animated, so the CPU sleeps through the
+ * frames of a still display.
+ */
+static volatile bool stepEventsEnabled;
+
+/**
+ * @brief Enables the frame counter interrupt if it is disabled.
+ */
+static void enableStepEvents(void) {
+
+	taskENTER_CRITICAL();
+	if(!stepEventsEnabled) {
+
+		// Dropping the event counted while the interrupt was disabled
+		LCD_IntClear(LCD_IF_FC);
+		LCD_IntEnable(LCD_IEN_FC);
+		stepEventsEnabled = true;
+	}
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Programs the animation controller and starts the animation.
+ * @param [in] The animation register configuration.
+ * @param [in] The number of steps the animation lasts.
+ */
+static void startAnimation(const LCD_AnimInit_TypeDef *animInit, uint8_t steps, bool blinking) {
+
+	// Setting the length before enabling, the interrupt may fire any time
+	taskENTER_CRITICAL();
+	remainingSteps = steps;
+	ringBlinking = blinking;
+	taskEXIT_CRITICAL();
+
+	// Programming and enabling the animation controller
+	LCD_AnimInit(animInit);
+
+	// Counting the steps
+	enableStepEvents();
+}
+
+void initAnimation(void) {
+
+	// Initializing frame counter configuration
+	LCD_FrameCountInit_TypeDef fcInit = {
+		.enable   = true,
+		.top      = ANIMATION_STEP_FRAMES - 1,
+		.prescale = lcdFCPrescDiv1
+	};
+
+	// No animation in progress
+	remainingSteps = 0;
+	ringBlinking = false;
+	LCD_AnimEnable(false);
+
+	LCD_FrameCountInit(&fcInit);
+
+	// The handler shares data with critical sections, so it must
+	// not be above the FreeRTOS syscall interrupt priority
+	NVIC_SetPriority(LCD_IRQn, configMAX_SYSCALL_INTERRUPT_PRIORITY >> (8 - __NVIC_PRIO_BITS));
+
+	// Enabling the interrupt, the frame counter events only once animated
+	LCD_IntDisable(LCD_IEN_FC);
+	stepEventsEnabled = false;
+	LCD_IntClear(LCD_IF_FC);
+	NVIC_ClearPendingIRQ(LCD_IRQn);
+	NVIC_EnableIRQ(LCD_IRQn);
+}
+
+void startCursorBlink(void) {
+	enableStepEvents();
+}
+
+void startSpinnerAnimation(void) {
+
+	// One lit segment rotating left: AREGA rotates, AREGB passes it through
+	LCD_AnimInit_TypeDef animInit = {
+		.enable    = true,
+		.AReg      = 0x01,
+		.AShift    = lcdAnimShiftLeft,
+		.BReg      = 0xFF,
+		.BShift    = lcdAnimShiftNone,
+		.animLogic = lcdAnimLogicAnd,
+		.startSeg  = ANIMATION_START_SEGMENT
+	};
+
+	startAnimation(&animInit, SPINNER_ANIMATION_STEPS, false);
+}
+
+void startHitAnimation(void) {
+
+	// Every segment lit, the interrupt turns the controller off on every other step
+	LCD_AnimInit_TypeDef animInit = {
+		.enable    = true,
+		.AReg      = 0xFF,
+		.AShift    = lcdAnimShiftNone,
+		.BReg      = 0xFF,
+		.BShift    = lcdAnimShiftNone,
+		.animLogic = lcdAnimLogicAnd,
+		.startSeg  = ANIMATION_START_SEGMENT
+	};
+
+	startAnimation(&animInit, HIT_ANIMATION_STEPS, true);
+}
+
+bool isAnimationRunning(void) {
+	return remainingSteps != 0;
+}
+
+void LCD_IRQHandler(void) {
+
+	traceISR_ENTER(LCD_IRQn);
+
+	// The handler is also pended by software to commit a new frame
+	if(LCD_IntGet() & LCD_IF_FC) {
+
+		// Clearing interrupt flags
+		LCD_IntClear(LCD_IF_FC);
+
+		if(remainingSteps != 0) {
+			remainingSteps--;
+
+			// Stopping the animation after its last step, the ring
+			// segments fall back to the (cleared) segment registers
+			if(remainingSteps == 0) {
+				LCD_AnimEnable(false);
+			}
+			// Blinking the ring, lit by the controller on every other step
+			else if(ringBlinking) {
+				LCD_AnimEnable(remainingSteps % 2 == 0);
+			}
+		}
+
+		// Blinking the cursor, stopping the events once nothing is animated
+		if(!blinkCursorFromISR() && remainingSteps == 0) {
+			LCD_IntDisable(LCD_IEN_FC);
+			stepEventsEnabled = false;
+		}
+	}
+
+	// Writing the display changes to the registers
+	commitDisplayFromISR();
+
+	traceISR_EXIT(LCD_IRQn);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Board includes
+#include <em_lcd.h>
+
+// Project includes
+#include "graphics.h"
+
+// Project defines
+
+/**
+ * The LCD frame rate set up by SegmentLCD_Init() for the STK3700
+ * display. The animation step length is derived from this value.
+ */
+#define LCD_FRAME_RATE_HZ          (64)
+
+/**
+ * The time between animation steps in milliseconds. Every step shifts
+ * the spinner by one position and toggles the blinking cursor.
+ */
+#define ANIMATION_STEP_MS          (160)
+
+/**
+ * The number of LCD frames per animation step. The frame counter
+ * generates one event per step, so this must not exceed 64.
+ */
+#define ANIMATION_STEP_FRAMES      ((LCD_FRAME_RATE_HZ * ANIMATION_STEP_MS) / 1000)
+
+/**
+ * The number of steps the spinner animation lasts. The spinner visits
+ * every segment of the ring once.
+ */
+#define SPINNER_ANIMATION_STEPS    (8)
+
+/**
+ * The number of steps the hit animation lasts. The whole ring is
+ * lit on the even steps and dark on the odd ones, blinking three times.
+ */
+#define HIT_ANIMATION_STEPS        (6)
+
+/**
+ * The first segment line driven by the animation controller. The ring
+ * of the STK3700 display is wired to COM0, segment lines 0-7.
+ */
+#define ANIMATION_START_SEGMENT    (0)
+
+#if ANIMATION_STEP_FRAMES < 1 || ANIMATION_STEP_FRAMES > 64
+#error "ANIMATION_STEP_MS can not be generated by the LCD frame counter"
+#endif
+
+/**
+ * @brief  Initializes the LCD frame counter and its interrupt.
+ * @detail The frame counter generates one event per animation step.
+ *         The events shift the animation registers in hardware and
+ *         drive the blinking cursor, the CPU only counts them. Its
+ *         interrupt is enabled only while an animation runs or the
+ *         cursor is shown.
+ */
+void initAnimation(void);
+
+/**
+ * @brief  Enables the frame counter interrupt for the blinking cursor.
+ * @detail The interrupt is disabled again on the first step the cursor
+ *         is hidden and no animation runs, as blinkCursorFromISR() reports.
+ */
+void startCursorBlink(void);
+
+/**
+ * @brief  Starts the spinner animation on the ring segments.
+ * @detail A single lit segment is rotated around the ring by the
+ *         animation controller for SPINNER_ANIMATION_STEPS steps.
+ */
+void startSpinnerAnimation(void);
+
+/**
+ * @brief  Starts the hit animation on the ring segments.
+ * @detail The whole ring blinks for HIT_ANIMATION_STEPS steps. The
+ *         animation controller cannot turn every segment on and off
+ *         by itself, so the interrupt switches it on every other step.
+ */
+void startHitAnimation(void);
+
+/**
+ * @brief  Returns whether an animation is in progress.
+ * @return False once the frame counter reached the last step of the
+ *         current animation, true otherwise.
+ */
+bool isAnimationRunning(void);
+
+/**
+ * @brief  The interrupt request handler of the LCD controller.
+ * @detail Called on every frame counter event, and pended by software
+ *         when a new frame is published. Counts the remaining animation
+ *         steps, stops the animation after the last one, toggles the
+ *         blinking cursor and commits the display changes. Disables the
+ *         frame counter interrupt once nothing is animated.
+ */
+void LCD_IRQHandler(void);
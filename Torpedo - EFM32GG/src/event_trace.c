@@ -0,0 +1,102 @@
+// Standard includes
+#include <string.h>
+
+// Board includes
+#include <em_usart.h>
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Project includes
+#include "event_trace.h"
+#include "statistics.h"
+
+#if configUSE_EVENT_TRACE
+
+TraceEvent traceRing[TRACE_RING_LENGTH];
+uint32_t traceHead;
+volatile bool traceDumpRequested;
+
+void initEventTrace(void) {
+
+	// Enabling the cycle counter of the DWT unit
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+bool requestTraceDumpFromISR(void) {
+
+	BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+	traceDumpRequested = true;
+
+	// Waking up the statistics task
+	wakeStatisticsFromISR(&higherPriorityTaskWoken);
+
+	return higherPriorityTaskWoken == pdTRUE;
+}
+
+void dumpEventTrace(void) {
+
+	static TraceEvent snapshot[TRACE_RING_LENGTH];
+	static TaskStatus_t taskStatus[TRACE_MAX_TASKS];
+
+	traceDumpRequested = false;
+
+	// Taking a consistent snapshot of the ring
+	taskENTER_CRITICAL();
+	uint32_t head = traceHead;
+	memcpy(snapshot, traceRing, sizeof(snapshot));
+	taskEXIT_CRITICAL();
+
+	// Calculating the range of valid events
+	uint16_t eventCount = head < TRACE_RING_LENGTH ? head : TRACE_RING_LENGTH;
+	uint32_t first = head - eventCount;
+
+	// Listing the tasks
+	UBaseType_t taskCount = uxTaskGetSystemState(taskStatus, TRACE_MAX_TASKS, NULL);
+
+	// Sending message type identifier
+	USART_Tx(UART0, TraceDumpMsg);
+
+	// Sending the frequency of the cycle counter
+	USART_Tx(UART0, SystemCoreClock);
+	USART_Tx(UART0, SystemCoreClock >> 8);
+	USART_Tx(UART0, SystemCoreClock >> 16);
+	USART_Tx(UART0, SystemCoreClock >> 24);
+
+	// Sending the task list
+	USART_Tx(UART0, taskCount);
+	for(UBaseType_t i = 0; i < taskCount; i++) {
+
+		// Sending the task number
+		USART_Tx(UART0, taskStatus[i].xTaskNumber);
+
+		// Sending the task name zero padded
+		bool nameEnded = false;
+		for(uint8_t c = 0; c < TASK_STATS_NAME_LENGTH; c++) {
+			nameEnded = nameEnded || taskStatus[i].pcTaskName[c] == '\0';
+			USART_Tx(UART0, nameEnded ? '\0' : taskStatus[i].pcTaskName[c]);
+		}
+	}
+
+	// Sending the events from the oldest
+	USART_Tx(UART0, eventCount);
+	USART_Tx(UART0, eventCount >> 8);
+
+	for(uint32_t i = first; i != head; i++) {
+		TraceEvent *event = &snapshot[i & (TRACE_RING_LENGTH - 1)];
+
+		USART_Tx(UART0, event->timestamp);
+		USART_Tx(UART0, event->timestamp >> 8);
+		USART_Tx(UART0, event->timestamp >> 16);
+		USART_Tx(UART0, event->timestamp >> 24);
+		USART_Tx(UART0, event->event);
+		USART_Tx(UART0, event->argument);
+		USART_Tx(UART0, event->argument >> 8);
+	}
+}
+
+#endif
@@ -0,0 +1,130 @@
+#pragma once
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * This header is included at the end of FreeRTOSConfig.h, so the kernel
+ * trace hooks below replace the empty defaults of FreeRTOS.h. When
+ * configUSE_EVENT_TRACE is 0 every hook expands to nothing.
+ */
+#if configUSE_EVENT_TRACE
+
+// Board includes
+#include <em_device.h>
+
+// Project defines
+
+/**
+ * The number of events the trace ring can hold. Must be a power of two,
+ * the oldest events are overwritten when the ring is full.
+ */
+#define TRACE_RING_LENGTH 	(128)
+
+#if (TRACE_RING_LENGTH & (TRACE_RING_LENGTH - 1)) != 0
+#error "TRACE_RING_LENGTH must be a power of two"
+#endif
+
+/**
+ * The maximum number of tasks listed in a trace dump.
+ */
+#define TRACE_MAX_TASKS 	(8)
+
+/**
+ * @brief Describes the possible trace event types.
+ */
+typedef enum TraceEventType {
+	TraceTaskSwitchedIn,		/**< Argument: the number of the task switched in.	*/
+	TraceTaskDelay,				/**< Argument: unused.								*/
+	TraceQueueSend,				/**< Argument: the low half of the queue address.	*/
+	TraceQueueSendFailed,		/**< Argument: the low half of the queue address.	*/
+	TraceQueueSendFromISR,		/**< Argument: the low half of the queue address.	*/
+	TraceQueueReceive,			/**< Argument: the low half of the queue address.	*/
+	TraceQueueBlockingOnSend,	/**< Argument: the low half of the queue address.	*/
+	TraceQueueBlockingOnReceive,/**< Argument: the low half of the queue address.	*/
+	TraceTaskNotify,			/**< Argument: the number of the task notified.		*/
+	TraceTaskNotifyFromISR,		/**< Argument: the number of the task notified.		*/
+	TraceTaskNotifyWait,		/**< Argument: unused.								*/
+	TraceISREnter,				/**< Argument: the IRQ number.						*/
+	TraceISRExit				/**< Argument: the IRQ number.						*/
+} TraceEventType;
+
+/**
+ * @brief Describes one recorded trace event.
+ */
+typedef struct TraceEvent {
+	uint32_t timestamp;			/**< The value of the cycle counter when the event was recorded.	*/
+	uint16_t argument;			/**< The argument of the event, see TraceEventType.				*/
+	uint8_t  event;				/**< The type of the event.										*/
+} TraceEvent;
+
+/**
+ * The trace ring and the free running index of its next slot. These are
+ * declared extern, since every kernel source includes this header.
+ */
+extern TraceEvent traceRing[TRACE_RING_LENGTH];
+extern uint32_t traceHead;
+
+/**
+ * Set by the UART interrupt when the host requests a trace dump.
+ */
+extern volatile bool traceDumpRequested;
+
+/**
+ * Records one event into the trace ring. Masking the interrupts that may
+ * record events takes a few cycles, the kernel hooks mostly run masked.
+ */
+#define traceRECORD(type, arg) do {												\
+	UBaseType_t traceMask = portSET_INTERRUPT_MASK_FROM_ISR();					\
+	TraceEvent *traceSlot = &traceRing[traceHead++ & (TRACE_RING_LENGTH - 1)];	\
+	traceSlot->timestamp = DWT->CYCCNT;											\
+	traceSlot->argument  = (uint16_t)(arg);										\
+	traceSlot->event     = (type);												\
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(traceMask);								\
+} while(0)
+
+// Kernel trace hooks
+#define traceTASK_SWITCHED_IN()						traceRECORD(TraceTaskSwitchedIn, pxCurrentTCB->uxTCBNumber)
+#define traceTASK_DELAY()							traceRECORD(TraceTaskDelay, 0)
+#define traceTASK_DELAY_UNTIL(xTimeToWake)			traceRECORD(TraceTaskDelay, 0)
+#define traceQUEUE_SEND(pxQueue)					traceRECORD(TraceQueueSend, (uintptr_t)(pxQueue))
+#define traceQUEUE_SEND_FAILED(pxQueue)				traceRECORD(TraceQueueSendFailed, (uintptr_t)(pxQueue))
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)			traceRECORD(TraceQueueSendFromISR, (uintptr_t)(pxQueue))
+#define traceQUEUE_RECEIVE(pxQueue)					traceRECORD(TraceQueueReceive, (uintptr_t)(pxQueue))
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)		traceRECORD(TraceQueueBlockingOnSend, (uintptr_t)(pxQueue))
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)		traceRECORD(TraceQueueBlockingOnReceive, (uintptr_t)(pxQueue))
+#define traceTASK_NOTIFY()							traceRECORD(TraceTaskNotify, pxTCB->uxTCBNumber)
+#define traceTASK_NOTIFY_FROM_ISR()					traceRECORD(TraceTaskNotifyFromISR, pxTCB->uxTCBNumber)
+#define traceTASK_NOTIFY_WAIT_BLOCK()				traceRECORD(TraceTaskNotifyWait, 0)
+
+// Application interrupt hooks
+#define traceISR_ENTER(irq)							traceRECORD(TraceISREnter, (irq))
+#define traceISR_EXIT(irq)							traceRECORD(TraceISRExit, (irq))
+
+/**
+ * @brief Starts the cycle counter used to timestamp the events.
+ */
+void initEventTrace(void);
+
+/**
+ * @brief  Requests a trace dump from the statistics task.
+ * @return True if the statistics task should run when the interrupt returns.
+ */
+bool requestTraceDumpFromISR(void);
+
+/**
+ * @brief  Sends a snapshot of the trace ring over the UART.
+ * @detail Called by the statistics task, which owns the UART transmitter.
+ *         The dump lists the number and name of every task, then the
+ *         recorded events from the oldest to the newest.
+ */
+void dumpEventTrace(void);
+
+#else
+
+// Application interrupt hooks
+#define traceISR_ENTER(irq)
+#define traceISR_EXIT(irq)
+
+#endif
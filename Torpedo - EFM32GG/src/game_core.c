@@ -0,0 +1,277 @@
+#include "game_core.h"
+
+// The predefined maps place their ships on the segments of the board,
+// larger virtual boards keep the segment IDs of the maps
+#if LCD_SEGMENTS_COUNT < 13*7
+#error "The predefined maps need at least 91 segments"
+#endif
+
+// List of predefined maps, the segments holding a ship part
+const uint8_t predefinedMaps[PREDEFINED_MAP_COUNT][SHIP_SEGMENTS_COUNT] = {
+	{ 9, 12, 48, 51, 53, 54, 78, 65},	// MAP1
+	{ 0, 13, 52, 65, 79, 80, 35, 38},	// MAP2
+	{ 7, 10, 30, 31, 87, 90, 47, 50},	// MAP3
+	{ 4,  5, 14, 15, 30, 31, 79, 80},	// MAP4
+	{ 6, 19, 26, 39, 29, 42, 74, 77},	// MAP5
+	{ 0,  3, 13, 16, 32, 45, 71, 84},	// MAP6
+	{ 9, 12, 22, 25, 35, 38, 59, 62},	// MAP7
+	{ 6, 19, 34, 37, 73, 76, 85, 88},	// MAP8
+	{21, 24, 34, 37, 45, 58, 68, 81},	// MAP9
+	{ 0,  3,  6, 13, 19, 16, 45, 58},	// MAP10
+	{65, 78, 68, 81, 71, 84, 32, 45},	// MAP11
+	{ 9, 12, 20, 23, 32, 45, 73, 76},	// MAP12
+	{34, 37, 21, 24, 60, 63, 71, 84},	// MAP13
+	{ 3, 16, 27, 28, 30, 31, 53, 54},	// MAP14
+	{ 4,  5, 16, 29, 43, 44, 71, 84},	// MAP15
+	{ 6, 19, 34, 37, 59, 62, 87, 90},	// MAP16
+};
+
+void initGame(GameContext *game, const GameDrivers *drivers, void *driverData, uint32_t seed) {
+
+	// Attaching the drivers
+	game->drivers = drivers;
+	game->driverData = driverData;
+
+	// Seeding the random generator, the generator never leaves the zero state
+	game->randomState = seed != 0 ? seed : 1;
+
+	// Starting the first game on the next tick
+	game->state = GameStart;
+	game->gameTick = 0;
+}
+
+void updateGame(GameContext *game) {
+
+	// Increasing gameTick counter
+	game->gameTick++;
+
+	// Action based on current gamestate
+	switch(game->state) {
+	case GameStart: 	gameStart(game); 		break;
+	case SegmentSelect:	segmentSelect(game); 	break;
+	case SegmentFire:	segmentFire(game); 		break;
+	case SegmentHit:	segmentHit(game); 		break;
+	case GameOver:		gameOver(game); 		break;
+	}
+}
+
+void gameStart(GameContext *game) {
+
+	// Initializing single value members
+	game->selectedSegment = 0;
+	game->remainingShips = SHIP_SEGMENTS_COUNT;
+	game->mapIndex = 0;
+	game->shotsTotal = 0;
+	game->gameTick = 0;
+
+	// Initializing display & uncovered maps
+	for(int i = 0; i < LCD_MAP_WORDS; i++) {
+		game->displayMap[i] = 0;
+		game->uncoveredMap[i] = 0;
+	}
+
+	// Initializing dependencies
+	game->drivers->prepareGame(game);
+
+	// Generating map
+	generateMap(game);
+
+	// Displaying the cursor on the selected segment
+	game->drivers->setCursor(game, game->selectedSegment);
+	game->drivers->invalidateDisplay(game, DISPLAY_REGION_ALL);
+
+	// Sending statistics message
+	game->drivers->reportEvent(game, GameStartedEvent);
+
+	// Updating gamestate
+	game->state = SegmentSelect;
+}
+
+void generateMap(GameContext *game) {
+
+	// Advancing the xorshift generator of the game
+	uint32_t x = game->randomState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	game->randomState = x;
+
+	// Picking map at random
+	game->mapIndex = (x >> 16) % PREDEFINED_MAP_COUNT;
+
+	// Activating selected map
+	for(int i = 0; i < LCD_MAP_WORDS; i++) {
+		game->shipMap[i] = 0;
+	}
+	for(int i = 0; i < SHIP_SEGMENTS_COUNT; i++) {
+		segmentMapSet(game->shipMap, predefinedMaps[game->mapIndex][i]);
+	}
+}
+
+void segmentSelect(GameContext *game) {
+
+	// Processing the queued inputs until the segment is fired
+	uint8_t action;
+	for(uint8_t i = 0; i < INPUT_EVENTS_PER_TICK && game->state == SegmentSelect && game->drivers->readAction(game, &action); i++) {
+
+		// Action based on input state
+		switch(action) {
+		case MoveLeft: 	moveLeft(game); 	break;
+		case MoveRight: moveRight(game); 	break;
+		case MoveUp: 	moveUp(game);		break;
+		case MoveDown: 	moveDown(game);		break;
+		case Fire: 		game->drivers->setCursor(game, CURSOR_HIDDEN); 	fire(game); 	break;
+		default: 																	break;
+		}
+
+		if(action == MoveLeft || action == MoveRight || action == MoveUp || action == MoveDown) {
+
+			// Displaying the cursor on the selected segment
+			game->drivers->setCursor(game, game->selectedSegment);
+
+			// Sending statistics message
+			game->drivers->reportEvent(game, SegmentSelectedEvent);
+		}
+
+		if(action == Fire) {
+
+			// Sending statistics message
+			game->drivers->reportEvent(game, SegmentFiredEvent);
+		}
+	}
+}
+
+void moveLeft(GameContext *game) {
+
+	// Updating selected segment
+	int32_t segment = game->selectedSegment - LCD_LOWER_SEGMENTS_COUNT;
+	game->selectedSegment = segment < 0 ? LCD_SEGMENTS_COUNT + segment : segment;
+}
+
+void moveRight(GameContext *game) {
+
+	// Updating selected segment
+	game->selectedSegment = (game->selectedSegment + LCD_LOWER_SEGMENTS_COUNT) % (LCD_SEGMENTS_COUNT);
+}
+
+void moveUp(GameContext *game) {
+
+	// Updating selected segment
+	SegmentId segment = game->selectedSegment;
+	SegmentId base = (segment / LCD_LOWER_SEGMENTS_COUNT) * LCD_LOWER_SEGMENTS_COUNT;
+	game->selectedSegment = base + (segment - base + 1) % LCD_LOWER_SEGMENTS_COUNT;
+}
+
+void moveDown(GameContext *game) {
+
+	// Updating selected segment
+	SegmentId segment = game->selectedSegment;
+	SegmentId base = (segment / LCD_LOWER_SEGMENTS_COUNT) * LCD_LOWER_SEGMENTS_COUNT;
+	game->selectedSegment = base + (segment - base + LCD_LOWER_SEGMENTS_COUNT - 1) % LCD_LOWER_SEGMENTS_COUNT;
+}
+
+void fire(GameContext *game) {
+
+	// Updating gamestate
+	game->state = SegmentFire;
+
+	// Spinning the ring
+	game->drivers->startAnimation(game, SpinnerAnimation);
+
+	// Increasing number of total shots
+	if(!segmentMapTest(game->uncoveredMap, game->selectedSegment)) {
+		game->shotsTotal++;
+		game->drivers->invalidateDisplay(game, DISPLAY_REGION_UPPER);
+	}
+}
+
+void segmentFire(GameContext *game) {
+
+	// Waiting for the spinner to finish
+	if(game->drivers->isAnimationRunning(game)) return;
+
+	// Updating gamestate
+	if(segmentMapTest(game->shipMap, game->selectedSegment)) {
+		game->state = SegmentHit;
+
+		// Blinking the ring
+		game->drivers->startAnimation(game, HitAnimation);
+
+		// Sending statistics message
+		game->drivers->reportEvent(game, SegmentHitEvent);
+
+	} else {
+		game->state = SegmentSelect;
+		game->drivers->setCursor(game, game->selectedSegment);
+
+		// Sending statistics message
+		game->drivers->reportEvent(game, SegmentMissedEvent);
+	}
+}
+
+void segmentHit(GameContext *game) {
+
+	// Waiting for the blinking to finish
+	if(game->drivers->isAnimationRunning(game)) return;
+
+	// Decreasing the number of remaining ships
+	if(!segmentMapTest(game->uncoveredMap, game->selectedSegment)) game->remainingShips--;
+
+	// Indicating the hit on the uncovered and display maps
+	segmentMapSet(game->uncoveredMap, game->selectedSegment);
+	segmentMapSet(game->displayMap, game->selectedSegment);
+	game->drivers->invalidateDisplay(game, DISPLAY_REGION_LOWER);
+
+	// Moving to the next game state
+	if(game->remainingShips != 0) {
+		game->state = SegmentSelect;
+		game->drivers->setCursor(game, game->selectedSegment);
+	} else {
+		game->state = GameOver;
+	}
+}
+
+void gameOver(GameContext *game) {
+
+	// Sending statistics message
+	game->drivers->reportEvent(game, GameFinishedEvent);
+
+	// Resetting game state
+	game->state = GameStart;
+}
+
+uint16_t segmentDistance(SegmentId from, SegmentId to) {
+
+	// Digit and in-digit steps the shorter way around
+	uint16_t digits = (to / LCD_LOWER_SEGMENTS_COUNT + LCD_DIGITS_COUNT - from / LCD_LOWER_SEGMENTS_COUNT) % LCD_DIGITS_COUNT;
+	uint16_t steps = (to % LCD_LOWER_SEGMENTS_COUNT + LCD_LOWER_SEGMENTS_COUNT - from % LCD_LOWER_SEGMENTS_COUNT) % LCD_LOWER_SEGMENTS_COUNT;
+
+	if(digits > LCD_DIGITS_COUNT - digits) digits = LCD_DIGITS_COUNT - digits;
+	if(steps > LCD_LOWER_SEGMENTS_COUNT - steps) steps = LCD_LOWER_SEGMENTS_COUNT - steps;
+
+	return digits + steps;
+}
+
+uint16_t planMoves(SegmentId from, SegmentId to, uint8_t *actions) {
+
+	uint16_t length = 0;
+
+	// Stepping between the digits the shorter way around
+	uint16_t digits = (to / LCD_LOWER_SEGMENTS_COUNT + LCD_DIGITS_COUNT - from / LCD_LOWER_SEGMENTS_COUNT) % LCD_DIGITS_COUNT;
+	if(digits <= LCD_DIGITS_COUNT - digits) {
+		while(digits--) actions[length++] = MoveRight;
+	} else {
+		for(digits = LCD_DIGITS_COUNT - digits; digits > 0; digits--) actions[length++] = MoveLeft;
+	}
+
+	// Stepping within the digit the shorter way around
+	uint16_t steps = (to % LCD_LOWER_SEGMENTS_COUNT + LCD_LOWER_SEGMENTS_COUNT - from % LCD_LOWER_SEGMENTS_COUNT) % LCD_LOWER_SEGMENTS_COUNT;
+	if(steps <= LCD_LOWER_SEGMENTS_COUNT - steps) {
+		while(steps--) actions[length++] = MoveUp;
+	} else {
+		for(steps = LCD_LOWER_SEGMENTS_COUNT - steps; steps > 0; steps--) actions[length++] = MoveDown;
+	}
+
+	actions[length++] = Fire;
+	return length;
+}
@@ -0,0 +1,390 @@
+#pragma once
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * The rules of the game as a state machine operating on a GameContext.
+ * The core is kept free of board and kernel dependencies: the display,
+ * the animations, the input and the statistics are reached through the
+ * GameDrivers callbacks of the context, so any number of independent
+ * games can run side by side, e.g. on the threads of a host simulator.
+ * The firmware runs a single instance (see game_logic.h).
+ */
+
+// Project defines
+
+/**
+ * The geometry of the lower LCD display: the number of digits and the
+ * number of segments in a digit. The firmware builds with the 7 digits
+ * of 13 segments of the board, host builds may override the geometry
+ * (e.g. -DLCD_DIGITS_COUNT=1000) to run the core on larger virtual boards.
+ */
+#ifndef LCD_DIGITS_COUNT
+#define LCD_DIGITS_COUNT          (7)
+#endif
+#ifndef LCD_LOWER_SEGMENTS_COUNT
+#define LCD_LOWER_SEGMENTS_COUNT  (13)
+#endif
+#define LCD_SEGMENTS_COUNT        (LCD_DIGITS_COUNT * LCD_LOWER_SEGMENTS_COUNT)
+#define LCD_MAP_WORDS             ((LCD_SEGMENTS_COUNT + 31) / 32)
+
+/**
+ * Dirty flags identifying the regions of the LCD display. The flags
+ * are passed to the graphics task as task notification bits, and
+ * only the regions flagged dirty are redrawn.
+ */
+#define DISPLAY_REGION_LOWER      (1UL << 0)
+#define DISPLAY_REGION_UPPER      (1UL << 1)
+#define DISPLAY_REGION_ALL        (DISPLAY_REGION_LOWER | DISPLAY_REGION_UPPER)
+
+/**
+ * The type holding the ID of a segment, and the cursor segment value
+ * indicating that no cursor is displayed. The board geometry fits in
+ * a single byte, larger virtual boards use two.
+ */
+#if LCD_SEGMENTS_COUNT < 0xFF
+typedef uint8_t SegmentId;
+#define CURSOR_HIDDEN             (0xFF)
+#elif LCD_SEGMENTS_COUNT < 0xFFFF
+typedef uint16_t SegmentId;
+#define CURSOR_HIDDEN             (0xFFFF)
+#else
+#error "The lower LCD display must have less than 65535 segments"
+#endif
+
+/**
+ * This macro defines the number of predefined map configurations
+ * used by the application. Modify this value accordingly, if you
+ * add or remove map configurations.
+ */
+#define PREDEFINED_MAP_COUNT 	(16)
+
+/**
+ * This macro defines the number of ship parts on every map.
+ */
+#define SHIP_SEGMENTS_COUNT 	(8)
+
+/**
+ * This macro defines the maximum number of queued inputs processed
+ * in a single game tick. Inputs left over are processed in the
+ * following ticks.
+ */
+#define INPUT_EVENTS_PER_TICK 	(4)
+
+/**
+ * This macro defines the longest input sequence planned by planMoves():
+ * half way around the digits, half way around a digit and the fire input.
+ */
+#define MOVE_PLAN_MAX_LENGTH 	(LCD_DIGITS_COUNT / 2 + LCD_LOWER_SEGMENTS_COUNT / 2 + 1)
+
+/**
+ * Bitset type holding one bit for each segment of the lower LCD
+ * display. Segment i is stored in bit (i % 32) of word (i / 32),
+ * the unused bits of the last word are always zero.
+ */
+typedef uint32_t SegmentMap[LCD_MAP_WORDS];
+
+/**
+ * Enumeration for the possible input states. The application either receives
+ * no input (None), movement input (MoveX) or fire input (Fire). The input state
+ * is set asynchronously via an UART_Rx interrupt, and processed by the main loop.
+ */
+typedef enum {None, MoveLeft, MoveRight, MoveUp, MoveDown, Fire} InputStates;
+
+/**
+ * Enumeration defining the possible game states. The application operates as
+ * a state machine with these possible states. The transitions between states
+ * are controlled by the main loop based on user input and time constraints.
+ */
+typedef enum {GameStart, SegmentSelect, SegmentFire, SegmentHit, GameOver} GameStates;
+
+/**
+ * The animations played by the display driver.
+ */
+typedef enum {SpinnerAnimation, HitAnimation} GameAnimations;
+
+/**
+ * The events of a game reported to the statistics driver. The
+ * segment events refer to the selected segment of the context.
+ */
+typedef enum {
+	GameStartedEvent, SegmentSelectedEvent, SegmentFiredEvent,
+	SegmentHitEvent, SegmentMissedEvent, GameFinishedEvent
+} GameEvents;
+
+typedef struct GameContext GameContext;
+
+/**
+ * The callbacks connecting a game to its display, input and statistics.
+ * Every callback receives the context of the calling game, the driver
+ * state can be reached through its driverData member.
+ */
+typedef struct {
+
+	/**
+	 * Resets the peripherals of the game before a new game starts.
+	 */
+	void (*prepareGame)(GameContext *game);
+
+	/**
+	 * Takes the next queued input action (InputStates), returns
+	 * false if there is none.
+	 */
+	bool (*readAction)(GameContext *game, uint8_t *action);
+
+	/**
+	 * Moves the blinking cursor to the segment, or hides it with CURSOR_HIDDEN.
+	 */
+	void (*setCursor)(GameContext *game, SegmentId segment);
+
+	/**
+	 * Marks the DISPLAY_REGION_x regions changed in the display map or the shot count.
+	 */
+	void (*invalidateDisplay)(GameContext *game, uint32_t regions);
+
+	/**
+	 * Starts an animation on the selected segment.
+	 */
+	void (*startAnimation)(GameContext *game, GameAnimations animation);
+
+	/**
+	 * Returns true while the last started animation is playing.
+	 */
+	bool (*isAnimationRunning)(GameContext *game);
+
+	/**
+	 * Reports an event of the game.
+	 */
+	void (*reportEvent)(GameContext *game, GameEvents event);
+} GameDrivers;
+
+/**
+ * The complete state of a single game.
+ */
+struct GameContext {
+
+	/**
+	 * The drivers of the game and their state, owned by the caller.
+	 */
+	const GameDrivers *drivers;
+	void *driverData;
+
+	/**
+	 * The current state of the game, the index of the selected segment,
+	 * the index of the gameplay map, and the number of remaining ship
+	 * parts before the game ends.
+	 */
+	GameStates state;
+	SegmentId selectedSegment;
+	uint8_t mapIndex;
+	uint8_t remainingShips;
+
+	/**
+	 * The number of shots attempted by the user. Firing on an already
+	 * confirmed ship does not increase the counter.
+	 */
+	uint16_t shotsTotal;
+
+	/**
+	 * The number of ticks elapsed from the game start.
+	 */
+	uint32_t gameTick;
+
+	/**
+	 * The state of the random generator picking the maps.
+	 */
+	uint32_t randomState;
+
+	/**
+	 * The segments holding a ship, the segments that should be active
+	 * on the lower LCD display, and the segments with a confirmed ship.
+	 */
+	SegmentMap shipMap;
+	SegmentMap displayMap;
+	SegmentMap uncoveredMap;
+};
+
+/**
+ * The predefined maps of the game, listing the segments
+ * holding a ship part on each map.
+ */
+extern const uint8_t predefinedMaps[PREDEFINED_MAP_COUNT][SHIP_SEGMENTS_COUNT];
+
+/**
+ * @brief  Returns the state of a segment in the specified map.
+ * @param  [in] The segment map to read.
+ * @param  [in] The ID of the segment.
+ * @return True if the segment is set, false otherwise.
+ */
+static inline bool segmentMapTest(const SegmentMap map, SegmentId segment) {
+	return (map[segment >> 5] >> (segment & 31)) & 1;
+}
+
+/**
+ * @brief Sets a segment in the specified map.
+ * @param [in] The segment map to modify.
+ * @param [in] The ID of the segment.
+ */
+static inline void segmentMapSet(SegmentMap map, SegmentId segment) {
+	map[segment >> 5] |= (1UL << (segment & 31));
+}
+
+/**
+ * @brief Clears a segment in the specified map.
+ * @param [in] The segment map to modify.
+ * @param [in] The ID of the segment.
+ */
+static inline void segmentMapClear(SegmentMap map, SegmentId segment) {
+	map[segment >> 5] &= ~(1UL << (segment & 31));
+}
+
+/**
+ * @brief Toggles a segment in the specified map.
+ * @param [in] The segment map to modify.
+ * @param [in] The ID of the segment.
+ */
+static inline void segmentMapToggle(SegmentMap map, SegmentId segment) {
+	map[segment >> 5] ^= (1UL << (segment & 31));
+}
+
+/**
+ * @brief  Initializes a game in GameStart state.
+ * @param  [in] The context of the game.
+ * @param  [in] The drivers of the game, must outlive the context.
+ * @param  [in] The driver state passed back through the context.
+ * @param  [in] The seed of the map selection, zero is replaced by one.
+ */
+void initGame(GameContext *game, const GameDrivers *drivers, void *driverData, uint32_t seed);
+
+/**
+ * @brief Advances the game by a single tick, based on the
+ *        current state and the queued input.
+ * @param [in] The context of the game.
+ */
+void updateGame(GameContext *game);
+
+// Methods called in GameStart state:
+
+/**
+ * @brief  Resets the game and its peripherals, and picks a map.
+ * @detail The state changes to SegmentSelect after the
+ *         initialization finished.
+ * @param  [in] The context of the game.
+ */
+void gameStart(GameContext *game);
+
+/**
+ * @brief Generates the gameplay map by randomly selecting
+ *        from a set of predefined maps.
+ * @param [in] The context of the game.
+ */
+void generateMap(GameContext *game);
+
+// Methods called in SegmentSelect state:
+
+/**
+ * @brief  Processes the user input: moves the blinking cursor or
+ *         fires at the selected segment.
+ * @param  [in] The context of the game.
+ */
+void segmentSelect(GameContext *game);
+
+/**
+ * @brief  Moves the selected segment to the left.
+ * @detail The selected segment is moved to the next digit
+ *         on the left. If the currently selected segment
+ *         is in the leftmost digit, it is moved to the
+ *         rightmost position.
+ * @param  [in] The context of the game.
+ */
+void moveLeft(GameContext *game);
+
+/**
+ * @brief  Moves the selected segment to the right.
+ * @detail The selected segment is moved to the next digit
+ *         on the right. If the currently selected segment
+ *         is in the rightmost digit, it is moved to the
+ *         leftmost position.
+ * @param  [in] The context of the game.
+ */
+void moveRight(GameContext *game);
+
+/**
+ * @brief  Moves the selected segment to the next position in
+ *         the current digit.
+ * @detail This operation always keeps the selected segment in
+ *         the current digit.
+ * @param  [in] The context of the game.
+ */
+void moveUp(GameContext *game);
+
+/**
+ * @brief  Moves the selected segment to the previous position in
+ *         the current digit.
+ * @detail This operation always keeps the selected segment in
+ *         the current digit.
+ * @param  [in] The context of the game.
+ */
+void moveDown(GameContext *game);
+
+/**
+ * @brief  Sets the game state to SegmentFire, starts the spinner
+ *         animation, and increases the total amount of shots if the
+ *         currently selected segment is not identified as a ship yet.
+ * @param  [in] The context of the game.
+ */
+void fire(GameContext *game);
+
+// Methods called in SegmentFire state:
+
+/**
+ * @brief  Waits for the spinner animation started by fire(), and
+ *         transfers the game to the next state.
+ * @detail If the currently selected
+ *         segment contains a ship, the next state will be SegmentHit.
+ *         Otherwise the state is transferred back to SegmentSelect.
+ * @param  [in] The context of the game.
+ */
+void segmentFire(GameContext *game);
+
+// Methods called in SegmentHit state:
+
+/**
+ * @brief Waits for the hit animation started by segmentFire(), and
+ *        permanently reveals the ship hit by the shot.
+ * @param [in] The context of the game.
+ */
+void segmentHit(GameContext *game);
+
+// Methods called in GameOver state:
+
+/**
+ * @brief Reports the finished game and returns the state to GameStart.
+ * @param [in] The context of the game.
+ */
+void gameOver(GameContext *game);
+
+// Helpers of the players:
+
+/**
+ * @brief  Returns the number of moves between the specified segments.
+ * @param  [in] The ID of the selected segment.
+ * @param  [in] The ID of the target segment.
+ * @return The number of moves.
+ */
+uint16_t segmentDistance(SegmentId from, SegmentId to);
+
+/**
+ * @brief  Plans the shortest input sequence moving the cursor between the
+ *         specified segments, followed by the fire input.
+ * @detail The plan inverts moveLeft(), moveRight(), moveUp() and moveDown():
+ *         the left and right moves step between the digits, the up and
+ *         down moves step within a digit, both wrap around.
+ * @param  [in] The ID of the selected segment.
+ * @param  [in] The ID of the target segment.
+ * @param  [out] The planned actions (InputStates), at least MOVE_PLAN_MAX_LENGTH long.
+ * @return The number of planned actions.
+ */
+uint16_t planMoves(SegmentId from, SegmentId to, uint8_t *actions);
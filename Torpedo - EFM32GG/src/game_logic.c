@@ -1,455 +1,165 @@
 #include "game_logic.h"
 
-void updateGameLoop(void) {
-
-	// Increasing gameTick counter
-	gameTick++;
-
-	// Action based on current gamestate
-	switch(gameState) {
-	case GameStart: 	gameStart(); 		break;
-	case SegmentSelect:	segmentSelect(); 	break;
-	case SegmentFire:	segmentFire(); 		break;
-	case SegmentHit:	segmentHit(); 		break;
-	case GameOver:		gameOver(); 		break;
-	}
-}
-
-void gameStart(void) {
-
-	// Initializing single value globals
-	selectedSegment = 0;
-	remainingShips = 8;
-	gameplayMap = NULL;
-	gameplayMapIndex = 0;
-	gameTick = 0;
+static void prepareBoard(GameContext *game) {
 
 	// Initializing dependencies
 	initDisplay();
 	initInput();
+}
 
-	// Generating map
-	generateMap();
-
-	// Assembling statistics message
-	Message_t msg = {
-		.gameStartedMessage.startTick   = gameTick,
-		.gameStartedMessage.tickDelayMs = GAMEPLAY_TICK_DELAY_MS,
-		.gameStartedMessage.mapIndex    = gameplayMapIndex
-	};
+static bool readBoardAction(GameContext *game, uint8_t *action) {
 
-	// Sending statistics message
-	sendStatisticsMessage(GameStartedMsg, msg);
+	// Taking the next input of the UART
+	InputEvent input;
+	if(!readInput(&input)) return false;
 
-	// Updating gamestate
-	gameState = SegmentSelect;
+	*action = input.action;
+	return true;
 }
 
-void generateMap(void) {
-
-	// List of predefined maps.
-	static bool maps[PREDEFINED_MAP_COUNT][LCD_SEGMENTS_COUNT] = {0};
-
-	// MAP1
-	maps[0][9]  = true;
-	maps[0][12] = true;
-	maps[0][48] = true;
-	maps[0][51] = true;
-	maps[0][53] = true;
-	maps[0][54] = true;
-	maps[0][78] = true;
-	maps[0][65] = true;
-
-	// MAP2
-	maps[1][0]  = true;
-	maps[1][13] = true;
-	maps[1][52] = true;
-	maps[1][65] = true;
-	maps[1][79] = true;
-	maps[1][80] = true;
-	maps[1][35] = true;
-	maps[1][38] = true;
-
-	// MAP3
-	maps[2][7]  = true;
-	maps[2][10] = true;
-	maps[2][30] = true;
-	maps[2][31] = true;
-	maps[2][87] = true;
-	maps[2][90] = true;
-	maps[2][47] = true;
-	maps[2][50] = true;
-
-	// MAP4
-	maps[3][4]  = true;
-	maps[3][5]  = true;
-	maps[3][14] = true;
-	maps[3][15] = true;
-	maps[3][30] = true;
-	maps[3][31] = true;
-	maps[3][79] = true;
-	maps[3][80] = true;
-
-	// MAP5
-	maps[4][6]  = true;
-	maps[4][19] = true;
-	maps[4][26] = true;
-	maps[4][39] = true;
-	maps[4][29] = true;
-	maps[4][42] = true;
-	maps[4][74] = true;
-	maps[4][77] = true;
-
-	// MAP6
-	maps[5][0]  = true;
-	maps[5][3]  = true;
-	maps[5][13] = true;
-	maps[5][16] = true;
-	maps[5][32] = true;
-	maps[5][45] = true;
-	maps[5][71] = true;
-	maps[5][84] = true;
-
-	// MAP7
-	maps[6][9]  = true;
-	maps[6][12] = true;
-	maps[6][22] = true;
-	maps[6][25] = true;
-	maps[6][35] = true;
-	maps[6][38] = true;
-	maps[6][59] = true;
-	maps[6][62] = true;
-
-	// MAP8
-	maps[7][6]  = true;
-	maps[7][19] = true;
-	maps[7][34] = true;
-	maps[7][37] = true;
-	maps[7][73] = true;
-	maps[7][76] = true;
-	maps[7][85] = true;
-	maps[7][88] = true;
-
-	// MAP9
-	maps[8][21] = true;
-	maps[8][24] = true;
-	maps[8][34] = true;
-	maps[8][37] = true;
-	maps[8][45] = true;
-	maps[8][58] = true;
-	maps[8][68] = true;
-	maps[8][81] = true;
-
-	// MAP10
-	maps[9][0]  = true;
-	maps[9][3]  = true;
-	maps[9][6]  = true;
-	maps[9][13] = true;
-	maps[9][19] = true;
-	maps[9][16] = true;
-	maps[9][45] = true;
-	maps[9][58] = true;
-
-	// MAP11
-	maps[10][65] = true;
-	maps[10][78] = true;
-	maps[10][68] = true;
-	maps[10][81] = true;
-	maps[10][71] = true;
-	maps[10][84] = true;
-	maps[10][32] = true;
-	maps[10][45] = true;
-
-	// MAP12
-	maps[11][9]  = true;
-	maps[11][12] = true;
-	maps[11][20] = true;
-	maps[11][23] = true;
-	maps[11][32] = true;
-	maps[11][45] = true;
-	maps[11][73] = true;
-	maps[11][76] = true;
-
-	// MAP13
-	maps[12][34] = true;
-	maps[12][37] = true;
-	maps[12][21] = true;
-	maps[12][24] = true;
-	maps[12][60] = true;
-	maps[12][63] = true;
-	maps[12][71] = true;
-	maps[12][84] = true;
-
-	// MAP14
-	maps[13][3]  = true;
-	maps[13][16] = true;
-	maps[13][27] = true;
-	maps[13][28] = true;
-	maps[13][30] = true;
-	maps[13][31] = true;
-	maps[13][53] = true;
-	maps[13][54] = true;
-
-	// MAP15
-	maps[14][4]  = true;
-	maps[14][5]  = true;
-	maps[14][16] = true;
-	maps[14][29] = true;
-	maps[14][43] = true;
-	maps[14][44] = true;
-	maps[14][71] = true;
-	maps[14][84] = true;
-
-	// MAP16
-	maps[15][6]  = true;
-	maps[15][19] = true;
-	maps[15][34] = true;
-	maps[15][37] = true;
-	maps[15][59] = true;
-	maps[15][62] = true;
-	maps[15][87] = true;
-	maps[15][90] = true;
-
-	// Seeding random generator
-	srand(time(0));
-
-	// Picking map at random
-	gameplayMapIndex = rand() % PREDEFINED_MAP_COUNT;
-
-	// Activating selected map
-	gameplayMap = &(maps[gameplayMapIndex][0]);
+static void setBoardCursor(GameContext *game, SegmentId segment) {
+	setCursor(segment);
 }
 
-void segmentSelect(void) {
-
-	// Counter used for timing the blinking
-	static uint8_t timingCounter = 0;
-
-	if(timingCounter++ == 15) {
-
-		// Blinking selected segment
-		displayMap[selectedSegment] = !displayMap[selectedSegment];
+static void invalidateBoardDisplay(GameContext *game, uint32_t regions) {
 
-		// Resetting timing counter
-		timingCounter = 0;
+	// Publishing the complete display state, the buffer holds an older one
+	DisplayState *state = getDisplayStateBuffer();
+	for(int i = 0; i < LCD_MAP_WORDS; i++) {
+		state->displayMap[i] = game->displayMap[i];
 	}
+	state->shotsTotal = game->shotsTotal;
+	publishDisplayState();
 
-	// Reading input state
-	uint8_t inputState = None;
-	xQueueReceive(inputQueue, &inputState, 0);
-
-	// Action based on input state
-	switch(inputState) {
-	case MoveLeft: 	displayMap[selectedSegment] = false; moveLeft(); 	break;
-	case MoveRight: displayMap[selectedSegment] = false; moveRight(); 	break;
-	case MoveUp: 	displayMap[selectedSegment] = false; moveUp();		break;
-	case MoveDown: 	displayMap[selectedSegment] = false; moveDown();	break;
-	case Fire: 		displayMap[selectedSegment] = false; fire(); 		break;
-	default: 															break;
-	}
+	invalidateDisplay(regions);
+}
 
-	if(inputState == MoveLeft || inputState == MoveRight || inputState == MoveUp || inputState == MoveDown) {
+static void startBoardAnimation(GameContext *game, GameAnimations animation) {
 
-		// Assembling statistics message
-		Message_t msg = {
-			.segmentSelectedMessage.gameTick  = gameTick,
-			.segmentSelectedMessage.segmentID = selectedSegment
-		};
-
-		// Sending statistics message
-		sendStatisticsMessage(SegmentSelectedMsg, msg);
+	// Playing the animation in hardware
+	switch(animation) {
+	case SpinnerAnimation:	startSpinnerAnimation(); 	break;
+	case HitAnimation:		startHitAnimation(); 		break;
 	}
+}
 
-	if(inputState == Fire) {
+static bool isBoardAnimationRunning(GameContext *game) {
+	return isAnimationRunning();
+}
 
-		// Assembling statistics message
-		Message_t msg = {
-			.segmentFiredMessage.gameTick  = gameTick,
-			.segmentFiredMessage.segmentID = selectedSegment
+static void reportBoardEvent(GameContext *game, GameEvents event) {
+
+	// Sending the statistics message of the event
+	switch(event) {
+	case GameStartedEvent:
+
+		// Starting the tick statistics of the game
+		tickOverruns = 0;
+		maxTickLatenessMs = 0;
+		shotsMissed = 0;
+
+		sendGameStartedMessage(game->gameTick, gameTickDelayMs, game->mapIndex);
+		break;
+
+	case SegmentSelectedEvent:	sendSegmentMessage(SegmentSelectedMsg, game->gameTick, game->selectedSegment); 	break;
+	case SegmentFiredEvent:		sendSegmentMessage(SegmentFiredMsg, game->gameTick, game->selectedSegment); 		break;
+	case SegmentHitEvent:		sendSegmentMessage(SegmentHitMsg, game->gameTick, game->selectedSegment); 		break;
+	case SegmentMissedEvent:
+		shotsMissed++;
+		sendSegmentMessage(SegmentMissedMsg, game->gameTick, game->selectedSegment);
+		break;
+
+	case GameFinishedEvent:
+	{
+#if configUSE_TICKLESS_IDLE == 2
+		// Reporting the sleeps during the game
+		IdleStatistics idle;
+		takeIdleStatistics(&idle);
+		sendIdleStatsMessage(idle.sleepCount, idle.expectedIdleTicks * portTICK_PERIOD_MS,
+							 idle.actualIdleTicks * portTICK_PERIOD_MS);
+#endif
+
+		sendGameFinishedMessage(game->gameTick, game->shotsTotal, tickOverruns, maxTickLatenessMs);
+
+		// Storing the summary of the game in the flash
+		GameSummary summary = {
+			.gameTicks   = game->gameTick,
+			.shotsTotal  = game->shotsTotal,
+			.shotsMissed = shotsMissed,
+			.mapIndex    = game->mapIndex
 		};
-
-		// Sending statistics message
-		sendStatisticsMessage(SegmentFiredMsg, msg);
+		storeGameSummary(&summary);
+		break;
 	}
-
-	// Making sure blinking doesn't hide already uncovered ships
-	for(int i = 0; i < 91; i++) {
-		if(i != selectedSegment) {
-			displayMap[i] = uncoveredMap[i];
-		}
 	}
 }
 
-void moveLeft(void) {
-
-	// Updating selected segment
-	selectedSegment = selectedSegment-LCD_LOWER_SEGMENTS_COUNT < 0 ?
-				      LCD_SEGMENTS_COUNT + (selectedSegment-LCD_LOWER_SEGMENTS_COUNT) :
-					  selectedSegment-LCD_LOWER_SEGMENTS_COUNT;
-}
-
-void moveRight(void) {
-
-	// Updating selected segment
-	selectedSegment = (selectedSegment + LCD_LOWER_SEGMENTS_COUNT) % (LCD_SEGMENTS_COUNT);
-}
-
-void moveUp(void) {
-
-	// Updating selected segment
-	selectedSegment = (selectedSegment/13)*13 + ((selectedSegment+1)%13);
-}
-
-void moveDown(void) {
-
-	// Updating selected segment
-	int8_t base = (selectedSegment/13)*13;
-	int8_t offset = selectedSegment-base-1 > 0 ? (selectedSegment-1)%13 : (selectedSegment+12)%13;
-	selectedSegment =  base + offset;
-}
-
-void fire(void) {
-
-	// Updating gamestate
-	gameState  = SegmentFire;
-
-	// Increasing number of total shots
-	if(!uncoveredMap[selectedSegment]) shotsTotal++;
+/**
+ * The drivers of the firmware game, connecting it to the peripherals of the board.
+ */
+static const GameDrivers boardDrivers = {
+	.prepareGame = prepareBoard,
+	.readAction = readBoardAction,
+	.setCursor = setBoardCursor,
+	.invalidateDisplay = invalidateBoardDisplay,
+	.startAnimation = startBoardAnimation,
+	.isAnimationRunning = isBoardAnimationRunning,
+	.reportEvent = reportBoardEvent
+};
+
+void initGameLogic(void) {
+
+	// Seeding the map selection with the time
+	initGame(&boardGame, &boardDrivers, NULL, time(0));
 }
 
-void segmentFire(void) {
-
-	// Bitmask for the Ring LCD Segments
-	static uint8_t spinnerState = 0x01;
-
-	// Counter used for timing the spinner
-	static uint8_t timingCounter = 0;
-
-	// Triggered on every Nth call of the function
-	if(timingCounter++ == 15) {
-
-		// Setting the LCD Ring Segments
-		spinnerBitmask = spinnerState;
-
-		// Shifting the spinner by one position
-		spinnerState = spinnerState << 1;
-
-		// Resetting timing counter
-		timingCounter = 0;
-	}
-
-	// Reset spinnerState on overflow and check if hit
-	if(spinnerState == 0x00) {
-		spinnerState = 0x01;
-
-		// Updating gamestate
-		if(gameplayMap[selectedSegment]) {
-			gameState = SegmentHit;
-			spinnerBitmask = 0x00;
-
-			// Assembling statistics message
-			Message_t msg = {
-				.segmentHitMessage.gameTick  = gameTick,
-				.segmentHitMessage.segmentID = selectedSegment
-			};
+void prvGameloopTask(void *prvParam) {
 
-			// Sending statistics message
-			sendStatisticsMessage(SegmentHitMsg, msg);
+	gameTickDelayMs = GAMEPLAY_TICK_DELAY_MS;
+	TickType_t tickPeriod = pdMS_TO_TICKS(gameTickDelayMs);
 
-		} else {
-			gameState = SegmentSelect;
-			spinnerBitmask = 0x00;
+	// The scheduled start of the current game tick
+	TickType_t scheduledWakeTime = xTaskGetTickCount();
 
-			// Assembling statistics message
-			Message_t msg = {
-				.segmentMissedMessage.gameTick  = gameTick,
-				.segmentMissedMessage.segmentID = selectedSegment
-			};
+	while(1) {
 
-			// Sending statistics message
-			sendStatisticsMessage(SegmentMissedMsg, msg);
+		// Measuring how late the game tick started
+		TickType_t lateness = xTaskGetTickCount() - scheduledWakeTime;
+		if(lateness * portTICK_PERIOD_MS > maxTickLatenessMs) {
+			maxTickLatenessMs = lateness * portTICK_PERIOD_MS;
 		}
-	}
-}
-
-void segmentHit(void) {
-
-	// Bitmask for the Ring LCD Segments
-	static uint8_t spinnerState = 0xff;
-
-	// Counter used for timing the blinks
-	static uint8_t timingCounter = 0;
-
-	// Counter used for counting the blinks
-	static uint8_t blinkCounter = 0;
 
-	// Triggered on every Nth call of the function
-	if(timingCounter++ == 15) {
-
-		// Setting the LCD Ring Segments
-		spinnerBitmask = spinnerState;
-
-		// Turning off the segments
-		if(spinnerState) {
-			spinnerState = 0x00;
-		}
-		// Turning on the segments
-		else {
-			spinnerState = 0xff;
-			blinkCounter++;
+		// Applying the tick period requested by the host
+		uint8_t requestedDelayMs = requestedTickPeriodMs;
+		if(requestedDelayMs != 0 && requestedDelayMs != gameTickDelayMs) {
+			gameTickDelayMs = requestedDelayMs;
+			tickPeriod = pdMS_TO_TICKS(gameTickDelayMs);
+			sendTickPeriodMessage(boardGame.gameTick, gameTickDelayMs);
 		}
 
-		// Resetting timing counter
-		timingCounter = 0;
-	}
-
-	// Triggered when blinking should finish
-	if(blinkCounter == 3) {
-
-		// Turning off the segments
-		spinnerBitmask = 0x00;
-
-		// Decreasing the number of remaining ships
-		if(!uncoveredMap[selectedSegment]) remainingShips--;
-
-		// Indicating the hit on the uncovered map
-		uncoveredMap[selectedSegment] = true;
-
-		// Resetting blink counter
-		blinkCounter = 0;
-
-		// Moving to the next game state
-		if(remainingShips != 0) {
-			gameState = SegmentSelect;
-		} else {
-			gameState = GameOver;
+		// Updating the game, holding the next game while the history writes the flash
+		if(boardGame.state != GameStart || !isHistoryBusy()) {
+			updateGame(&boardGame);
 		}
-	}
-}
-
-void gameOver(void) {
 
-	// Assembling statistics message
-	Message_t msg = {
-		.gameFinishedMessage.stopTick   = gameTick,
-		.gameFinishedMessage.shotsTotal = shotsTotal
-	};
-
-	// Sending statistics message
-	sendStatisticsMessage(GameFinishedMsg, msg);
-
-	// Resetting game state
-	gameState = GameStart;
-}
-
-void prvGameloopTask(void *prvParam) {
+		// Counting the ticks running into the next one
+		if(xTaskGetTickCount() - scheduledWakeTime >= tickPeriod) {
+			tickOverruns++;
+		}
 
-	while(1) {
+#if configUSE_TICKLESS_IDLE == 2
+		// Waiting for an input instead of ticking while the player is idle
+		if(boardGame.state == SegmentSelect && !isInputPending()) {
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
 
-		// Updating the gameloop
-		updateGameLoop();
+			// Skipping the idle ticks, the game tick keeps counting real time
+			TickType_t skippedTicks = (xTaskGetTickCount() - scheduledWakeTime) / tickPeriod;
+			boardGame.gameTick += skippedTicks;
+			scheduledWakeTime += skippedTicks * tickPeriod;
+		}
+#endif
 
-		// Delay for 10ms (100 Hz)
-		vTaskDelay(pdMS_TO_TICKS(GAMEPLAY_TICK_DELAY_MS));
+		// Waiting for the next tick, one period after the scheduled start of this one
+		vTaskDelayUntil(&scheduledWakeTime, tickPeriod);
 	}
 }
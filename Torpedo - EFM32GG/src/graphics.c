@@ -1,98 +1,373 @@
 #include "graphics.h"
+#include "animation.h"
+
+// The renderer drives the 7 digits of 13 segments of the board
+#if LCD_DIGITS_COUNT != 7 || LCD_LOWER_SEGMENTS_COUNT != 13
+#error "The board LCD has 7 digits of 13 lower segments"
+#endif
+
+/**
+ * Register location of each segment of the lower LCD display. The
+ * middle segment of a digit drives two LCD segments (g and m), all
+ * other segments leave their second location empty.
+ */
+static SegmentLCD_SegmentLocation_TypeDef segmentLocations[LCD_SEGMENTS_COUNT][2];
+
+/**
+ * Register bits belonging to the lower and upper LCD displays.
+ */
+static SegmentLCD_Frame_TypeDef lowerFrameMask;
+static SegmentLCD_Frame_TypeDef upperFrameMask;
+static SegmentLCD_Frame_TypeDef frameMask;
+
+/**
+ * The shadow framebuffer. The back frame is rendered by the graphics
+ * task, the front frame is the last published frame, and is committed
+ * to the LCD registers by the LCD interrupt. The committed frame holds
+ * the register content, including the cursor overlay.
+ */
+static SegmentLCD_Frame_TypeDef backFrame;
+static SegmentLCD_Frame_TypeDef frontFrame;
+static SegmentLCD_Frame_TypeDef committedFrame;
+
+/**
+ * The display state, triple buffered between the game loop and the
+ * graphics task. The game loop writes the back state, the graphics
+ * task renders the front state, and the third state is the last one
+ * published. Neither side waits for the other, the published state
+ * is exchanged with an atomic compare-and-swap.
+ */
+static DisplayState displayStates[3];
+static uint8_t backState = 0;
+static uint8_t frontState = 1;
+
+/**
+ * The index of the published display state, and DISPLAY_STATE_FRESH
+ * while the graphics task has not taken it yet.
+ */
+#define DISPLAY_STATE_INDEX 	(0x3UL)
+#define DISPLAY_STATE_FRESH 	(1UL << 2)
+static volatile uint32_t publishedState = 2;
+
+/**
+ * The segment highlighted by the blinking cursor, or CURSOR_HIDDEN.
+ */
+static volatile uint8_t cursorSegment;
+
+/**
+ * Indicating whether the cursor segment is currently inverted.
+ */
+static volatile bool cursorInverted;
 
 void initDisplay(void) {
 
 	// Initializing the LCD display with no voltage boost
 	SegmentLCD_Init(false);
 
-	// Initializing spinner bitmask
-	spinnerBitmask = 0x00;
+	// Initializing the display renderer
+	initLowerLCD();
+
+	// Initializing the hardware animations
+	initAnimation();
 
-	// Initializing number display
-	shotsTotal = 0;
+	// Initializing cursor
+	cursorSegment = CURSOR_HIDDEN;
+	cursorInverted = false;
+
+	// Publishing an empty display state
+	DisplayState *state = getDisplayStateBuffer();
+	*state = (DisplayState){0};
+	publishDisplayState();
+
+	// Redrawing the whole display
+	invalidateDisplay(DISPLAY_REGION_ALL);
+}
+
+void initLowerLCD(void) {
+
+	// Character segment driven by each segment ID of a digit
+	static const uint8_t characterSegment[LCD_LOWER_SEGMENTS_COUNT] = {
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 11, 12, 13
+	};
 
-	// Initializing display & uncovered maps
 	for(int i = 0; i < LCD_SEGMENTS_COUNT; i++) {
-		displayMap[i] = false;
-		uncoveredMap[i] = false;
+
+		// Acquiring digit and segment ID
+		uint8_t digitID =   i / LCD_LOWER_SEGMENTS_COUNT;
+		uint8_t segmentID = i % LCD_LOWER_SEGMENTS_COUNT;
+
+		// Looking up the primary register location
+		SegmentLCD_LowerSegmentLocation(digitID, characterSegment[segmentID],
+										&segmentLocations[i][0]);
+
+		// The middle segment also drives the m character segment
+		if(segmentID == 6) {
+			SegmentLCD_LowerSegmentLocation(digitID, 10, &segmentLocations[i][1]);
+		} else {
+			segmentLocations[i][1].com  = 0;
+			segmentLocations[i][1].high = 0;
+			segmentLocations[i][1].mask = 0;
+		}
+	}
+
+	// Collecting the register bits owned by the lower and upper displays
+	SegmentLCD_LowerFrameMask(&lowerFrameMask);
+	SegmentLCD_UpperFrameMask(&upperFrameMask);
+
+	for(int com = 0; com < SEGMENT_LCD_NUM_OF_COMS; com++) {
+		frameMask.segd[com][0] = lowerFrameMask.segd[com][0] | upperFrameMask.segd[com][0];
+		frameMask.segd[com][1] = lowerFrameMask.segd[com][1] | upperFrameMask.segd[com][1];
+	}
+
+	// The display is cleared by SegmentLCD_Init()
+	taskENTER_CRITICAL();
+	backFrame      = (SegmentLCD_Frame_TypeDef){0};
+	frontFrame     = (SegmentLCD_Frame_TypeDef){0};
+	committedFrame = (SegmentLCD_Frame_TypeDef){0};
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief Replaces the masked bits of the back frame.
+ * @param [in] The new content of the masked bits.
+ * @param [in] The register bits to replace.
+ */
+static void mergeBackFrame(const SegmentLCD_Frame_TypeDef *frame, const SegmentLCD_Frame_TypeDef *mask) {
+
+	for(int com = 0; com < SEGMENT_LCD_NUM_OF_COMS; com++) {
+		for(int high = 0; high < 2; high++) {
+			backFrame.segd[com][high] = (backFrame.segd[com][high] & ~mask->segd[com][high]) |
+										(frame->segd[com][high] & mask->segd[com][high]);
+		}
 	}
 }
 
+DisplayState *getDisplayStateBuffer(void) {
+	return &displayStates[backState];
+}
+
+void publishDisplayState(void) {
+
+	// Exchanging the written state with the published one
+	uint32_t published;
+	do {
+		published = publishedState;
+	} while(Atomic_CompareAndSwap_u32(&publishedState, backState | DISPLAY_STATE_FRESH, published)
+			!= ATOMIC_COMPARE_AND_SWAP_SUCCESS);
+
+	// Writing the previously published state next
+	backState = published & DISPLAY_STATE_INDEX;
+}
+
+/**
+ * @brief Takes the last published display state for rendering,
+ *        keeps rendering the current one if nothing new was published.
+ */
+static void takeDisplayState(void) {
+
+	// Exchanging the rendered state with the published one, if fresh
+	uint32_t published;
+	do {
+		published = publishedState;
+		if(!(published & DISPLAY_STATE_FRESH)) return;
+	} while(Atomic_CompareAndSwap_u32(&publishedState, frontState, published)
+			!= ATOMIC_COMPARE_AND_SWAP_SUCCESS);
+
+	frontState = published & DISPLAY_STATE_INDEX;
+}
+
 void updateLowerLCD(void) {
 
-	// Initializing segment configuration
-	SegmentLCD_LowerCharSegments_TypeDef lowerSegments[7] = {0};
+	// Initializing register content
+	SegmentLCD_Frame_TypeDef frame = {0};
 
-	// Checking display segments
-	for(int i = 0; i < LCD_SEGMENTS_COUNT; i++) {
+	// Checking active display segments only, one word at a time
+	for(int word = 0; word < LCD_MAP_WORDS; word++) {
 
-		if(displayMap[i]) {
-			// Acquiring digit and segment ID
-			uint8_t digitID =   i / LCD_LOWER_SEGMENTS_COUNT;
-			uint8_t segmentID = i % LCD_LOWER_SEGMENTS_COUNT;
-
-			// Setting up segment configuration
-			switch(segmentID) {
-			case 0:  lowerSegments[digitID].a = true; break;
-			case 1:  lowerSegments[digitID].b = true; break;
-			case 2:  lowerSegments[digitID].c = true; break;
-			case 3:  lowerSegments[digitID].d = true; break;
-			case 4:  lowerSegments[digitID].e = true; break;
-			case 5:  lowerSegments[digitID].f = true; break;
-			case 6:  lowerSegments[digitID].g = true;
-			         lowerSegments[digitID].m = true; break;
-			case 7:  lowerSegments[digitID].h = true; break;
-			case 8:  lowerSegments[digitID].j = true; break;
-			case 9:  lowerSegments[digitID].k = true; break;
-			case 10: lowerSegments[digitID].n = true; break;
-			case 11: lowerSegments[digitID].p = true; break;
-			case 12: lowerSegments[digitID].q = true; break;
-			}
+		// Copy of the word, active bits are cleared as they are processed
+		uint32_t bits = displayStates[frontState].displayMap[word];
+
+		while(bits) {
+			// Acquiring the index of the lowest active segment
+			uint8_t i = word * 32 + __builtin_ctz(bits);
+			bits &= bits - 1;
+
+			// Setting the register bits of the segment
+			const SegmentLCD_SegmentLocation_TypeDef *location = segmentLocations[i];
+			frame.segd[location[0].com][location[0].high] |= location[0].mask;
+			frame.segd[location[1].com][location[1].high] |= location[1].mask;
 		}
 	}
 
-	// Activating segments
-	SegmentLCD_LowerSegments(lowerSegments);
+	// Rendering into the back frame
+	mergeBackFrame(&frame, &lowerFrameMask);
 }
 
 void updateUpperLCD(void) {
 
-	// Storing last displayed value of total shots
-	static int8_t lastValue = -1;
+	// Segments of the decimal digits (bit 0: a ... bit 6: g)
+	static const uint8_t digitSegments[10] = {
+		0x3f, 0x06, 0x5b, 0x4f, 0x66, 0x6d, 0x7d, 0x07, 0x7f, 0x6f
+	};
 
-	// Only printing the value if it has been changed
-	if(lastValue != shotsTotal) {
-		SegmentLCD_Number(shotsTotal);
-		lastValue = shotsTotal;
+	// Initializing register content
+	SegmentLCD_Frame_TypeDef frame = {0};
+
+	// Printing the total shots with leading zeros, digit 0 is the least significant
+	unsigned value = displayStates[frontState].shotsTotal;
+
+	for(int digit = 0; digit < SEGMENT_LCD_NUM_OF_UPPER_CHARS; digit++) {
+
+		uint8_t segments = digitSegments[value % 10];
+		value /= 10;
+
+		for(int i = 0; i < 7; i++) {
+			if(segments & (1 << i)) {
+				SegmentLCD_SegmentLocation_TypeDef location;
+				SegmentLCD_UpperSegmentLocation(digit, i, &location);
+				frame.segd[location.com][location.high] |= location.mask;
+			}
+		}
 	}
+
+	// Rendering into the back frame
+	mergeBackFrame(&frame, &upperFrameMask);
 }
 
-void updateSpinnerLCD(void) {
+void setCursor(uint8_t segment) {
 
-	for(int i = 0; i < 8; i++) {
+	// Restarting the blinking on the new segment
+	taskENTER_CRITICAL();
+	cursorSegment = segment;
+	cursorInverted = false;
+	taskEXIT_CRITICAL();
 
-		// Activating spinner LCD segments based on
-		// the provided bitmask
-		SegmentLCD_ARing(i, spinnerBitmask & (1<<i));
+	// Blinking a shown cursor on the frame counter events
+	if(segment != CURSOR_HIDDEN) {
+		startCursorBlink();
 	}
+
+	// Committing the old and new cursor segments
+	NVIC_SetPendingIRQ(LCD_IRQn);
+}
+
+bool blinkCursorFromISR(void) {
+
+	// Toggling the blink phase, committed by commitDisplayFromISR()
+	cursorInverted = !cursorInverted;
+
+	return cursorSegment != CURSOR_HIDDEN;
 }
 
-void updateDisplay(void) {
+void publishDisplay(void) {
+
+	// Handing the complete back frame over to the LCD interrupt
+	taskENTER_CRITICAL();
+	frontFrame = backFrame;
+	taskEXIT_CRITICAL();
 
-	// Updating all parts of the LCD display.
-	updateLowerLCD();
-	updateUpperLCD();
-	updateSpinnerLCD();
+	// Committing as soon as possible
+	NVIC_SetPendingIRQ(LCD_IRQn);
 }
 
+void commitDisplayFromISR(void) {
+
+	// Applying the cursor overlay to the published frame
+	SegmentLCD_Frame_TypeDef frame = frontFrame;
+
+	if(cursorSegment != CURSOR_HIDDEN && cursorInverted) {
+		const SegmentLCD_SegmentLocation_TypeDef *location = segmentLocations[cursorSegment];
+		frame.segd[location[0].com][location[0].high] ^= location[0].mask;
+		frame.segd[location[1].com][location[1].high] ^= location[1].mask;
+	}
+
+	// Writing the changed registers, or retrying on the next frame counter event
+	if(SegmentLCD_FrameCommit(&frame, &frameMask, &committedFrame)) {
+		displayCommitCount++;
+	} else {
+		displayDeferredCount++;
+	}
+}
+
+void updateDisplay(uint32_t regions) {
+
+	// Rendering a consistent snapshot of the game
+	takeDisplayState();
+
+	// Updating the requested parts of the LCD display.
+	if(regions & DISPLAY_REGION_LOWER) updateLowerLCD();
+	if(regions & DISPLAY_REGION_UPPER) updateUpperLCD();
+
+	// Publishing the frame, never waiting for the LCD controller
+	publishDisplay();
+}
+
+#if configUSE_CO_ROUTINES
+
+/**
+ * The regions waiting to be redrawn by the graphics co-routine,
+ * the whole display is drawn on startup.
+ */
+static volatile uint32_t invalidRegions = DISPLAY_REGION_ALL;
+
+void invalidateDisplay(uint32_t regions) {
+
+	// Setting the dirty flags of the graphics co-routine
+	taskENTER_CRITICAL();
+	invalidRegions |= regions;
+	taskEXIT_CRITICAL();
+}
+
+bool isGraphicsPending(void) {
+	return invalidRegions != 0;
+}
+
+void crGraphics(CoRoutineHandle_t handle, UBaseType_t index) {
+
+	crSTART(handle);
+
+	while(1) {
+
+		// Yielding until the next change, co-routines cannot block on notifications
+		while(invalidRegions == 0) {
+			crDELAY(handle, 0);
+		}
+
+		// Updating the changed parts of the display, clearing the dirty flags
+		taskENTER_CRITICAL();
+		uint32_t regions = invalidRegions;
+		invalidRegions = 0;
+		taskEXIT_CRITICAL();
+
+		updateDisplay(regions);
+	}
+
+	crEND();
+}
+
+#else
+
+void invalidateDisplay(uint32_t regions) {
+
+	// Setting the dirty flags of the graphics task
+	if(graphicsTask != NULL) {
+		xTaskNotify(graphicsTask, regions, eSetBits);
+	}
+}
+
+#endif
+
 void prvGraphicsTask(void *prvParam) {
 
+	// Drawing the whole display on startup
+	uint32_t regions = DISPLAY_REGION_ALL;
+
 	while(1) {
 
-		// Updating the display
-		updateDisplay();
+		// Updating the changed parts of the display
+		updateDisplay(regions);
 
-		// Delay for 20ms (50 Hz)
-		vTaskDelay(pdMS_TO_TICKS(20));
+		// Sleeping until the next change, clearing the dirty flags
+		xTaskNotifyWait(0, DISPLAY_REGION_ALL, &regions, portMAX_DELAY);
 	}
 }
@@ -1,5 +1,9 @@
 #pragma once
 
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
 // Board includes
 #include <em_lcd.h>
 #include <em_cmu.h>
@@ -9,41 +13,38 @@
 // FreeRTOS includes
 #include "FreeRTOS.h"
 #include "task.h"
+#include "croutine.h"
+#include "atomic.h"
 
-// Project defines
-#define LCD_SEGMENTS_COUNT        (13*7)
-#define LCD_LOWER_SEGMENTS_COUNT  (13)
-
-/**
- * Array of booleans indicating which segments of the lower
- * LCD display should be active at any given moment. Modifying
- * the content of this array directly results in the LCD display
- * changing. Changes take effect upon calling updateDisplay().
- */
-bool displayMap[LCD_SEGMENTS_COUNT];
+// Project includes
+#include "game_core.h"
 
 /**
- * Array of booleans indicating which segments of the lower
- * LCD display should be permanently active. A segment should
- * be permanently active if a ship is confirmed at that location.
+ * The state of the game shown on the LCD display: the segments
+ * active on the lower display, and the number of shots shown on
+ * the upper display. The game loop publishes complete states, the
+ * graphics task always renders the last one published.
  */
-bool uncoveredMap[LCD_SEGMENTS_COUNT];
+typedef struct {
+	SegmentMap displayMap;
+	uint16_t shotsTotal;
+} DisplayState;
 
 /**
- * Bitmask indicating the desired status of the spinner LCD segments.
- * Each bit of this variable directly corresponds with the specific
- * segments of the LCD. Modifying this value directly affects the
- * status of the spinner LCD. Changes take effect upon calling
- * updateDisplay().
+ * The number of frames committed to the LCD registers, and the number
+ * of commits deferred to the next frame counter event because the LCD
+ * controller was still synchronizing the previous update. Together they
+ * replace the time previously spent spinning in LCD_SyncBusyDelay().
  */
-uint8_t spinnerBitmask;
+volatile uint32_t displayCommitCount;
+volatile uint32_t displayDeferredCount;
 
 /**
- * This variable holds the number of shots attempted by the user.
- * The application keeps track of already confirmed ships, trying
- * to fire on such does not increase the counter.
+ * Handle of the graphics task. The task sleeps until it is notified
+ * about a display change via invalidateDisplay(). Unused in the
+ * co-routine build.
  */
-uint8_t shotsTotal;
+TaskHandle_t graphicsTask;
 
 /**
  * @brief Initializes the LCD display, and the helper
@@ -52,29 +53,115 @@ uint8_t shotsTotal;
 void initDisplay(void);
 
 /**
- * @brief Updates the lower part of the LCD display.
+ * @brief  Initializes the renderer of the LCD display.
+ * @detail Precomputes the COM line, register and bitmask of
+ *         every lower segment, so a frame can be committed
+ *         with a few masked register writes, and clears the
+ *         shadow framebuffer.
+ */
+void initLowerLCD(void);
+
+/**
+ * @brief  Returns the display state written by the game loop.
+ * @detail The buffer is owned by the game loop until the next
+ *         publishDisplayState(), and holds an older state, so
+ *         every member must be written before publishing.
+ * @return The display state to write.
+ */
+DisplayState *getDisplayStateBuffer(void);
+
+/**
+ * @brief  Publishes the display state written by the game loop.
+ * @detail Swaps the written buffer with the published one in a single
+ *         atomic operation, the graphics task picks it up on its next
+ *         update. Never waits for the graphics task.
+ */
+void publishDisplayState(void);
+
+/**
+ * @brief Renders the lower part of the LCD display into
+ *        the back frame.
  */
 void updateLowerLCD(void);
 
 /**
- * @brief Updates the upper part of the LCD display.
+ * @brief Renders the upper part of the LCD display into
+ *        the back frame.
  */
 void updateUpperLCD(void);
 
 /**
- * @brief Updates the spinner part of the LCD display.
+ * @brief  Moves the blinking cursor to the specified segment.
+ * @detail The cursor is drawn as an overlay that inverts the
+ *         segment on every other animation step, the blinking
+ *         itself is driven by the LCD frame counter interrupt.
+ * @param  [in] The ID of the segment, or CURSOR_HIDDEN.
+ */
+void setCursor(uint8_t segment);
+
+/**
+ * @brief  Toggles the blink phase of the cursor.
+ * @detail Called from the LCD frame counter interrupt, the
+ *         change is written by commitDisplayFromISR().
+ * @return True while the cursor is shown, false if it is hidden
+ *         and needs no further frame counter events.
  */
-void updateSpinnerLCD(void);
+bool blinkCursorFromISR(void);
 
 /**
- * @brief Updates the whole LCD display by calling
- *        the update method of the different parts.
+ * @brief  Publishes the back frame to the LCD interrupt.
+ * @detail Copies the back frame into the front frame and pends
+ *         the LCD interrupt, which commits it. Never waits for
+ *         the LCD controller.
  */
-void updateDisplay(void);
+void publishDisplay(void);
 
 /**
- * @brief The FreeRTOS task that periodically updates
- *        the LCD displays of the EFM32GG board.
+ * @brief  Commits the front frame to the LCD registers.
+ * @detail Called from the LCD interrupt. Applies the cursor
+ *         overlay and writes the changed registers. If the LCD
+ *         controller is still synchronizing, the commit is
+ *         retried on the next frame counter event.
+ */
+void commitDisplayFromISR(void);
+
+/**
+ * @brief Updates the LCD display by calling the update
+ *        method of the different parts, and publishing
+ *        the result.
+ * @param [in] The DISPLAY_REGION_x flags of the parts to update.
+ */
+void updateDisplay(uint32_t regions);
+
+/**
+ * @brief  Marks regions of the LCD display as changed.
+ * @detail Sets the specified dirty flags in the notification
+ *         value of the graphics task, waking it up to redraw
+ *         the regions. Safe to call before the task exists.
+ * @param  [in] The DISPLAY_REGION_x flags of the changed parts.
+ */
+void invalidateDisplay(uint32_t regions);
+
+/**
+ * @brief The FreeRTOS task that updates the LCD displays
+ *        of the EFM32GG board whenever they are invalidated.
  * @param The FreeRTOS task parameter (unused).
  */
 void prvGraphicsTask(void *prvParam);
+
+#if configUSE_CO_ROUTINES
+/**
+ * @brief  The co-routine that updates the display in the co-routine build.
+ * @detail Runs from the idle task, redrawing the regions marked by
+ *         invalidateDisplay() and yielding while there are none.
+ * @param  [in] The handle of the co-routine.
+ * @param  [in] The index of the co-routine (unused).
+ */
+void crGraphics(CoRoutineHandle_t handle, UBaseType_t index);
+
+/**
+ * @brief  Returns whether the graphics co-routine has regions to redraw.
+ * @return True if a region was invalidated since the last redraw.
+ */
+bool isGraphicsPending(void);
+#endif
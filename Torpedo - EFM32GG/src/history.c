@@ -0,0 +1,587 @@
+// Standard includes
+#include <string.h>
+
+// Project includes
+#include "history.h"
+#include "statistics.h"
+
+/**
+ * The states of the history pages: holding stored summaries, erased
+ * and ready for activation, or waiting for the background erase.
+ */
+typedef enum {HistoryPageStale, HistoryPageErased, HistoryPageLive} HistoryPageState;
+
+/**
+ * The page index indicating that no page is active.
+ */
+#define HISTORY_NO_PAGE 		(0xFF)
+
+/**
+ * The index of the history, loaded from the page headers at boot. Only
+ * written by the history task in critical sections, and read by the
+ * statistics task sending the history.
+ */
+static uint32_t pageSequences[HISTORY_PAGE_COUNT];
+static uint8_t pageStates[HISTORY_PAGE_COUNT];
+static uint8_t activePage = HISTORY_NO_PAGE;
+static uint16_t activeSlots;
+
+/**
+ * The summaries queued for the history task. Both indices are only
+ * accessed in critical sections.
+ */
+static GameSummary summaryQueue[HISTORY_QUEUE_LENGTH];
+static uint32_t queueHead;
+static uint32_t queueTail;
+
+/**
+ * Set while the history has flash work left: from the boot until the
+ * stale pages are checked, and from queuing a summary until it is written.
+ */
+static volatile bool historyBusy;
+
+#if configUSE_CO_ROUTINES
+
+/**
+ * Set when a summary is queued, polled by the history co-routine.
+ */
+static volatile bool historyPending = true;
+
+#endif
+
+/**
+ * @brief  Returns the header of a history page.
+ * @param  [in] The index of the page.
+ * @return The header at the start of the page.
+ */
+static inline const HistoryPageHeader *pageHeader(uint8_t page) {
+	return (const HistoryPageHeader *)(HISTORY_BASE + page * (FLASH_PAGE_SIZE / sizeof(uint32_t)));
+}
+
+/**
+ * @brief  Returns the records of a history page.
+ * @param  [in] The index of the page.
+ * @return The records following the page header.
+ */
+static inline const HistoryRecord *pageRecords(uint8_t page) {
+	return (const HistoryRecord *)(pageHeader(page) + 1);
+}
+
+/**
+ * @brief  Calculates the FNV-1a hash of the specified words.
+ * @param  [in] The words to hash.
+ * @param  [in] The number of words.
+ * @return The hash of the words.
+ */
+static uint32_t checksumWords(const uint32_t *words, uint32_t count) {
+
+	uint32_t hash = 2166136261UL;
+
+	for(uint32_t i = 0; i < count; i++) {
+		hash ^= words[i];
+		hash *= 16777619UL;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief  Calculates the checksum of a record, covering every field before it.
+ * @param  [in] The record.
+ * @return The checksum of the record.
+ */
+static uint16_t recordChecksum(const HistoryRecord *record) {
+	uint32_t hash = checksumWords((const uint32_t *)record, sizeof(HistoryRecord) / sizeof(uint32_t) - 1);
+	hash ^= (uint32_t)record->mapIndex | (uint32_t)record->reserved << 8;
+	return hash ^ hash >> 16;
+}
+
+/**
+ * @brief  Returns whether the record holds a completely written summary.
+ * @param  [in] The record.
+ * @return True if the record is valid.
+ */
+static bool isRecordValid(const HistoryRecord *record) {
+	return record->mapIndex < PREDEFINED_MAP_COUNT && record->checksum == recordChecksum(record);
+}
+
+/**
+ * @brief  Returns whether a record slot is erased.
+ * @param  [in] The record slot.
+ * @return True if every word of the slot is erased.
+ */
+static bool isSlotErased(const HistoryRecord *record) {
+
+	const uint32_t *words = (const uint32_t *)record;
+
+	for(uint8_t i = 0; i < sizeof(HistoryRecord) / sizeof(uint32_t); i++) {
+		if(words[i] != 0xFFFFFFFFUL) return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief  Returns whether the header of a page is completely written.
+ * @param  [in] The header.
+ * @return True if the header is valid.
+ */
+static bool isHeaderValid(const HistoryPageHeader *header) {
+	return header->magic == HISTORY_PAGE_MAGIC &&
+		   header->checksum == checksumWords((const uint32_t *)header, sizeof(HistoryPageHeader) / sizeof(uint32_t) - 1);
+}
+
+/**
+ * @brief  Returns whether every word of a page is erased.
+ * @param  [in] The index of the page.
+ * @return True if the page is erased.
+ */
+static bool isPageErased(uint8_t page) {
+
+	const uint32_t *words = (const uint32_t *)pageHeader(page);
+
+	for(uint32_t i = 0; i < FLASH_PAGE_SIZE / sizeof(uint32_t); i++) {
+		if(words[i] != 0xFFFFFFFFUL) return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief  Returns whether a page with the specified sequence number holds
+ *         stored summaries: the newest HISTORY_PAGE_COUNT - 1 pages do.
+ * @param  [in] The sequence number of the page, 0 for an invalid page.
+ * @param  [in] The sequence number of the active page.
+ * @return True if the page is in the log.
+ */
+static bool isSequenceLive(uint32_t sequence, uint32_t activeSequence) {
+	return sequence != 0 && sequence + (HISTORY_PAGE_COUNT - 1) > activeSequence;
+}
+
+/**
+ * @brief  Finds the first erased slot of a page by a binary search,
+ *         the slots are written in order.
+ * @param  [in] The index of the page.
+ * @return The number of used slots.
+ */
+static uint16_t findEndOfPage(uint8_t page) {
+
+	const HistoryRecord *records = pageRecords(page);
+	uint16_t low = 0;
+	uint16_t high = HISTORY_PAGE_RECORDS;
+
+	while(low < high) {
+		uint16_t middle = (low + high) / 2;
+
+		if(isSlotErased(&records[middle])) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+
+	return low;
+}
+
+/**
+ * @brief Enables writing and erasing the flash.
+ */
+static void unlockFlash(void) {
+
+	MSC_Init();
+
+#if defined(MSC_WRITECTRL_RWWEN)
+	// Running the firmware from the other flash bank while the history is written
+	MSC->WRITECTRL |= MSC_WRITECTRL_RWWEN;
+#endif
+}
+
+/**
+ * @brief Disables writing and erasing the flash.
+ */
+static void lockFlash(void) {
+	MSC_Deinit();
+}
+
+/**
+ * @brief  Sets the state of a page.
+ * @param  [in] The index of the page.
+ * @param  [in] The new state.
+ */
+static void setPageState(uint8_t page, HistoryPageState state) {
+	taskENTER_CRITICAL();
+	pageStates[page] = state;
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief  Erases a page.
+ * @param  [in] The index of the page.
+ * @return True if the page is erased.
+ */
+static bool erasePage(uint8_t page) {
+
+	unlockFlash();
+	MSC_Status_TypeDef status = MSC_ErasePage((uint32_t *)pageHeader(page));
+	lockFlash();
+
+	bool erased = status == mscReturnOk && isPageErased(page);
+	setPageState(page, erased ? HistoryPageErased : HistoryPageStale);
+
+	return erased;
+}
+
+/**
+ * @brief Erases the pages that left the log, or were left over by a reset.
+ *        A page found erased is not erased again, saving its endurance.
+ */
+static void eraseStalePages(void) {
+
+	for(uint8_t page = 0; page < HISTORY_PAGE_COUNT; page++) {
+
+		if(pageStates[page] != HistoryPageStale) continue;
+
+		if(isPageErased(page)) {
+			setPageState(page, HistoryPageErased);
+		} else {
+			erasePage(page);
+		}
+	}
+}
+
+/**
+ * @brief  Activates the next erased page, and folds the summaries of the
+ *         page leaving the log into the totals of the new page header.
+ * @return True if a page was activated.
+ */
+static bool activateNextPage(void) {
+
+	// The header is built outside the small stack of the history task
+	static HistoryPageHeader header;
+
+	// Taking the erased pages in turn, spreading the erases evenly
+	uint8_t first = activePage != HISTORY_NO_PAGE ? activePage : HISTORY_PAGE_COUNT - 1;
+	uint8_t next = HISTORY_NO_PAGE;
+
+	for(uint8_t i = 1; i <= HISTORY_PAGE_COUNT && next == HISTORY_NO_PAGE; i++) {
+		uint8_t page = (first + i) % HISTORY_PAGE_COUNT;
+		if(pageStates[page] == HistoryPageErased) next = page;
+	}
+
+	// Erasing a page now if the background erase has not run yet
+	for(uint8_t i = 1; i <= HISTORY_PAGE_COUNT && next == HISTORY_NO_PAGE; i++) {
+		uint8_t page = (first + i) % HISTORY_PAGE_COUNT;
+		if(pageStates[page] == HistoryPageStale && erasePage(page)) next = page;
+	}
+
+	if(next == HISTORY_NO_PAGE) return false;
+
+	// Carrying over the totals of the active page
+	header.magic = HISTORY_PAGE_MAGIC;
+	if(activePage != HISTORY_NO_PAGE) {
+		header.sequence = pageSequences[activePage] + 1;
+		memcpy(header.totals, pageHeader(activePage)->totals, sizeof(header.totals));
+	} else {
+		header.sequence = 1;
+		memset(header.totals, 0, sizeof(header.totals));
+	}
+
+	// Folding the summaries of the page leaving the log into the totals
+	uint8_t leaving = HISTORY_NO_PAGE;
+	for(uint8_t page = 0; page < HISTORY_PAGE_COUNT; page++) {
+		if(pageStates[page] == HistoryPageLive && !isSequenceLive(pageSequences[page], header.sequence)) {
+			leaving = page;
+		}
+	}
+
+	if(leaving != HISTORY_NO_PAGE) {
+		const HistoryRecord *records = pageRecords(leaving);
+
+		for(uint16_t i = 0; i < HISTORY_PAGE_RECORDS; i++) {
+			if(!isRecordValid(&records[i])) continue;
+
+			HistoryTotals *totals = &header.totals[records[i].mapIndex];
+			totals->games++;
+			totals->gameTicks   += records[i].gameTicks;
+			totals->shotsTotal  += records[i].shotsTotal;
+			totals->shotsMissed += records[i].shotsMissed;
+		}
+	}
+
+	header.checksum = checksumWords((const uint32_t *)&header, sizeof(HistoryPageHeader) / sizeof(uint32_t) - 1);
+
+	// Writing the header, the checksum is the last word written
+	unlockFlash();
+	MSC_Status_TypeDef status = MSC_WriteWord((uint32_t *)pageHeader(next), &header, sizeof(header));
+	lockFlash();
+
+	if(status != mscReturnOk) {
+		setPageState(next, HistoryPageStale);
+		return false;
+	}
+
+	// Switching to the new page, the page leaving the log is erased in the background
+	taskENTER_CRITICAL();
+	pageSequences[next] = header.sequence;
+	pageStates[next] = HistoryPageLive;
+	if(leaving != HISTORY_NO_PAGE) pageStates[leaving] = HistoryPageStale;
+	activePage = next;
+	activeSlots = 0;
+	taskEXIT_CRITICAL();
+
+	return true;
+}
+
+/**
+ * @brief Appends a summary to the active page, activating the next
+ *        page if the active one is full.
+ * @param [in] The summary of the game.
+ */
+static void appendRecord(const GameSummary *summary) {
+
+	if(activePage == HISTORY_NO_PAGE || activeSlots >= HISTORY_PAGE_RECORDS) {
+		if(!activateNextPage()) {
+			historyDroppedCount++;
+			return;
+		}
+	}
+
+	HistoryRecord record = {
+		.gameTicks   = summary->gameTicks,
+		.shotsTotal  = summary->shotsTotal,
+		.shotsMissed = summary->shotsMissed,
+		.mapIndex    = summary->mapIndex,
+		.reserved    = 0xFF
+	};
+	record.checksum = recordChecksum(&record);
+
+	// Writing the record, the checksum is in the last word written
+	unlockFlash();
+	MSC_Status_TypeDef status = MSC_WriteWord((uint32_t *)&pageRecords(activePage)[activeSlots], &record, sizeof(record));
+	lockFlash();
+
+	// The slot is used even if the write failed
+	taskENTER_CRITICAL();
+	activeSlots++;
+	taskEXIT_CRITICAL();
+
+	if(status != mscReturnOk) historyDroppedCount++;
+}
+
+/**
+ * @brief  Takes the next queued summary.
+ * @param  [out] The summary.
+ * @return True if a summary was queued.
+ */
+static bool takeSummary(GameSummary *summary) {
+
+	bool taken = false;
+
+	taskENTER_CRITICAL();
+	if(queueTail != queueHead) {
+		*summary = summaryQueue[queueTail++ & (HISTORY_QUEUE_LENGTH - 1)];
+		taken = true;
+	}
+	taskEXIT_CRITICAL();
+
+	return taken;
+}
+
+void serviceHistory(void) {
+
+	GameSummary summary;
+	while(takeSummary(&summary)) {
+		appendRecord(&summary);
+	}
+
+	eraseStalePages();
+
+	// Letting the next game start, unless a summary was queued meanwhile
+	taskENTER_CRITICAL();
+	historyBusy = queueTail != queueHead;
+	taskEXIT_CRITICAL();
+}
+
+bool isHistoryBusy(void) {
+	return historyBusy;
+}
+
+void initHistory(void) {
+
+	// Reading the sequence number of every valid page
+	uint32_t activeSequence = 0;
+	activePage = HISTORY_NO_PAGE;
+
+	for(uint8_t page = 0; page < HISTORY_PAGE_COUNT; page++) {
+		const HistoryPageHeader *header = pageHeader(page);
+		pageSequences[page] = isHeaderValid(header) ? header->sequence : 0;
+
+		if(pageSequences[page] > activeSequence) {
+			activeSequence = pageSequences[page];
+			activePage = page;
+		}
+	}
+
+	// The pages outside the log are checked by the history task
+	for(uint8_t page = 0; page < HISTORY_PAGE_COUNT; page++) {
+		pageStates[page] = isSequenceLive(pageSequences[page], activeSequence) ? HistoryPageLive : HistoryPageStale;
+	}
+
+	// Finding the end of the active page
+	activeSlots = activePage != HISTORY_NO_PAGE ? findEndOfPage(activePage) : 0;
+
+	// Holding the first game until the stale pages are checked
+	historyBusy = true;
+}
+
+void storeGameSummary(const GameSummary *summary) {
+
+	taskENTER_CRITICAL();
+	if(queueHead - queueTail == HISTORY_QUEUE_LENGTH) {
+		historyDroppedCount++;
+		taskEXIT_CRITICAL();
+		return;
+	}
+	summaryQueue[queueHead++ & (HISTORY_QUEUE_LENGTH - 1)] = *summary;
+	historyBusy = true;
+	taskEXIT_CRITICAL();
+
+	wakeHistory();
+}
+
+/**
+ * @brief Sends a little-endian 16 bit value over the UART.
+ * @param [in] The value to send.
+ */
+static void transmitHalfWord(uint16_t data) {
+	USART_Tx(UART0, data);
+	USART_Tx(UART0, data >> 8);
+}
+
+/**
+ * @brief Sends a little-endian 32 bit value over the UART.
+ * @param [in] The value to send.
+ */
+static void transmitWord(uint32_t data) {
+	USART_Tx(UART0, data);
+	USART_Tx(UART0, data >> 8);
+	USART_Tx(UART0, data >> 16);
+	USART_Tx(UART0, data >> 24);
+}
+
+void transmitHistory(void) {
+
+	// Taking a snapshot of the index
+	uint32_t sequences[HISTORY_PAGE_COUNT];
+	uint8_t states[HISTORY_PAGE_COUNT];
+
+	taskENTER_CRITICAL();
+	memcpy(sequences, pageSequences, sizeof(sequences));
+	memcpy(states, pageStates, sizeof(states));
+	uint8_t active = activePage;
+	uint16_t slots = activeSlots;
+	taskEXIT_CRITICAL();
+
+	// Ordering the pages of the log from the oldest, the active page is the last
+	uint8_t order[HISTORY_PAGE_COUNT];
+	uint8_t liveCount = 0;
+
+	for(uint8_t page = 0; page < HISTORY_PAGE_COUNT; page++) {
+		if(states[page] != HistoryPageLive) continue;
+
+		uint8_t i = liveCount++;
+		for(; i > 0 && sequences[order[i - 1]] > sequences[page]; i--) {
+			order[i] = order[i - 1];
+		}
+		order[i] = page;
+	}
+
+	uint16_t recordCount = liveCount > 0 ? (liveCount - 1) * HISTORY_PAGE_RECORDS + slots : 0;
+
+	// Sending message type identifier and the sequence number of the active page
+	USART_Tx(UART0, HistoryMsg);
+	transmitWord(active != HISTORY_NO_PAGE ? sequences[active] : 0);
+
+	// Sending the totals of the games that left the log
+	USART_Tx(UART0, PREDEFINED_MAP_COUNT);
+	for(uint8_t map = 0; map < PREDEFINED_MAP_COUNT; map++) {
+		const HistoryTotals *totals = active != HISTORY_NO_PAGE ? &pageHeader(active)->totals[map] : NULL;
+
+		transmitWord(totals ? totals->games : 0);
+		transmitWord(totals ? totals->gameTicks : 0);
+		transmitWord(totals ? totals->shotsTotal : 0);
+		transmitWord(totals ? totals->shotsMissed : 0);
+	}
+
+	// Sending the stored records from the oldest
+	transmitHalfWord(recordCount);
+
+	for(uint8_t i = 0; i < liveCount; i++) {
+		uint8_t page = order[i];
+		uint16_t count = page == active ? slots : HISTORY_PAGE_RECORDS;
+
+		for(uint16_t slot = 0; slot < count; slot++) {
+			HistoryRecord record = pageRecords(page)[slot];
+
+			// Checking the page after reading the record, an erased page has no valid header
+			__DMB();
+			bool valid = isRecordValid(&record) && pageHeader(page)->sequence == sequences[page];
+
+			USART_Tx(UART0, valid ? record.mapIndex : HISTORY_LOST_RECORD);
+			transmitWord(record.gameTicks);
+			transmitHalfWord(record.shotsTotal);
+			transmitHalfWord(record.shotsMissed);
+		}
+	}
+}
+
+#if configUSE_CO_ROUTINES
+
+void wakeHistory(void) {
+	historyPending = true;
+}
+
+bool isHistoryPending(void) {
+	return historyPending;
+}
+
+void crHistory(CoRoutineHandle_t handle, UBaseType_t index) {
+
+	crSTART(handle);
+
+	while(1) {
+
+		// Yielding until summaries are queued, the stale pages are checked on startup
+		while(!historyPending) {
+			crDELAY(handle, 0);
+		}
+		historyPending = false;
+
+		// Writing the queued summaries
+		serviceHistory();
+	}
+
+	crEND();
+}
+
+#else
+
+void wakeHistory(void) {
+	if(historyTask != NULL) {
+		xTaskNotifyGive(historyTask);
+	}
+}
+
+#endif
+
+void prvHistoryTask(void *prvParam) {
+
+	while(1) {
+
+		// Writing the queued summaries, the stale pages are checked on startup
+		serviceHistory();
+
+		// Waiting for the next summary
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+	}
+}
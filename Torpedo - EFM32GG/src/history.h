@@ -0,0 +1,211 @@
+#pragma once
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Board includes
+#include <em_device.h>
+#include <em_msc.h>
+#include <em_usart.h>
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "croutine.h"
+
+// Project includes
+#include "game_core.h"
+
+/**
+ * The game history is a log of game summaries in the last pages of the
+ * flash, above the firmware image. The summaries are appended to the
+ * active page without erasing, the pages are used in turn, so every
+ * page is erased equally often. When the active page is full, the next
+ * page is activated, and the oldest page leaves the log: its summaries
+ * are folded into the per-map totals carried by the header of the new
+ * page, then it is erased by the history task. At boot only the page
+ * headers are read, and the end of the active page is found by a
+ * binary search.
+ *
+ * A page erase stalls the instruction fetches from the flash for about
+ * 20 ms, delaying every interrupt handler outside RAM, like the LCD frame
+ * counter and the UART receiver. The flash is therefore only written and
+ * erased between games: the game loop holds the next game while
+ * isHistoryBusy() returns true.
+ */
+
+// Project defines
+
+/**
+ * The number of flash pages of the history. One page is kept erased
+ * for the next activation, the others hold the stored summaries.
+ * efm32gg_history.ld reserves the pages at link time, keep them equal.
+ */
+#define HISTORY_PAGE_COUNT 		(4)
+
+#if HISTORY_PAGE_COUNT < 3
+#error "HISTORY_PAGE_COUNT must be at least 3"
+#endif
+
+/**
+ * The first word of the history pages, at the end of the flash.
+ */
+#define HISTORY_BASE 			((uint32_t *)(FLASH_BASE + FLASH_SIZE - HISTORY_PAGE_COUNT * FLASH_PAGE_SIZE))
+
+/**
+ * The identifier of the history page format, the first word of a page header.
+ */
+#define HISTORY_PAGE_MAGIC 		(0x54485331UL)
+
+/**
+ * The number of game summaries waiting for the history task. Must be
+ * a power of two, the queue indices are free running and masked on access.
+ */
+#define HISTORY_QUEUE_LENGTH 	(4)
+
+#if (HISTORY_QUEUE_LENGTH & (HISTORY_QUEUE_LENGTH - 1)) != 0
+#error "HISTORY_QUEUE_LENGTH must be a power of two"
+#endif
+
+/**
+ * The map index of the records sent as lost in a history message.
+ */
+#define HISTORY_LOST_RECORD 	(0xFF)
+
+/**
+ * @brief The summary of a finished game.
+ */
+typedef struct GameSummary {
+	uint32_t gameTicks;			/**< The number of game ticks the game lasted.	*/
+	uint16_t shotsTotal;		/**< The number of shots fired.					*/
+	uint16_t shotsMissed;		/**< The number of shots that missed.			*/
+	uint8_t  mapIndex;			/**< The index of the map played.				*/
+} GameSummary;
+
+/**
+ * @brief  A stored game summary, the word holding the checksum is
+ *         written last. Erased slots read all ones, a torn write
+ *         fails the checksum.
+ */
+typedef struct HistoryRecord {
+	uint32_t gameTicks;
+	uint16_t shotsTotal;
+	uint16_t shotsMissed;
+	uint8_t  mapIndex;
+	uint8_t  reserved;
+	uint16_t checksum;
+} HistoryRecord;
+
+/**
+ * @brief The totals of the games played on a map.
+ */
+typedef struct HistoryTotals {
+	uint32_t games;
+	uint32_t gameTicks;
+	uint32_t shotsTotal;
+	uint32_t shotsMissed;
+} HistoryTotals;
+
+/**
+ * @brief  The header at the start of every history page, written when
+ *         the page is activated. The checksum is written last, a torn
+ *         header makes the page invalid.
+ * @detail The sequence number is one larger on every activation, the
+ *         totals hold every game that left the log before.
+ */
+typedef struct HistoryPageHeader {
+	uint32_t magic;
+	uint32_t sequence;
+	HistoryTotals totals[PREDEFINED_MAP_COUNT];
+	uint32_t checksum;
+} HistoryPageHeader;
+
+/**
+ * The number of records in a history page.
+ */
+#define HISTORY_PAGE_RECORDS 	((FLASH_PAGE_SIZE - sizeof(HistoryPageHeader)) / sizeof(HistoryRecord))
+
+/**
+ * @brief The handle of the history task, notified when a summary is queued.
+ *        Unused in the co-routine build, see wakeHistory().
+ */
+TaskHandle_t historyTask;
+
+/**
+ * @brief The number of summaries lost because the queue was full or
+ *        the flash could not be written.
+ */
+volatile uint32_t historyDroppedCount;
+
+/**
+ * @brief  Loads the index of the history from the page headers.
+ * @detail Reads the header of every page and finds the end of the
+ *         active page, the stored records are not read. Pages left
+ *         over by a reset during an activation or an erase are
+ *         erased later by the history task.
+ */
+void initHistory(void);
+
+/**
+ * @brief  Queues the summary of a finished game for the history task.
+ * @detail Never waits for the flash, the summary is lost if the queue is full.
+ * @param  [in] The summary of the game.
+ */
+void storeGameSummary(const GameSummary *summary);
+
+/**
+ * @brief Wakes up the history task, or flags the history co-routine
+ *        in the co-routine build.
+ */
+void wakeHistory(void);
+
+/**
+ * @brief Appends the queued summaries, then erases the pages that left
+ *        the log. Called by the history task or co-routine.
+ */
+void serviceHistory(void);
+
+/**
+ * @brief  Returns whether the history has flash work left.
+ * @detail True from the boot until the stale pages are checked, and from
+ *         queuing a summary until it is written. The game loop does not
+ *         start the next game meanwhile, so the flash stalls fall
+ *         between games.
+ * @return True if the history task will write or erase the flash.
+ */
+bool isHistoryBusy(void);
+
+/**
+ * @brief  Sends the stored history over the UART.
+ * @detail Called by the statistics task, which owns the UART transmitter.
+ *         The message lists the sequence number of the active page, the
+ *         totals of every map, then the stored records from the oldest.
+ *         Records erased or torn while sending are sent as lost.
+ */
+void transmitHistory(void);
+
+/**
+ * @brief  The FreeRTOS task that writes the history to the flash.
+ * @detail Appends the queued summaries, activates the next page when
+ *         the active page is full, and erases the pages that left the
+ *         log. Runs at the lowest priority, between the games, see
+ *         isHistoryBusy().
+ * @param  [in] The FreeRTOS task parameter (unused).
+ */
+void prvHistoryTask(void *prvParam);
+
+#if configUSE_CO_ROUTINES
+/**
+ * @brief  The co-routine that writes the history in the co-routine build.
+ * @param  [in] The handle of the co-routine.
+ * @param  [in] The index of the co-routine (unused).
+ */
+void crHistory(CoRoutineHandle_t handle, UBaseType_t index);
+
+/**
+ * @brief  Returns whether the history co-routine has summaries to write.
+ * @return True if the co-routine was woken since its last run.
+ */
+bool isHistoryPending(void);
+#endif
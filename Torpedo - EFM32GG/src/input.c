@@ -1,4 +1,25 @@
 #include "input.h"
+#include "link.h"
+
+/**
+ * Maps every received character to its input state. Characters
+ * not assigned to an action map to None and are ignored.
+ */
+static const uint8_t inputActions[256] = {
+	[ACTION_LEFT]  = MoveLeft,
+	[ACTION_RIGHT] = MoveRight,
+	[ACTION_UP]    = MoveUp,
+	[ACTION_DOWN]  = MoveDown,
+	[ACTION_FIRE]  = Fire
+};
+
+/**
+ * The input ring. The head is only written by the UART interrupt,
+ * the tail is only written by the gameloop task.
+ */
+static InputEvent inputRing[INPUT_RING_LENGTH];
+static volatile uint32_t inputHead;
+static volatile uint32_t inputTail;
 
 void initInput() {
 
@@ -8,14 +29,17 @@ void initInput() {
 	// Enabling clock for GPIO
 	CMU_ClockEnable(cmuClock_GPIO, true);
 
+	// Keeping the baud-rate negotiated with the host
+	if(linkBaudrate == 0) linkBaudrate = LINK_DEFAULT_BAUDRATE;
+
 	// Initializing UART configuration
 	USART_InitAsync_TypeDef UARTInit = {
 		.autoCsEnable = false,
-		.baudrate = 115200,
+		.baudrate = linkBaudrate,
 		.databits = usartDatabits8,
 		.enable = usartEnable,
 		.mvdis = false,
-		.oversampling = usartOVS16,
+		.oversampling = linkOversampling(linkBaudrate),
 		.parity = usartNoParity,
 		.prsRxCh = usartPrsRxCh0,
 		.prsRxEnable = false,
@@ -25,7 +49,9 @@ void initInput() {
 
 	USART_InitAsync(UART0,&UARTInit);
 
-	// Enable UART0 interrupt vector in NVIC
+	// Enable UART0 interrupt vector in NVIC, the handler
+	// calls the kernel, so it must not be above the maximum syscall priority
+	NVIC_SetPriority(UART0_RX_IRQn, configMAX_SYSCALL_INTERRUPT_PRIORITY >> (8 - __NVIC_PRIO_BITS));
 	NVIC_ClearPendingIRQ(UART0_RX_IRQn);
 	NVIC_EnableIRQ(UART0_RX_IRQn);
 
@@ -42,28 +68,91 @@ void initInput() {
 	GPIO_PinModeSet(gpioPortE, 1, gpioModeInput, 0);    // RX
 	GPIO_PinModeSet(gpioPortF, 7, gpioModePushPull, 1); // Enabling to debugger
 
-	// Create input queue
-	inputQueue = xQueueCreate(1, sizeof(uint8_t));
+	// Discarding pending inputs
+	inputTail = inputHead;
+}
+
+bool readInput(InputEvent *event) {
+
+	uint32_t tail = inputTail;
+
+	// Checking for empty ring
+	if(tail == inputHead) {
+		return false;
+	}
+
+	// Reading the event before releasing its slot
+	__DMB();
+	*event = inputRing[tail & (INPUT_RING_LENGTH - 1)];
+	__DMB();
+	inputTail = tail + 1;
+
+	return true;
+}
+
+bool isInputPending(void) {
+	return inputTail != inputHead;
 }
 
 void UART0_RX_IRQHandler(void) {
 
+	traceISR_ENTER(UART0_RX_IRQn);
+
 	// Clearing interrupt flags
 	USART_IntClear(UART0,UART_IF_RXDATAV);
 
-	// Input state to queue
-	uint8_t inputState;
-
-	// Setting input state
-	switch(USART_RxDataGet(UART0)) {
-	case ACTION_LEFT: 	inputState = MoveLeft;  break;
-	case ACTION_RIGHT: 	inputState = MoveRight;	break;
-	case ACTION_UP: 	inputState = MoveUp; 	break;
-	case ACTION_DOWN: 	inputState = MoveDown;	break;
-	case ACTION_FIRE: 	inputState = Fire; 		break;
-	default:  			inputState = None;		break;
+	uint32_t head = inputHead;
+
+	BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+	// Draining every received character
+	while(USART_StatusGet(UART0) & USART_STATUS_RXDATAV) {
+
+		uint8_t data = USART_RxDataGet(UART0);
+
+		// Handling the command frames of the host
+		if(receiveCommandByteFromISR(data, &higherPriorityTaskWoken)) {
+			continue;
+		}
+
+#if configUSE_EVENT_TRACE
+		// Handling the trace dump command
+		if(data == COMMAND_TRACE_DUMP) {
+			if(requestTraceDumpFromISR()) higherPriorityTaskWoken = pdTRUE;
+			continue;
+		}
+#endif
+
+		// Decoding the character
+		uint8_t action = inputActions[data];
+
+		if(action == None) {
+			continue;
+		}
+
+		// Dropping the input if the ring is full
+		if(head - inputTail == INPUT_RING_LENGTH) {
+			inputDroppedCount++;
+			continue;
+		}
+
+		inputRing[head & (INPUT_RING_LENGTH - 1)] = (InputEvent){
+			.action = action
+		};
+		head++;
+	}
+
+	// Publishing the written events
+	__DMB();
+	bool written = head != inputHead;
+	inputHead = head;
+
+	// Waking up the task waiting for inputs
+	if(written && inputTask != NULL) {
+		vTaskNotifyGiveFromISR(inputTask, &higherPriorityTaskWoken);
 	}
 
-	// Placing input state into queue
-	xQueueSendFromISR(inputQueue, &inputState, NULL);
+	traceISR_EXIT(UART0_RX_IRQn);
+
+	portYIELD_FROM_ISR(higherPriorityTaskWoken);
 }
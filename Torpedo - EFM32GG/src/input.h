@@ -2,6 +2,7 @@
 
 // Standard includes
 #include <stdbool.h>
+#include <stdint.h>
 
 // Board includes
 #include <em_usart.h>
@@ -10,7 +11,10 @@
 
 // FreeRTOS includes
 #include "FreeRTOS.h"
-#include "queue.h"
+#include "task.h"
+
+// Project includes
+#include "game_core.h"
 
 
 /**
@@ -24,35 +28,81 @@
 #define ACTION_FIRE 	(' ')
 
 /**
- * Enumeration for the possible input states. The application either receives
- * no input (None), movement input (MoveX) or fire input (Fire). The input state
- * is set asynchronously via an UART_Rx interrupt, and processed by the main loop.
+ * The character requesting a dump of the event trace, only
+ * recognized when configUSE_EVENT_TRACE is enabled.
+ */
+#define COMMAND_TRACE_DUMP 	('t')
+
+/**
+ * The byte the host sends before its data to wake the board from EM2.
+ * It is lost or decoded as None, the UART only receives again after
+ * the wake-up.
+ */
+#define INPUT_WAKE_BYTE 	(0x00)
+
+/**
+ * The number of input events the input ring can hold. Must be a power
+ * of two, the ring indices are free running and masked on access.
+ */
+#define INPUT_RING_LENGTH 	(16)
+
+#if (INPUT_RING_LENGTH & (INPUT_RING_LENGTH - 1)) != 0
+#error "INPUT_RING_LENGTH must be a power of two"
+#endif
+
+/**
+ * A single user input: the decoded action.
  */
-typedef enum {None, MoveLeft, MoveRight, MoveUp, MoveDown, Fire} InputStates;
+typedef struct {
+	uint8_t action;
+} InputEvent;
 
 /**
- * Handle to the input queue used to store the current user input.
- * The value is produced by the UART_RX interrupt and consumed by
- * the gameloop task.
+ * The number of inputs dropped because the input ring was full.
  */
-QueueHandle_t inputQueue;
+volatile uint32_t inputDroppedCount;
+
+/**
+ * The task notified when new inputs are placed into the input ring.
+ */
+TaskHandle_t inputTask;
 
 /**
  * @brief  Initializes the UART used for user input.
- * @detail The specified configuration:
- * 		   - Baudrate:     115200
+ * @detail Inputs received before the call are discarded, so
+ *         keys typed between games do not leak into the next one.
+ *         The specified configuration:
+ * 		   - Baudrate:     115200, or the rate negotiated with the host
  * 		   - Data bits:    8
- *		   - Oversampling: 16
+ *		   - Oversampling: 16, or 8 above 230400 baud
  *		   - Parity bits:  0
  *		   - Stop bits:    1
  *		   - Asynchronous mode.
  */
 void initInput();
 
+/**
+ * @brief  Takes the oldest input event from the input ring.
+ * @detail The input ring is a lock-free single producer, single
+ *         consumer ring: the UART interrupt is the only producer
+ *         and the gameloop task is the only consumer.
+ * @param  [out] The oldest input event.
+ * @return True if an event was read, false if the ring is empty.
+ */
+bool readInput(InputEvent *event);
+
+/**
+ * @brief  Returns whether the input ring holds unread inputs.
+ * @return True if readInput() would return an input.
+ */
+bool isInputPending(void);
+
 /**
  * @brief  The interrupt request handler of the UART.
  * @detail This function is called every time the UART
  *         receives data. This function does NOT handle
- *         the event, only sets the global input state.
+ *         the event, only decodes the received keys and
+ *         places them into the input ring. Host command
+ *         frames are passed to the link module.
  */
 void UART0_RX_IRQHandler(void);
@@ -0,0 +1,241 @@
+#include "link.h"
+#include "statistics.h"
+#include "history.h"
+
+/**
+ * The length of each command frame in bytes, without COMMAND_START.
+ */
+static const uint8_t commandLengths[] = {
+	[CommandSetTickPeriod]   = 1 + 1,
+	[CommandProposeBaudrate] = 1 + 4,
+	[CommandEcho]            = 1 + 1,
+	[CommandAttach]          = 1,
+	[CommandDetach]          = 1,
+	[CommandReadHistory]     = 1
+};
+
+/**
+ * The baud-rates the board accepts.
+ */
+static const uint32_t supportedBaudrates[] = {
+	115200, 230400, 460800, 921600
+};
+
+/**
+ * The command frame being received by the UART interrupt.
+ */
+static uint8_t commandBuffer[1 + 4];
+static uint8_t commandLength;
+static bool commandActive;
+
+/**
+ * The requests passed from the UART interrupt to the statistics task.
+ */
+static volatile uint32_t proposedBaudrate;
+static volatile bool echoPending;
+static volatile uint8_t echoValue;
+static volatile bool historyRequested;
+
+/**
+ * The presence of the host: set by the attach command, cleared by the
+ * detach command, the tick of the last attach command, and the flag
+ * requesting the flush of the messages stored while the host was away.
+ */
+static volatile bool hostAttached;
+static volatile TickType_t hostSeenTick;
+static volatile bool backlogPending;
+
+/**
+ * The verification of a new baud-rate: set while the echo of the host
+ * is awaited, with the rate to fall back to and the tick of the switch.
+ */
+static bool verifyActive;
+static uint32_t verifyPreviousBaudrate;
+static TickType_t verifyStartTick;
+
+USART_OVS_TypeDef linkOversampling(uint32_t baudrate) {
+	return baudrate <= 230400 ? usartOVS16 : usartOVS8;
+}
+
+/**
+ * @brief  Returns whether the host is attached at the specified tick.
+ * @param  [in] The current tick.
+ * @return True if the host is attached.
+ */
+static bool hostAttachedAt(TickType_t now) {
+	return hostAttached && now - hostSeenTick < pdMS_TO_TICKS(LINK_HOST_TIMEOUT_MS);
+}
+
+bool isHostAttached(void) {
+	return hostAttachedAt(xTaskGetTickCount()) && !backlogPending;
+}
+
+bool waitForLinkTransmitter(void) {
+
+	// Bounding the wait, a reset or disabled transmitter never completes
+	TickType_t start = xTaskGetTickCount();
+	while(!(USART_StatusGet(UART0) & USART_STATUS_TXC)) {
+		if(xTaskGetTickCount() - start >= pdMS_TO_TICKS(LINK_TX_TIMEOUT_MS)) return false;
+	}
+
+	return true;
+}
+
+bool receiveCommandByteFromISR(uint8_t data, BaseType_t *higherPriorityTaskWoken) {
+
+	// Waiting for the start of a frame
+	if(!commandActive) {
+		if(data != COMMAND_START) return false;
+
+		commandActive = true;
+		commandLength = 0;
+		return true;
+	}
+
+	commandBuffer[commandLength++] = data;
+
+	// Dropping unknown commands
+	if(commandBuffer[0] == 0 || commandBuffer[0] > CommandReadHistory) {
+		commandActive = false;
+		return true;
+	}
+
+	// Waiting for the rest of the frame
+	if(commandLength < commandLengths[commandBuffer[0]]) return true;
+
+	commandActive = false;
+
+	switch(commandBuffer[0]) {
+	case CommandSetTickPeriod:
+		requestedTickPeriodMs = commandBuffer[1];
+		return true;
+
+	case CommandProposeBaudrate:
+		proposedBaudrate = (uint32_t)commandBuffer[1]       | (uint32_t)commandBuffer[2] << 8 |
+						   (uint32_t)commandBuffer[3] << 16 | (uint32_t)commandBuffer[4] << 24;
+		break;
+
+	case CommandEcho:
+		echoValue = commandBuffer[1];
+		echoPending = true;
+		break;
+
+	case CommandAttach: {
+		// Flushing the stored messages if the host was away
+		TickType_t now = xTaskGetTickCountFromISR();
+		if(!hostAttachedAt(now)) backlogPending = true;
+
+		hostSeenTick = now;
+		hostAttached = true;
+		break;
+	}
+
+	case CommandDetach:
+		hostAttached = false;
+		return true;
+
+	case CommandReadHistory:
+		historyRequested = true;
+		break;
+	}
+
+	// Waking up the statistics task to answer
+	wakeStatisticsFromISR(higherPriorityTaskWoken);
+
+	return true;
+}
+
+/**
+ * @brief Switches the UART to the specified baud-rate.
+ * @param [in] The new baud-rate.
+ */
+static void switchBaudrate(uint32_t baudrate) {
+
+	// Waiting for the last byte to leave the shift register
+	waitForLinkTransmitter();
+
+	taskENTER_CRITICAL();
+	USART_BaudrateAsyncSet(UART0, 0, baudrate, linkOversampling(baudrate));
+	linkBaudrate = baudrate;
+
+	// Discarding what was received at the previous rate, including an echo
+	// of an earlier attempt, only an echo received after the switch verifies it
+	while(USART_StatusGet(UART0) & USART_STATUS_RXDATAV) {
+		USART_RxDataGet(UART0);
+	}
+	commandActive = false;
+	echoPending = false;
+	taskEXIT_CRITICAL();
+}
+
+TickType_t linkServiceDelay(void) {
+	if(!verifyActive) return portMAX_DELAY;
+
+	TickType_t elapsed = xTaskGetTickCount() - verifyStartTick;
+	return elapsed < pdMS_TO_TICKS(LINK_VERIFY_TIMEOUT_MS) ? pdMS_TO_TICKS(LINK_VERIFY_TIMEOUT_MS) - elapsed : 0;
+}
+
+bool serviceLink(void) {
+
+	// Finishing the verification of a new baud-rate first
+	if(verifyActive) {
+		if(!echoPending && linkServiceDelay() > 0) return false;
+		verifyActive = false;
+
+		if(echoPending) {
+
+			// Confirming the new rate
+			echoPending = false;
+			sendEchoMessage(echoValue);
+		} else {
+
+			// Falling back to the previous rate
+			switchBaudrate(verifyPreviousBaudrate);
+		}
+	}
+
+	// Flushing the messages stored while the host was away
+	if(backlogPending) {
+		backlogPending = false;
+		transmitBacklog();
+	}
+
+	// Sending the game history on request of the host
+	if(historyRequested) {
+		historyRequested = false;
+		transmitHistory();
+	}
+
+	// Answering a ping of the host
+	if(echoPending) {
+		echoPending = false;
+		sendEchoMessage(echoValue);
+	}
+
+	if(proposedBaudrate == 0) return true;
+
+	uint32_t baudrate = proposedBaudrate;
+	proposedBaudrate = 0;
+
+	// Checking the proposed rate
+	bool accepted = false;
+	for(uint8_t i = 0; i < sizeof(supportedBaudrates) / sizeof(supportedBaudrates[0]); i++) {
+		accepted = accepted || supportedBaudrates[i] == baudrate;
+	}
+
+	// Acknowledging at the current rate
+	sendBaudrateAckMessage(baudrate, accepted);
+	transmitStatistics();
+
+	if(!accepted) return true;
+
+	// Switching, then waiting for the echo of the host at the new rate
+	// without blocking, the idle task runs this in the co-routine build
+	verifyPreviousBaudrate = linkBaudrate;
+	switchBaudrate(baudrate);
+
+	verifyStartTick = xTaskGetTickCount();
+	verifyActive = true;
+
+	return false;
+}
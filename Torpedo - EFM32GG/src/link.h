@@ -0,0 +1,126 @@
+#pragma once
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Board includes
+#include <em_usart.h>
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Project defines
+
+/**
+ * The byte starting a command frame from the host. It never occurs
+ * in UTF-8 text, so it cannot be typed as a game key.
+ */
+#define COMMAND_START 				(0xFF)
+
+/**
+ * The baud-rate of the UART after reset.
+ */
+#define LINK_DEFAULT_BAUDRATE 		(115200)
+
+/**
+ * The time the host has to verify a new baud-rate with an echo,
+ * before the board falls back to the previous one.
+ */
+#define LINK_VERIFY_TIMEOUT_MS 		(500)
+
+/**
+ * The time the transmitter has to send its last bytes, longer than two
+ * frames at the slowest baud-rate. It does not complete if it was reset
+ * or disabled.
+ */
+#define LINK_TX_TIMEOUT_MS 			(2)
+
+/**
+ * The time the host is considered attached after its last attach
+ * command. The host repeats the command as a heartbeat, the messages
+ * are stored while it is away, and flushed when it attaches again.
+ */
+#define LINK_HOST_TIMEOUT_MS 		(3000)
+
+/**
+ * @brief  Describes the commands the host can send.
+ * @detail A command frame is COMMAND_START, the command identifier
+ *         and the fields below, multi-byte fields are little-endian.
+ */
+typedef enum CommandType {
+	CommandSetTickPeriod = 1,	/**< uint8_t tick period in milliseconds, applied by the game loop.	*/
+	CommandProposeBaudrate,		/**< uint32_t baud-rate, acknowledged then switched to.				*/
+	CommandEcho,				/**< uint8_t value, sent back in an echo message.					*/
+	CommandAttach,				/**< No fields, the host is present, repeated as a heartbeat.		*/
+	CommandDetach,				/**< No fields, the host leaves, messages are stored from now on.	*/
+	CommandReadHistory			/**< No fields, the game history is sent in a history message.		*/
+} CommandType;
+
+/**
+ * The tick period requested by the host in milliseconds, or 0.
+ */
+volatile uint8_t requestedTickPeriodMs;
+
+/**
+ * The current baud-rate of the UART.
+ */
+uint32_t linkBaudrate;
+
+/**
+ * @brief  Returns the oversampling used for the specified baud-rate.
+ * @detail Rates above 230400 baud cannot be generated accurately
+ *         from the 14 MHz peripheral clock with 16x oversampling.
+ * @param  [in] The baud-rate.
+ * @return The oversampling setting of the UART.
+ */
+USART_OVS_TypeDef linkOversampling(uint32_t baudrate);
+
+/**
+ * @brief  Waits until the last byte has left the UART transmitter.
+ * @detail Gives up after LINK_TX_TIMEOUT_MS.
+ * @return True if the transmission completed.
+ */
+bool waitForLinkTransmitter(void);
+
+/**
+ * @brief  Processes one received byte of a host command.
+ * @detail Called by the UART interrupt for every received byte.
+ * @param  [in] The received byte.
+ * @param  [out] Set to pdTRUE if the statistics task should run next.
+ * @return True if the byte belongs to a command frame and should
+ *         not be processed as user input.
+ */
+bool receiveCommandByteFromISR(uint8_t data, BaseType_t *higherPriorityTaskWoken);
+
+/**
+ * @brief  Returns whether the host is attached.
+ * @detail The host is attached by its attach command, and detached by
+ *         its detach command, or LINK_HOST_TIMEOUT_MS after its last
+ *         attach command.
+ * @return True if the messages are transmitted, false if they are stored.
+ */
+bool isHostAttached(void);
+
+/**
+ * @brief  Answers the pending attach, history, echo and baud-rate commands.
+ * @detail Called by the statistics task, which owns the UART transmitter.
+ *         When the host attaches, the messages stored while it was away
+ *         are flushed first.
+ *         A proposed baud-rate is acknowledged at the current rate, then
+ *         the UART is switched and the host has to send an echo at the new
+ *         rate, the bytes received before the switch are discarded. Without an echo in LINK_VERIFY_TIMEOUT_MS the previous rate
+ *         is restored. The echo is not waited for here, the caller calls
+ *         again when woken, or after linkServiceDelay() ticks.
+ * @return False while a new baud-rate is verified, the buffered messages
+ *         are then held back.
+ */
+bool serviceLink(void);
+
+/**
+ * @brief  Returns the time until serviceLink() has to be called again.
+ * @return The ticks until the verification of a new baud-rate times out,
+ *         or portMAX_DELAY if no baud-rate is being verified.
+ */
+TickType_t linkServiceDelay(void);
@@ -0,0 +1,160 @@
+#include "low_power.h"
+
+#if configUSE_TICKLESS_IDLE == 2
+
+/**
+ * The UART RX pin, armed as a wake-up source while sleeping.
+ */
+#define WAKE_PORT 	(gpioPortE)
+#define WAKE_PIN 	(1)
+
+/**
+ * The sleeps since the last report, only written by the idle task.
+ */
+static IdleStatistics idleStatistics;
+
+void initLowPower(void) {
+
+	// Enabling the clock of the RTC, LFA is already running for the LCD
+	CMU_ClockEnable(cmuClock_CORELE, true);
+	CMU_ClockEnable(cmuClock_RTC, true);
+
+	// Starting the RTC, it counts freely and only COMP0 is set before a sleep
+	RTC->CTRL = RTC_CTRL_EN;
+	while(RTC->SYNCBUSY & RTC_SYNCBUSY_CTRL);
+	RTC->IFC = RTC_IF_COMP0;
+	RTC->IEN = RTC_IEN_COMP0;
+
+	// Enabling the wake-up interrupts, both only wake the core
+	NVIC_ClearPendingIRQ(RTC_IRQn);
+	NVIC_EnableIRQ(RTC_IRQn);
+	NVIC_ClearPendingIRQ(GPIO_ODD_IRQn);
+	NVIC_EnableIRQ(GPIO_ODD_IRQn);
+}
+
+void takeIdleStatistics(IdleStatistics *statistics) {
+	taskENTER_CRITICAL();
+	*statistics = idleStatistics;
+	idleStatistics = (IdleStatistics){0};
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief  Returns the RTC counts elapsed since a reading of the counter.
+ * @param  [in] The earlier reading of the counter.
+ * @return The counts elapsed, the counter wraps around at 24 bits.
+ */
+static uint32_t countsSince(uint32_t start) {
+	return (RTC->CNT - start) & SLEEP_TIMER_MAX_COUNTS;
+}
+
+/**
+ * @brief  Returns whether a co-routine has work flagged.
+ * @detail The kernel only knows about the tasks, the flags polled by the
+ *         co-routines can be set by an interrupt after the idle hook ran.
+ * @return True if the idle task must not sleep.
+ */
+static bool isCoRoutineWorkPending(void) {
+#if configUSE_CO_ROUTINES
+	return isGraphicsPending() || isStatisticsPending() || isHistoryPending();
+#else
+	return false;
+#endif
+}
+
+void vPortSuppressTicksAndSleep(TickType_t expectedIdleTime) {
+
+	// Limiting the sleep to half the range of the RTC, so the counts slept never wrap around
+	TickType_t maxTicks = maxSuppressedTicks(configTICK_RATE_HZ, SLEEP_TIMER_HZ, SLEEP_TIMER_MAX_COUNTS / 2);
+	if(expectedIdleTime > maxTicks) expectedIdleTime = maxTicks;
+
+	// Stopping the SysTick, keeping the time elapsed in the current tick,
+	// the sleep is measured from this reading of the RTC
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	uint32_t start = RTC->CNT;
+	uint32_t cyclesPerTick = SysTick->LOAD + 1;
+	uint32_t elapsedUnits = (uint64_t)(SysTick->LOAD - SysTick->VAL) * SLEEP_TIMER_HZ / cyclesPerTick;
+
+	// Waking up at the last tick boundary before the expected wake-up,
+	// the SysTick interrupt then unblocks the task on time
+	uint32_t counts = sleepCountsUntilTick(expectedIdleTime - 1, elapsedUnits, configTICK_RATE_HZ, SLEEP_TIMER_HZ);
+
+	// Masking interrupts without BASEPRI, so they still end the sleep
+	__disable_irq();
+	__DSB();
+	__ISB();
+
+	// Restarting the SysTick where it stopped if a task or a co-routine is ready anyway, or if
+	// the boundary is closer than the synchronization of COMP0 into the RTC clock domain
+	if(counts < SLEEP_TIMER_MIN_COUNTS || isCoRoutineWorkPending() || eTaskConfirmSleepModeStatus() == eAbortSleep) {
+		SysTick->LOAD = SysTick->VAL;
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		SysTick->LOAD = cyclesPerTick - 1;
+		__enable_irq();
+		return;
+	}
+
+	// Setting the wake-up on the running RTC, the synchronization is counted in the sleep
+	RTC->COMP0 = (start + counts) & SLEEP_TIMER_MAX_COUNTS;
+	while(RTC->SYNCBUSY & RTC_SYNCBUSY_COMP0);
+	RTC->IFC = RTC_IF_COMP0;
+	NVIC_ClearPendingIRQ(RTC_IRQn);
+
+	// Sleeping only if the boundary was not passed during the synchronization
+	if(countsSince(start) < counts) {
+
+		// Arming the RX pin, the UART cannot receive in EM2
+		GPIO_IntConfig(WAKE_PORT, WAKE_PIN, false, true, true);
+
+#if LOW_POWER_DEEP_SLEEP
+		SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+#endif
+
+		// Sleeping until the RTC or any other interrupt
+		__DSB();
+		__WFI();
+		__ISB();
+
+		SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+		// Disarming the RX pin
+		GPIO_IntConfig(WAKE_PORT, WAKE_PIN, false, true, false);
+	}
+
+	// Reading the time since the SysTick stopped
+	uint32_t slept = countsSince(start);
+
+	// Stepping the kernel tick by the complete ticks slept
+	uint32_t remainingUnits;
+	TickType_t ticks = sleptTicks(slept, elapsedUnits, configTICK_RATE_HZ, SLEEP_TIMER_HZ, &remainingUnits);
+	if(ticks > expectedIdleTime - 1) {
+		ticks = expectedIdleTime - 1;
+		remainingUnits = 0;
+	}
+	vTaskStepTick(ticks);
+
+	// Restarting the SysTick with the rest of the current tick
+	uint32_t remainingCycles = cyclesPerTick - (uint64_t)remainingUnits * cyclesPerTick / SLEEP_TIMER_HZ;
+	SysTick->LOAD = remainingCycles - 1;
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+	SysTick->LOAD = cyclesPerTick - 1;
+
+	// Accounting the sleep
+	idleStatistics.sleepCount++;
+	idleStatistics.expectedIdleTicks += expectedIdleTime;
+	idleStatistics.actualIdleTicks += ticks;
+
+	// Letting the interrupt that ended the sleep run
+	__enable_irq();
+}
+
+void RTC_IRQHandler(void) {
+	RTC->IFC = RTC_IF_COMP0;
+}
+
+void GPIO_ODD_IRQHandler(void) {
+	GPIO_IntClear(1 << WAKE_PIN);
+}
+
+#endif
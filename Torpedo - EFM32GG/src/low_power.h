@@ -0,0 +1,96 @@
+#pragma once
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Board includes
+#include <em_device.h>
+#include <em_cmu.h>
+#include <em_gpio.h>
+#include <em_usart.h>
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Project includes
+#include "tick_suppression.h"
+#include "graphics.h"
+#include "statistics.h"
+#include "history.h"
+
+// Project defines
+
+/**
+ * The frequency of the sleep timer, the RTC running from the
+ * LFRCO that also clocks the LCD.
+ */
+#define SLEEP_TIMER_HZ 				(32768)
+
+/**
+ * The largest value of the 24-bit RTC counter.
+ */
+#define SLEEP_TIMER_MAX_COUNTS 		(0xFFFFFF)
+
+/**
+ * The shortest sleep in RTC counts. Writing COMP0 takes up to three
+ * cycles of the RTC clock to synchronize, a closer match may be missed.
+ */
+#define SLEEP_TIMER_MIN_COUNTS 		(4)
+
+/**
+ * The idle task sleeps in EM2 unless a build needs a high frequency
+ * clock while idle: TIMER1 counts the run time in the runtime-stats
+ * build, and the DWT cycle counter timestamps the event trace.
+ */
+#define LOW_POWER_DEEP_SLEEP 		(!configGENERATE_RUN_TIME_STATS && !configUSE_EVENT_TRACE)
+
+/**
+ * @brief Describes the sleeps of the idle task since the last report.
+ */
+typedef struct IdleStatistics {
+	uint32_t sleepCount;		/**< The number of sleeps.									*/
+	uint32_t expectedIdleTicks;	/**< The sum of the idle times expected by the kernel.		*/
+	uint32_t actualIdleTicks;	/**< The sum of the time actually slept, in ticks.			*/
+} IdleStatistics;
+
+/**
+ * @brief  Initializes the sleep timer of the tickless idle.
+ * @detail The RTC is clocked from LFA, which the LCD driver sets to
+ *         the LFRCO, so initDisplay() must be called first.
+ */
+void initLowPower(void);
+
+/**
+ * @brief Copies the idle statistics and starts a new period.
+ * @param [out] The statistics since the last call.
+ */
+void takeIdleStatistics(IdleStatistics *statistics);
+
+/**
+ * @brief  Suppresses the kernel tick and sleeps until the next
+ *         task unblocks or an interrupt arrives.
+ * @detail Called by the idle task with the scheduler suspended. The
+ *         SysTick is stopped, COMP0 of the free running RTC is set to
+ *         the last tick boundary before the expected wake-up, and the core sleeps in EM2 with
+ *         the UART RX pin armed as a wake-up source. The kernel tick
+ *         is then stepped by the complete ticks measured by the RTC.
+ *         In the co-routine build the sleep is skipped if an interrupt
+ *         flagged work for a co-routine after the idle hook ran.
+ * @param  [in] The number of ticks until the next task unblocks.
+ */
+void vPortSuppressTicksAndSleep(TickType_t expectedIdleTime);
+
+/**
+ * @brief Interrupt handler of the sleep timer, only wakes the core.
+ */
+void RTC_IRQHandler(void);
+
+/**
+ * @brief  Interrupt handler of the odd GPIO pins, only wakes the core.
+ * @detail The UART cannot receive in EM2, the falling edge of the start
+ *         bit on the RX pin wakes the core instead. The byte during the
+ *         wake-up is lost, so the host sends a wake byte first.
+ */
+void GPIO_ODD_IRQHandler(void);
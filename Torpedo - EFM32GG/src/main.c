@@ -10,6 +10,17 @@
 #include "game_logic.h"
 #include "statistics.h"
 #include "graphics.h"
+#include "runtime_stats.h"
+#include "event_trace.h"
+#include "low_power.h"
+#include "history.h"
+
+// Project defines
+
+/**
+ * The number of co-routines in the co-routine build.
+ */
+#define CO_ROUTINE_COUNT 	(3)
 
 
 int main(void)
@@ -17,18 +28,75 @@ int main(void)
 	// Chip errata
 	CHIP_Init();
 
+#if configUSE_EVENT_TRACE
+	// Starting the trace timestamp counter
+	initEventTrace();
+#endif
+
 	// Initializing dependencies
 	initDisplay();
 	initInput();
+	initGameLogic();
+
+	// Loading the index of the game history
+	initHistory();
+
+#if configUSE_TICKLESS_IDLE == 2
+	// Starting the sleep timer of the tickless idle
+	initLowPower();
+#endif
+
+#if configGENERATE_RUN_TIME_STATS
+	// Reporting task statistics in the runtime-stats build
+	initRuntimeStats();
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION
+	// Storage of the application tasks
+	static StackType_t gameloopStack[configMINIMAL_STACK_SIZE];
+	static StackType_t graphicsStack[configMINIMAL_STACK_SIZE];
+	static StackType_t statisticsStack[configMINIMAL_STACK_SIZE];
+	static StackType_t historyStack[configMINIMAL_STACK_SIZE];
+	static StaticTask_t gameloopTCB;
+	static StaticTask_t graphicsTCB;
+	static StaticTask_t statisticsTCB;
+	static StaticTask_t historyTCB;
+
+	// Creating the gameplay task
+	inputTask = xTaskCreateStatic(prvGameloopTask, "GAMELOOP", configMINIMAL_STACK_SIZE, NULL, 20,
+								  gameloopStack, &gameloopTCB);
+
+	// Creating the graphics task
+	graphicsTask = xTaskCreateStatic(prvGraphicsTask, "DISPLAY", configMINIMAL_STACK_SIZE, NULL, 10,
+									 graphicsStack, &graphicsTCB);
+
+	// Creating the statistics task
+	statisticsTask = xTaskCreateStatic(prvStatisticsTask, "STATISTICS", configMINIMAL_STACK_SIZE, NULL, 30,
+									   statisticsStack, &statisticsTCB);
 
+	// Creating the history task below the others, the flash is written in the background
+	historyTask = xTaskCreateStatic(prvHistoryTask, "HISTORY", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1,
+									historyStack, &historyTCB);
+#else
 	// Creating the gameplay task
-	xTaskCreate(prvGameloopTask, "GAMELOOP", configMINIMAL_STACK_SIZE, NULL, 20, NULL);
+	xTaskCreate(prvGameloopTask, "GAMELOOP", configMINIMAL_STACK_SIZE, NULL, 20, &inputTask);
 
+#if configUSE_CO_ROUTINES
+	// Creating the graphics, statistics and history co-routines, sharing the idle task stack
+	xCoRoutineCreate(crGraphics, 0, 0);
+	xCoRoutineCreate(crStatistics, 0, 0);
+	xCoRoutineCreate(crHistory, 0, 0);
+#else
 	// Creating the graphics task
-	xTaskCreate(prvGraphicsTask, "DISPLAY", configMINIMAL_STACK_SIZE, NULL, 10, NULL);
+	xTaskCreate(prvGraphicsTask, "DISPLAY", configMINIMAL_STACK_SIZE, NULL, 10, &graphicsTask);
 
 	// Creating the statistics task
-	xTaskCreate(prvStatisticsTask, "STATISTICS", configMINIMAL_STACK_SIZE, NULL, 30, NULL);
+	xTaskCreate(prvStatisticsTask, "STATISTICS", configMINIMAL_STACK_SIZE, NULL, 30, &statisticsTask);
+
+	// Creating the history task below the others, the flash is written in the background
+	xTaskCreate(prvHistoryTask, "HISTORY", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, &historyTask);
+#endif
+#endif
 
 	// Starting the FreeRTOS scheduler
 	vTaskStartScheduler();
@@ -36,3 +104,65 @@ int main(void)
 	// Suppressing compiler warnings
 	return 0;
 }
+
+#if configUSE_CO_ROUTINES
+
+/**
+ * @brief  Schedules the co-routines from the idle task.
+ * @detail Every co-routine gets a turn before the idle task may
+ *         suppress the tick and sleep, so work flagged by a task or
+ *         an interrupt is done before the board goes to sleep. Work
+ *         flagged after this hook returns aborts the sleep instead.
+ */
+void vApplicationIdleHook(void)
+{
+	for(uint8_t i = 0; i < CO_ROUTINE_COUNT; i++) {
+		vCoRoutineSchedule();
+	}
+}
+
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION
+
+/**
+ * @brief Provides the storage of the idle task in the zero-heap build.
+ * @param [out] The TCB of the idle task.
+ * @param [out] The stack of the idle task.
+ * @param [out] The stack size in words.
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer,
+								   StackType_t **ppxIdleTaskStackBuffer,
+								   uint32_t *pulIdleTaskStackSize)
+{
+	static StackType_t idleStack[configMINIMAL_STACK_SIZE];
+	static StaticTask_t idleTCB;
+
+	*ppxIdleTaskTCBBuffer   = &idleTCB;
+	*ppxIdleTaskStackBuffer = idleStack;
+	*pulIdleTaskStackSize   = configMINIMAL_STACK_SIZE;
+}
+
+#if configUSE_TIMERS
+
+/**
+ * @brief Provides the storage of the timer task in the zero-heap build.
+ * @param [out] The TCB of the timer task.
+ * @param [out] The stack of the timer task.
+ * @param [out] The stack size in words.
+ */
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer,
+									StackType_t **ppxTimerTaskStackBuffer,
+									uint32_t *pulTimerTaskStackSize)
+{
+	static StackType_t timerStack[configTIMER_TASK_STACK_DEPTH];
+	static StaticTask_t timerTCB;
+
+	*ppxTimerTaskTCBBuffer   = &timerTCB;
+	*ppxTimerTaskStackBuffer = timerStack;
+	*pulTimerTaskStackSize   = configTIMER_TASK_STACK_DEPTH;
+}
+
+#endif
+
+#endif
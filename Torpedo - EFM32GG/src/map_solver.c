@@ -0,0 +1,85 @@
+#include "map_solver.h"
+
+uint16_t segmentMaps[LCD_SEGMENTS_COUNT];
+
+uint16_t shotMasks[LCD_SEGMENTS_COUNT];
+SegmentId shotSegments[LCD_SEGMENTS_COUNT];
+SegmentId shotCount;
+
+/**
+ * The memoized expected misses of each candidate set, negative if not solved yet.
+ */
+static double missTable[CANDIDATE_SET_COUNT];
+
+void initMapSolver(void) {
+
+	// Indexing the ship segments of the maps
+	for(SegmentId i = 0; i < LCD_SEGMENTS_COUNT; i++) {
+		segmentMaps[i] = 0;
+	}
+	for(uint8_t map = 0; map < PREDEFINED_MAP_COUNT; map++) {
+		for(uint8_t i = 0; i < SHIP_SEGMENTS_COUNT; i++) {
+			segmentMaps[predefinedMaps[map][i]] |= 1U << map;
+		}
+	}
+
+	// Collecting the distinct ways a shot splits the maps
+	shotCount = 0;
+	for(SegmentId i = 0; i < LCD_SEGMENTS_COUNT; i++) {
+		SegmentId n = 0;
+		while(n < shotCount && shotMasks[n] != segmentMaps[i]) n++;
+		if(segmentMaps[i] == 0 || n < shotCount) continue;
+
+		shotMasks[shotCount] = segmentMaps[i];
+		shotSegments[shotCount] = i;
+		shotCount++;
+	}
+
+	// Marking every candidate set unsolved, a single map is finished without misses
+	for(uint32_t candidates = 0; candidates < CANDIDATE_SET_COUNT; candidates++) {
+		missTable[candidates] = __builtin_popcount(candidates) <= 1 ? 0 : -1.0;
+	}
+}
+
+double expectedMisses(uint16_t candidates) {
+
+	if(missTable[candidates] >= 0) return missTable[candidates];
+
+	// Searching the shot with the fewest expected misses
+	double best = -1;
+	for(SegmentId i = 0; i < shotCount; i++) {
+
+		// Skipping the shots not splitting the candidates
+		uint16_t ships = shotMasks[i] & candidates;
+		if(ships == 0 || ships == candidates) continue;
+
+		double misses = expectedMissesAfterShot(candidates, ships);
+		if(best < 0 || misses < best) best = misses;
+	}
+
+	// Distinct maps always differ in a segment
+	missTable[candidates] = best;
+	return best;
+}
+
+double expectedMissesAfterShot(uint16_t candidates, uint16_t ships) {
+
+	ships &= candidates;
+	double hitChance = (double) __builtin_popcount(ships) / __builtin_popcount(candidates);
+
+	return hitChance * expectedMisses(ships) + (1 - hitChance) * (1 + expectedMisses(candidates & ~ships));
+}
+
+SegmentId optimalShot(uint16_t candidates) {
+
+	// Taking the first shot with the fewest expected misses
+	double best = expectedMisses(candidates);
+	for(SegmentId i = 0; i < shotCount; i++) {
+		uint16_t ships = shotMasks[i] & candidates;
+		if(ships == 0 || ships == candidates) continue;
+
+		if(expectedMissesAfterShot(candidates, ships) <= best + MISSES_EPSILON) return shotSegments[i];
+	}
+
+	return CURSOR_HIDDEN;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+// Standard includes
+#include <stdint.h>
+
+// Project includes
+#include "game_core.h"
+
+/**
+ * The exact expectimax solution of the optimal play over the predefined
+ * maps, shared by the host client and the simulator. It is kept next to
+ * the core for its map definitions, but the firmware does not link it:
+ * the memoized solutions take 512 KB.
+ */
+
+// Project defines
+
+/**
+ * The bitset of every predefined map, and the number of candidate map sets.
+ */
+#define ALL_CANDIDATE_MAPS 		((uint16_t)((1UL << PREDEFINED_MAP_COUNT) - 1))
+#define CANDIDATE_SET_COUNT 	(1UL << PREDEFINED_MAP_COUNT)
+
+/**
+ * The tolerance of comparing expected misses, the sums of the
+ * branches may differ in the last bits.
+ */
+#define MISSES_EPSILON 			(1e-9)
+
+/**
+ * Inverted index of the predefined maps: the bitset of the maps
+ * holding a ship on each segment.
+ */
+extern uint16_t segmentMaps[LCD_SEGMENTS_COUNT];
+
+/**
+ * The distinct ways a shot splits the maps: the distinct bitsets of
+ * segmentMaps, with the lowest segment of each, in increasing segment
+ * order. Segments of the same bitset split every candidate set the
+ * same way, so only one of them is searched.
+ */
+extern uint16_t shotMasks[LCD_SEGMENTS_COUNT];
+extern SegmentId shotSegments[LCD_SEGMENTS_COUNT];
+extern SegmentId shotCount;
+
+/**
+ * @brief Builds the inverted index of the predefined maps and forgets
+ *        the solved candidate sets, must be called first.
+ */
+void initMapSolver(void);
+
+/**
+ * @brief  Returns the expected number of misses before the map is identified
+ *         under optimal play, with every candidate map equally likely.
+ * @detail Every game takes SHIP_SEGMENTS_COUNT hits, only the number of
+ *         misses depends on the play. The hits of a game are the segments
+ *         common to all of its candidate maps, so the candidate set alone
+ *         is the state of the search. The best split is searched recursively
+ *         and memoized per candidate set. Solving the sets in increasing
+ *         size makes every call a lookup of smaller sets, so the sets of
+ *         one size can be solved by several threads.
+ * @param  [in] The bitset of the candidate maps.
+ * @return The expected number of misses, 0 for a single candidate.
+ */
+double expectedMisses(uint16_t candidates);
+
+/**
+ * @brief  Returns the expected number of misses after a shot, under optimal play.
+ * @param  [in] The bitset of the candidate maps, at least two maps.
+ * @param  [in] The bitset of the maps holding a ship on the segment fired at.
+ * @return The expected number of misses, including a miss by the shot.
+ */
+double expectedMissesAfterShot(uint16_t candidates, uint16_t ships);
+
+/**
+ * @brief  Returns the lowest segment of an optimal shot.
+ * @param  [in] The bitset of the candidate maps, at least two maps.
+ * @return The ID of the segment.
+ */
+SegmentId optimalShot(uint16_t candidates);
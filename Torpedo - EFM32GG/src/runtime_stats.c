@@ -0,0 +1,111 @@
+#include "runtime_stats.h"
+
+#if configGENERATE_RUN_TIME_STATS
+
+/**
+ * The upper 16 bits of the run time counter.
+ */
+static volatile uint16_t runTimeOverflows;
+
+/**
+ * @brief Sends one task statistics message for every task.
+ * @param [in] The handle of the software timer (unused).
+ */
+static void reportRuntimeStats(TimerHandle_t timer) {
+
+	static TaskStatus_t taskStatus[RUNTIME_STATS_MAX_TASKS];
+	static uint32_t previousTaskRunTime[RUNTIME_STATS_MAX_TASKS];
+	static uint32_t previousTotalRunTime;
+
+	// Sampling the state of every task
+	uint32_t totalRunTime;
+	UBaseType_t taskCount = uxTaskGetSystemState(taskStatus, RUNTIME_STATS_MAX_TASKS, &totalRunTime);
+
+	// Calculating the length of the last period
+	uint32_t periodRunTime = totalRunTime - previousTotalRunTime;
+	previousTotalRunTime = totalRunTime;
+
+	if(periodRunTime == 0) {
+		return;
+	}
+
+	for(UBaseType_t i = 0; i < taskCount; i++) {
+
+		// Indexing the previous run times by the unique task number
+		UBaseType_t taskNumber = taskStatus[i].xTaskNumber % RUNTIME_STATS_MAX_TASKS;
+
+		// Calculating the run time of the task in the last period
+		uint32_t taskRunTime = taskStatus[i].ulRunTimeCounter - previousTaskRunTime[taskNumber];
+		previousTaskRunTime[taskNumber] = taskStatus[i].ulRunTimeCounter;
+
+		// Sending statistics message
+		sendTaskStatsMessage(taskStatus[i].pcTaskName, (uint64_t)taskRunTime * 1000 / periodRunTime,
+							 taskStatus[i].usStackHighWaterMark);
+	}
+}
+
+void initRuntimeStats(void) {
+
+	// Creating the reporting timer
+#if configSUPPORT_STATIC_ALLOCATION
+	static StaticTimer_t reportTimerBuffer;
+	TimerHandle_t reportTimer = xTimerCreateStatic("RUNTIME", pdMS_TO_TICKS(RUNTIME_STATS_PERIOD_MS),
+												   pdTRUE, NULL, reportRuntimeStats, &reportTimerBuffer);
+#else
+	TimerHandle_t reportTimer = xTimerCreate("RUNTIME", pdMS_TO_TICKS(RUNTIME_STATS_PERIOD_MS),
+											 pdTRUE, NULL, reportRuntimeStats);
+#endif
+
+	// Starting the timer with the scheduler
+	xTimerStart(reportTimer, 0);
+}
+
+void vConfigureRunTimeStatsTimer(void) {
+
+	// Enabling clock for the timer
+	CMU_ClockEnable(cmuClock_TIMER1, true);
+
+	// Initializing the timer as a free running up-counter
+	TIMER_Init_TypeDef timerInit = TIMER_INIT_DEFAULT;
+	timerInit.prescale = RUNTIME_STATS_PRESCALE;
+
+	TIMER_Init(TIMER1, &timerInit);
+
+	// Enabling the overflow interrupt, it does not call the kernel,
+	// so it is left above the maximum syscall priority
+	TIMER_IntClear(TIMER1, TIMER_IF_OF);
+	TIMER_IntEnable(TIMER1, TIMER_IEN_OF);
+
+	NVIC_ClearPendingIRQ(TIMER1_IRQn);
+	NVIC_EnableIRQ(TIMER1_IRQn);
+}
+
+uint32_t ulGetRunTimeCounterValue(void) {
+
+	uint16_t overflows;
+	uint32_t counter;
+
+	// Re-reading if an overflow was counted in between
+	do {
+		overflows = runTimeOverflows;
+		counter   = TIMER_CounterGet(TIMER1);
+	} while(overflows != runTimeOverflows);
+
+	// Counting an overflow not handled yet, the interrupt may be masked by the caller,
+	// a small counter value shows that it happened before the counter was read
+	if((TIMER_IntGet(TIMER1) & TIMER_IF_OF) && (counter & 0xFFFF) < 0x8000) {
+		overflows++;
+	}
+
+	return ((uint32_t)overflows << 16) | (counter & 0xFFFF);
+}
+
+void TIMER1_IRQHandler(void) {
+
+	// Clearing interrupt flags
+	TIMER_IntClear(TIMER1, TIMER_IF_OF);
+
+	runTimeOverflows++;
+}
+
+#endif
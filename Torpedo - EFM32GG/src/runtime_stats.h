@@ -0,0 +1,60 @@
+#pragma once
+
+// Standard includes
+#include <stdint.h>
+
+// Board includes
+#include <em_cmu.h>
+#include <em_timer.h>
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+// Project includes
+#include "statistics.h"
+
+// Project defines
+
+/**
+ * This macro defines the time between two task statistics reports in milliseconds.
+ */
+#define RUNTIME_STATS_PERIOD_MS 	(1000)
+
+/**
+ * This macro defines the prescaler of the run time counter. With the 14 MHz
+ * peripheral clock the counter runs at ~219 kHz, well above the tick rate.
+ */
+#define RUNTIME_STATS_PRESCALE 		(timerPrescale64)
+
+/**
+ * This macro defines the maximum number of tasks reported, including
+ * the idle and the timer service task.
+ */
+#define RUNTIME_STATS_MAX_TASKS 	(8)
+
+/**
+ * @brief Creates the software timer that periodically reports the
+ *        CPU share and the stack high water mark of every task.
+ *        Only available in the runtime-stats build.
+ */
+void initRuntimeStats(void);
+
+/**
+ * @brief  Starts TIMER1 as the run time counter. Called by the
+ *         kernel when the scheduler is started.
+ */
+void vConfigureRunTimeStatsTimer(void);
+
+/**
+ * @brief  Returns the run time counter, TIMER1 extended to 32 bits.
+ * @return The current value of the run time counter.
+ */
+uint32_t ulGetRunTimeCounterValue(void);
+
+/**
+ * @brief  The interrupt request handler of TIMER1.
+ * @detail Counts the overflows of the run time counter.
+ */
+void TIMER1_IRQHandler(void);
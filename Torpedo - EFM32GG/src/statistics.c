@@ -1,87 +1,415 @@
 #include "statistics.h"
+#include "event_trace.h"
+#include "link.h"
 
+/**
+ * The transmit buffer. Both indices are only accessed in critical
+ * sections: the head by the send functions, the tail by the statistics
+ * task and by the send functions dropping the oldest messages.
+ */
+static uint8_t txBuffer[STATISTICS_BUFFER_SIZE];
+static uint32_t txHead;
+static uint32_t txTail;
 
-void sendStatisticsMessage(MessageType type, Message_t message) {
+/**
+ * The sequence number of the next message, including the ones lost.
+ */
+static uint16_t nextSequence;
 
-	// Constructing message to transmit
-	Message msg = {
-		.messageID = type,
-		.message   = message
-	};
+/**
+ * The length of each buffered message type in bytes.
+ */
+static const uint8_t messageLengths[] = {
+	[GameStartedMsg]     = 3 + 6,
+	[GameFinishedMsg]    = 3 + 10,
+	[SegmentSelectedMsg] = 3 + 5,
+	[SegmentFiredMsg]    = 3 + 5,
+	[SegmentHitMsg]      = 3 + 5,
+	[SegmentMissedMsg]   = 3 + 5,
+	[TaskStatsMsg]       = 3 + TASK_STATS_NAME_LENGTH + 4,
+	[TickPeriodMsg]      = 3 + 5,
+	[BaudrateAckMsg]     = 3 + 5,
+	[EchoMsg]            = 3 + 1,
+	[IdleStatsMsg]       = 3 + 12
+};
 
-	// Posting message to queue for transmit
-	xQueueSendToBack(statisticsQueue, &msg, portMAX_DELAY);
+/**
+ * @brief Appends one byte at the specified position of the transmit buffer.
+ * @param [in, out] The free running write position.
+ * @param [in] The byte to write.
+ */
+static inline void putByte(uint32_t *head, uint8_t data) {
+	txBuffer[(*head)++ & (STATISTICS_BUFFER_SIZE - 1)] = data;
 }
 
-void prvStatisticsTask(void *prvParam) {
+/**
+ * @brief Appends a little-endian 32 bit value to the transmit buffer.
+ * @param [in, out] The free running write position.
+ * @param [in] The value to write.
+ */
+static inline void putWord(uint32_t *head, uint32_t data) {
+	putByte(head, data);
+	putByte(head, data >> 8);
+	putByte(head, data >> 16);
+	putByte(head, data >> 24);
+}
+
+/**
+ * @brief  Returns whether the message is only useful to an attached
+ *         host: the cursor moves, the task statistics and the answers
+ *         of the link are not stored while the host is detached.
+ * @param  [in] The type identifier of the message.
+ * @return True if the message is dropped while the host is detached.
+ */
+static bool isLiveMessage(MessageType type) {
+	return type == SegmentSelectedMsg || type == TaskStatsMsg ||
+		   type == BaudrateAckMsg || type == EchoMsg;
+}
+
+/**
+ * @brief  Makes room for a message while the host is detached, by
+ *         evicting the oldest stored game: every message up to the start
+ *         of the next one. If only the running game is stored, just its
+ *         oldest messages are. Called in a critical section.
+ * @param  [in] The length of the message to store.
+ */
+static void evictOldestGames(uint8_t length) {
+
+	while(STATISTICS_BUFFER_SIZE - (txHead - txTail) < length) {
+
+		// Finding the start of the next game
+		uint32_t tail = txTail;
+		uint32_t count = 0;
+		do {
+			tail += messageLengths[txBuffer[tail & (STATISTICS_BUFFER_SIZE - 1)]];
+			count++;
+		} while(tail != txHead && txBuffer[tail & (STATISTICS_BUFFER_SIZE - 1)] != GameStartedMsg);
+
+		// Keeping the running game, only dropping its oldest message
+		if(tail == txHead) {
+			tail = txTail + messageLengths[txBuffer[txTail & (STATISTICS_BUFFER_SIZE - 1)]];
+			count = 1;
+		}
+
+		txTail = tail;
+		statisticsDroppedCount += count;
+	}
+}
+
+/**
+ * @brief  Enters the critical section and reserves room for a message.
+ * @detail On success the type identifier and the sequence number are
+ *         already written, on failure the critical section is left.
+ * @param  [in] The type identifier of the message.
+ * @param  [out] The write position of the first field.
+ * @return True if the message fits, false if it was dropped.
+ */
+static bool beginMessage(MessageType type, uint32_t *head) {
+
+	uint8_t length = messageLengths[type];
+	bool attached = isHostAttached();
+
+	// Keeping the room for the games while the host is away
+	if(isLiveMessage(type) && !attached) return false;
+
+	taskENTER_CRITICAL();
+
+	uint16_t sequence = nextSequence++;
+
+	// Keeping the newest games until the host attaches
+	if(!attached) {
+		evictOldestGames(length);
+	}
+
+#if STATISTICS_OVERFLOW_POLICY == STATISTICS_DROP_OLDEST
+	// Making room by dropping the oldest messages
+	while(STATISTICS_BUFFER_SIZE - (txHead - txTail) < length) {
+		txTail += messageLengths[txBuffer[txTail & (STATISTICS_BUFFER_SIZE - 1)]];
+		statisticsDroppedCount++;
+	}
+#else
+	// Dropping the message if it does not fit
+	if(STATISTICS_BUFFER_SIZE - (txHead - txTail) < length) {
+		statisticsDroppedCount++;
+		taskEXIT_CRITICAL();
+		return false;
+	}
+#endif
+
+	*head = txHead;
+	putByte(head, type);
+	putByte(head, sequence);
+	putByte(head, sequence >> 8);
+
+	return true;
+}
+
+/**
+ * @brief Publishes the message, leaves the critical section and
+ *        wakes up the statistics task.
+ * @param [in] The write position after the last field.
+ */
+static void endMessage(uint32_t head) {
+
+	txHead = head;
+
+	taskEXIT_CRITICAL();
+
+	wakeStatistics();
+}
+
+void sendGameStartedMessage(uint32_t startTick, uint8_t tickDelayMs, uint8_t mapIndex) {
+
+	uint32_t head;
+	if(!beginMessage(GameStartedMsg, &head)) return;
+
+	putWord(&head, startTick);
+	putByte(&head, tickDelayMs);
+	putByte(&head, mapIndex);
+
+	endMessage(head);
+}
+
+void sendGameFinishedMessage(uint32_t stopTick, uint16_t shotsTotal, uint16_t tickOverruns, uint16_t maxTickLatenessMs) {
+
+	uint32_t head;
+	if(!beginMessage(GameFinishedMsg, &head)) return;
+
+	putWord(&head, stopTick);
+	putByte(&head, shotsTotal);
+	putByte(&head, shotsTotal >> 8);
+	putByte(&head, tickOverruns);
+	putByte(&head, tickOverruns >> 8);
+	putByte(&head, maxTickLatenessMs);
+	putByte(&head, maxTickLatenessMs >> 8);
+
+	endMessage(head);
+}
+
+void sendSegmentMessage(MessageType type, uint32_t gameTick, uint8_t segmentID) {
+
+	uint32_t head;
+	if(!beginMessage(type, &head)) return;
+
+	putWord(&head, gameTick);
+	putByte(&head, segmentID);
+
+	endMessage(head);
+}
+
+void sendTaskStatsMessage(const char *taskName, uint16_t cpuShare, uint16_t stackHighWater) {
+
+	uint32_t head;
+	if(!beginMessage(TaskStatsMsg, &head)) return;
+
+	// Writing the task name zero padded
+	bool nameEnded = false;
+	for(uint8_t i = 0; i < TASK_STATS_NAME_LENGTH; i++) {
+		nameEnded = nameEnded || taskName[i] == '\0';
+		putByte(&head, nameEnded ? '\0' : taskName[i]);
+	}
+
+	putByte(&head, cpuShare);
+	putByte(&head, cpuShare >> 8);
+	putByte(&head, stackHighWater);
+	putByte(&head, stackHighWater >> 8);
+
+	endMessage(head);
+}
+
+void sendTickPeriodMessage(uint32_t gameTick, uint8_t tickDelayMs) {
+
+	uint32_t head;
+	if(!beginMessage(TickPeriodMsg, &head)) return;
+
+	putWord(&head, gameTick);
+	putByte(&head, tickDelayMs);
+
+	endMessage(head);
+}
+
+void sendBaudrateAckMessage(uint32_t baudrate, bool accepted) {
+
+	uint32_t head;
+	if(!beginMessage(BaudrateAckMsg, &head)) return;
 
-	// Initializing message queue with 10 slots
-	statisticsQueue = xQueueCreate(10, sizeof(Message));
+	putWord(&head, baudrate);
+	putByte(&head, accepted);
+
+	endMessage(head);
+}
+
+void sendEchoMessage(uint8_t value) {
+
+	uint32_t head;
+	if(!beginMessage(EchoMsg, &head)) return;
+
+	putByte(&head, value);
+
+	endMessage(head);
+}
+
+void sendIdleStatsMessage(uint32_t sleepCount, uint32_t expectedIdleMs, uint32_t actualIdleMs) {
+
+	uint32_t head;
+	if(!beginMessage(IdleStatsMsg, &head)) return;
+
+	putWord(&head, sleepCount);
+	putWord(&head, expectedIdleMs);
+	putWord(&head, actualIdleMs);
+
+	endMessage(head);
+}
+
+#if configUSE_CO_ROUTINES
+
+/**
+ * Set when the statistics co-routine has work to do.
+ */
+static volatile bool statisticsPending;
+
+void wakeStatistics(void) {
+	statisticsPending = true;
+}
+
+bool isStatisticsPending(void) {
+	return statisticsPending || linkServiceDelay() != portMAX_DELAY;
+}
+
+void wakeStatisticsFromISR(BaseType_t *higherPriorityTaskWoken) {
+	statisticsPending = true;
+}
+
+#else
+
+void wakeStatistics(void) {
+	if(statisticsTask != NULL) {
+		xTaskNotifyGive(statisticsTask);
+	}
+}
+
+void wakeStatisticsFromISR(BaseType_t *higherPriorityTaskWoken) {
+	if(statisticsTask != NULL) {
+		vTaskNotifyGiveFromISR(statisticsTask, higherPriorityTaskWoken);
+	}
+}
+
+#endif
+
+void transmitStatistics(void) {
+
+	bool transmitted = false;
+
+	// Storing the messages until the host attaches
+	if(!isHostAttached()) return;
 
 	while(1) {
 
 		// The next message to transmit
-		Message nextMessage;
+		uint8_t message[STATISTICS_MAX_MESSAGE_LENGTH];
+		uint8_t length = 0;
 
-		// Reading next message from the queue
-		if(xQueueReceive(statisticsQueue, &nextMessage, 0)) {
+		// Taking the oldest message from the buffer
+		taskENTER_CRITICAL();
+		if(txTail != txHead) {
+			length = messageLengths[txBuffer[txTail & (STATISTICS_BUFFER_SIZE - 1)]];
+			for(uint8_t i = 0; i < length; i++) {
+				message[i] = txBuffer[txTail++ & (STATISTICS_BUFFER_SIZE - 1)];
+			}
+		}
+		taskEXIT_CRITICAL();
 
-			// Differentiating based on message type identifier
-			switch(nextMessage.messageID) {
-			case GameStartedMsg:
+		if(length == 0) break;
 
-				// Sending message type identifier
-				USART_Tx(UART0, nextMessage.messageID);
+		// Sending the message
+		for(uint8_t i = 0; i < length; i++) {
+			USART_Tx(UART0, message[i]);
+		}
+		transmitted = true;
+	}
 
-				// Sending startTick
-				USART_Tx(UART0, nextMessage.message.gameStartedMessage.startTick);
-				USART_Tx(UART0, nextMessage.message.gameStartedMessage.startTick >> 8);
-				USART_Tx(UART0, nextMessage.message.gameStartedMessage.startTick >> 16);
-				USART_Tx(UART0, nextMessage.message.gameStartedMessage.startTick >> 24);
+	// Waiting for the last byte to leave, the UART stops in EM2
+	if(transmitted) {
+		waitForLinkTransmitter();
+	}
+}
 
-				// Sending tickDelayMs
-				USART_Tx(UART0, nextMessage.message.gameStartedMessage.tickDelayMs);
+void transmitBacklog(void) {
 
-				// Sending mapIndex
-				USART_Tx(UART0, nextMessage.message.gameStartedMessage.mapIndex);
-				break;
+	// Counting the stored messages
+	uint16_t count = 0;
 
-			case GameFinishedMsg:
+	taskENTER_CRITICAL();
+	for(uint32_t tail = txTail; tail != txHead; count++) {
+		tail += messageLengths[txBuffer[tail & (STATISTICS_BUFFER_SIZE - 1)]];
+	}
+	taskEXIT_CRITICAL();
 
-				// Sending message type identifier
-				USART_Tx(UART0, nextMessage.messageID);
+	uint32_t tick = xTaskGetTickCount();
 
-				// Sending stopTick
-				USART_Tx(UART0, nextMessage.message.gameFinishedMessage.stopTick);
-				USART_Tx(UART0, nextMessage.message.gameFinishedMessage.stopTick >> 8);
-				USART_Tx(UART0, nextMessage.message.gameFinishedMessage.stopTick >> 16);
-				USART_Tx(UART0, nextMessage.message.gameFinishedMessage.stopTick >> 24);
+	// Sending the backlog message, followed by the stored messages
+	USART_Tx(UART0, BacklogMsg);
+	USART_Tx(UART0, count);
+	USART_Tx(UART0, count >> 8);
+	USART_Tx(UART0, tick);
+	USART_Tx(UART0, tick >> 8);
+	USART_Tx(UART0, tick >> 16);
+	USART_Tx(UART0, tick >> 24);
 
-				// Sending shotsTotal
-				USART_Tx(UART0, nextMessage.message.gameFinishedMessage.shotsTotal);
-				break;
+	transmitStatistics();
+}
 
-			// The following message types have identical structures
-			case SegmentSelectedMsg:	// [[ fallthrough ]]
-			case SegmentFiredMsg:		// [[ fallthrough ]]
-			case SegmentHitMsg:			// [[ fallthrough ]]
-			case SegmentMissedMsg:		// [[ fallthrough ]]
+void prvStatisticsTask(void *prvParam) {
 
-				// Sending message type identifier
-				USART_Tx(UART0, nextMessage.messageID);
+	while(1) {
 
-				// Sending gameTick
-				USART_Tx(UART0, nextMessage.message.segmentSelectedMessage.gameTick);
-				USART_Tx(UART0, nextMessage.message.segmentSelectedMessage.gameTick >> 8);
-				USART_Tx(UART0, nextMessage.message.segmentSelectedMessage.gameTick >> 16);
-				USART_Tx(UART0, nextMessage.message.segmentSelectedMessage.gameTick >> 24);
+		// Waiting for buffered messages, or for the end of a baud-rate verification
+		ulTaskNotifyTake(pdTRUE, linkServiceDelay());
 
-				// Sending segmentID
-				USART_Tx(UART0, nextMessage.message.segmentSelectedMessage.segmentID);
-				break;
+#if configUSE_EVENT_TRACE
+		// Dumping the event trace on request of the host
+		if(traceDumpRequested) {
+			dumpEventTrace();
+		}
+#endif
 
-			default: break;
-			}
+		// Answering the commands of the host, then sending the buffered
+		// messages unless a new baud-rate is being verified
+		if(serviceLink()) {
+			transmitStatistics();
 		}
 	}
 }
+
+#if configUSE_CO_ROUTINES
+
+void crStatistics(CoRoutineHandle_t handle, UBaseType_t index) {
+
+	crSTART(handle);
+
+	while(1) {
+
+		// Yielding until messages are buffered, polling while a new baud-rate is verified
+		while(!isStatisticsPending()) {
+			crDELAY(handle, 0);
+		}
+		statisticsPending = false;
+
+#if configUSE_EVENT_TRACE
+		// Dumping the event trace on request of the host
+		if(traceDumpRequested) {
+			dumpEventTrace();
+		}
+#endif
+
+		// Answering the commands of the host, then sending the buffered
+		// messages unless a new baud-rate is being verified
+		if(serviceLink()) {
+			transmitStatistics();
+		}
+	}
+
+	crEND();
+}
+
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 
 // Standard includes
+#include <stdbool.h>
 #include <stdint.h>
 
 // Board includes
@@ -8,10 +9,53 @@
 
 // FreeRTOS includes
 #include "FreeRTOS.h"
-#include "queue.h"
+#include "task.h"
+#include "croutine.h"
 
 /**
- * @brief Describes the possible message types.
+ * The size of the transmit buffer in bytes. Must be a power of two,
+ * the buffer indices are free running and masked on access. The
+ * buffer also stores the messages while the host is detached, it
+ * holds the events of about 10 games.
+ */
+#define STATISTICS_BUFFER_SIZE 		(2048)
+
+#if (STATISTICS_BUFFER_SIZE & (STATISTICS_BUFFER_SIZE - 1)) != 0
+#error "STATISTICS_BUFFER_SIZE must be a power of two"
+#endif
+
+/**
+ * The possible overflow policies of the transmit buffer while the host
+ * is attached. Messages are never waited for: when the buffer is full
+ * either the message being sent (DROP_NEWEST) or the oldest buffered
+ * messages (DROP_OLDEST) are lost. While the host is detached the
+ * oldest stored games are evicted as a whole, keeping the newest ones.
+ */
+#define STATISTICS_DROP_NEWEST 		(0)
+#define STATISTICS_DROP_OLDEST 		(1)
+
+/**
+ * The overflow policy of the transmit buffer.
+ */
+#define STATISTICS_OVERFLOW_POLICY 	(STATISTICS_DROP_NEWEST)
+
+/**
+ * The number of characters of the task name sent in the task statistics message.
+ */
+#define TASK_STATS_NAME_LENGTH 		(8)
+
+/**
+ * The length of the longest message in bytes.
+ */
+#define STATISTICS_MAX_MESSAGE_LENGTH 	(3 + TASK_STATS_NAME_LENGTH + 4)
+
+/**
+ * @brief  Describes the possible message types.
+ * @detail Every buffered message starts with its type identifier and
+ *         a 16 bit sequence number, followed by the fields documented
+ *         at the send functions. Multi-byte fields are little-endian.
+ *         The trace dump, the backlog and the history messages are
+ *         not buffered, and have no sequence number.
  */
 typedef enum MessageType {
 	GameStartedMsg,
@@ -19,93 +63,142 @@ typedef enum MessageType {
 	SegmentSelectedMsg,
 	SegmentFiredMsg,
 	SegmentHitMsg,
-	SegmentMissedMsg
+	SegmentMissedMsg,
+	TaskStatsMsg,
+	TraceDumpMsg,
+	TickPeriodMsg,
+	BaudrateAckMsg,
+	EchoMsg,
+	IdleStatsMsg,
+	BacklogMsg,
+	HistoryMsg
 } MessageType;
 
 /**
- * @brief Describes the message sent when the game starts.
+ * @brief The handle of the statistics task, notified when a message is buffered.
+ *        Unused in the co-routine build, see wakeStatistics().
  */
-typedef struct GameStartedMessage {
-	uint32_t startTick;		/**< The value of the game tick counter when the game started. 	*/
-	uint8_t  tickDelayMs;	/**< The time delay between game ticks in milliseconds. 		*/
-	uint8_t  mapIndex;		/**< The index of the map the game is played on. 				*/
-} GameStartedMessage;
+TaskHandle_t statisticsTask;
 
 /**
- * @brief Describes the message sent the the game ends.
+ * @brief The number of messages lost because the transmit buffer was full.
  */
-typedef struct GameFinishedMessage {
-	uint32_t stopTick;		/**< The value of the game tick counter when the game finished.	*/
-	uint8_t  shotsTotal;	/**< The total number of shots fired when the game finished.	*/
-} GameFinishedMessage;
+volatile uint32_t statisticsDroppedCount;
 
 /**
- * @brief Describes the message sent when a new segment is selected.
+ * @brief Buffers the message sent when the game starts.
+ * @param [in] The value of the game tick counter when the game started.
+ * @param [in] The time delay between game ticks in milliseconds.
+ * @param [in] The index of the map the game is played on.
  */
-typedef struct SegmentSelectedMessage {
-	uint32_t gameTick;		/**< The value of the game tick counter when the segment was selected.	*/
-	uint8_t  segmentID;		/**< The ID of the segment selected. 									*/
-} SegmentSelectedMessage;
+void sendGameStartedMessage(uint32_t startTick, uint8_t tickDelayMs, uint8_t mapIndex);
 
 /**
- * @brief Describes the message sent when a segment is fired at.
+ * @brief Buffers the message sent when the game ends.
+ * @param [in] The value of the game tick counter when the game finished.
+ * @param [in] The total number of shots fired when the game finished.
+ * @param [in] The number of game ticks that overran the tick period.
+ * @param [in] The largest delay of a game tick start in milliseconds.
  */
-typedef struct SegmentFiredMessage {
-	uint32_t gameTick;		/**< The value of the game tick counter when the segment was fired at.	*/
-	uint8_t  segmentID;		/**< The ID of the segment fired at. 									*/
-} SegmentFiredMessage;
+void sendGameFinishedMessage(uint32_t stopTick, uint16_t shotsTotal, uint16_t tickOverruns, uint16_t maxTickLatenessMs);
 
 /**
- * @brief Describes the message sent when a segment is hit.
+ * @brief Buffers a segment selected, fired, hit or missed message.
+ * @param [in] The type identifier of the message.
+ * @param [in] The value of the game tick counter at the event.
+ * @param [in] The ID of the segment.
  */
-typedef struct SegmentHitMessage {
-	uint32_t gameTick;		/**< The value of the game tick counter when the segment was hit.	*/
-	uint8_t  segmentID;		/**< The ID of the segment hit.	 									*/
-} SegmentHitMessage;
+void sendSegmentMessage(MessageType type, uint32_t gameTick, uint8_t segmentID);
 
 /**
- * @brief Describes the message sent when a segment is missed.
+ * @brief Buffers the message sent periodically about each task in the runtime-stats build.
+ * @param [in] The name of the task, sent zero padded to TASK_STATS_NAME_LENGTH.
+ * @param [in] The share of the CPU used by the task in the last period, in 0.1%.
+ * @param [in] The minimum free stack space of the task so far, in words.
  */
-typedef struct SegmentMissedMessage {
-	uint32_t gameTick;		/**< The value of the game tick counter when the segment was missed.	*/
-	uint8_t  segmentID;		/**< The ID of the segment missed. 										*/
-} SegmentMissedMessage;
+void sendTaskStatsMessage(const char *taskName, uint16_t cpuShare, uint16_t stackHighWater);
 
 /**
- * @brief Describes a message that is one of the predefined message types.
+ * @brief Buffers the message sent when the game loop applies a new tick period.
+ * @param [in] The value of the game tick counter when the period changed.
+ * @param [in] The new time delay between game ticks in milliseconds.
  */
-typedef union Message_t {
-	GameStartedMessage 	   gameStartedMessage;
-	GameFinishedMessage    gameFinishedMessage;
-	SegmentSelectedMessage segmentSelectedMessage;
-	SegmentFiredMessage    segmentFiredMessage;
-	SegmentHitMessage      segmentHitMessage;
-	SegmentMissedMessage   segmentMissedMessage;
-} Message_t;
+void sendTickPeriodMessage(uint32_t gameTick, uint8_t tickDelayMs);
 
 /**
- * @brief Describes a message with the type identifier and the message body.
+ * @brief Buffers the answer to a baud-rate proposed by the host.
+ * @param [in] The proposed baud-rate.
+ * @param [in] True if the board switches to the proposed rate.
  */
-typedef struct Message {
-	uint8_t   messageID;	/**< The type identifier of the message.	*/
-	Message_t message;		/**< The content of the message. 			*/
-} Message;
+void sendBaudrateAckMessage(uint32_t baudrate, bool accepted);
 
 /**
- * @brief FreeRTOS queue holding the statistics messages to transmit.
+ * @brief Buffers the answer to an echo command of the host.
+ * @param [in] The value received in the echo command.
  */
-QueueHandle_t statisticsQueue;
+void sendEchoMessage(uint8_t value);
 
 /**
- * @brief Queues the specified message for transmission over the UART.
- * @param [in] The type identifier of the message.
- * @param [in] The message structure to transmit.
+ * @brief Buffers the sleep report of the tickless idle, sent before the game-finished message.
+ * @param [in] The number of sleeps during the game.
+ * @param [in] The sum of the idle times expected by the kernel in milliseconds.
+ * @param [in] The sum of the time actually slept in milliseconds.
  */
-void sendStatisticsMessage(MessageType type, Message_t message);
+void sendIdleStatsMessage(uint32_t sleepCount, uint32_t expectedIdleMs, uint32_t actualIdleMs);
 
 /**
- * @brief The FreeRTOS task that transmits statistics over the UART.
+ * @brief Wakes up the statistics task, or flags the statistics
+ *        co-routine in the co-routine build.
+ */
+void wakeStatistics(void);
+
+/**
+ * @brief Wakes up the statistics task from an interrupt, or flags the
+ *        statistics co-routine in the co-routine build.
+ * @param [out] Set to pdTRUE if the statistics task should run next.
+ */
+void wakeStatisticsFromISR(BaseType_t *higherPriorityTaskWoken);
+
+/**
+ * @brief Transmits every buffered message over the UART, or keeps them
+ *        while the host is detached. Must only be called by the
+ *        statistics task.
+ */
+void transmitStatistics(void);
+
+/**
+ * @brief  Transmits the messages stored while the host was detached.
+ * @detail Sends a backlog message with the number of stored messages
+ *         and the current tick, then every stored message back to back.
+ *         The stored messages keep their sequence numbers, so the host
+ *         merges them in order, and detects the ones lost in between.
+ *         Must only be called by the statistics task.
+ */
+void transmitBacklog(void);
+
+/**
+ * @brief  The FreeRTOS task that transmits statistics over the UART.
+ * @detail The messages are encoded directly into the transmit buffer by
+ *         the send functions, the task only copies them to the UART.
  * @param [in] The FreeRTOS task parameter (unused).
  */
 void prvStatisticsTask(void *prvParam);
 
+#if configUSE_CO_ROUTINES
+/**
+ * @brief  The co-routine that transmits statistics in the co-routine build.
+ * @detail Runs from the idle task, so it yields instead of blocking, and
+ *         busy-waits on the UART like the statistics task.
+ * @param  [in] The handle of the co-routine.
+ * @param  [in] The index of the co-routine (unused).
+ */
+void crStatistics(CoRoutineHandle_t handle, UBaseType_t index);
+
+/**
+ * @brief  Returns whether the statistics co-routine has work to do.
+ * @detail Checked before the board sleeps, the kernel does not know
+ *         about the flags the co-routines poll.
+ * @return True if messages or commands wait, or a baud-rate is verified.
+ */
+bool isStatisticsPending(void);
+#endif
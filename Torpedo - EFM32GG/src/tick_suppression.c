@@ -0,0 +1,23 @@
+#include "tick_suppression.h"
+
+uint32_t maxSuppressedTicks(uint32_t tickRateHz, uint32_t timerHz, uint32_t maxCounts) {
+	return (uint64_t)maxCounts * tickRateHz / timerHz;
+}
+
+uint32_t sleepCountsUntilTick(uint32_t ticks, uint32_t elapsedUnits, uint32_t tickRateHz, uint32_t timerHz) {
+
+	// The boundary already passed
+	uint64_t units = (uint64_t)ticks * timerHz;
+	if(units <= elapsedUnits) return 0;
+
+	return (units - elapsedUnits) / tickRateHz;
+}
+
+uint32_t sleptTicks(uint32_t counts, uint32_t elapsedUnits, uint32_t tickRateHz, uint32_t timerHz,
+					uint32_t *remainingUnits) {
+
+	uint64_t units = (uint64_t)counts * tickRateHz + elapsedUnits;
+
+	*remainingUnits = units % timerHz;
+	return units / timerHz;
+}
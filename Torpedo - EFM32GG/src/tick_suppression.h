@@ -0,0 +1,45 @@
+#pragma once
+
+// Standard includes
+#include <stdint.h>
+
+/**
+ * The arithmetic of the tickless idle, kept free of board and kernel
+ * dependencies so it can be compiled and checked on the host.
+ *
+ * Time within a kernel tick is measured in units of 1 / timerHz ticks,
+ * so one sleep timer count is exactly tickRateHz units and the position
+ * in the current tick carries over between sleeps without rounding.
+ */
+
+/**
+ * @brief  Returns the longest sleep in kernel ticks the sleep timer can measure.
+ * @param  [in] The kernel tick rate in Hz.
+ * @param  [in] The sleep timer frequency in Hz.
+ * @param  [in] The largest value of the sleep timer counter.
+ * @return The number of ticks.
+ */
+uint32_t maxSuppressedTicks(uint32_t tickRateHz, uint32_t timerHz, uint32_t maxCounts);
+
+/**
+ * @brief  Returns the sleep timer counts from now to the specified tick boundary.
+ * @detail The result is rounded down, so the sleep never runs past the boundary.
+ * @param  [in] The tick boundary, counted from the start of the current tick.
+ * @param  [in] The time already elapsed in the current tick, in units.
+ * @param  [in] The kernel tick rate in Hz.
+ * @param  [in] The sleep timer frequency in Hz.
+ * @return The number of sleep timer counts.
+ */
+uint32_t sleepCountsUntilTick(uint32_t ticks, uint32_t elapsedUnits, uint32_t tickRateHz, uint32_t timerHz);
+
+/**
+ * @brief  Returns the complete ticks passed during a sleep.
+ * @param  [in] The sleep timer counts measured during the sleep.
+ * @param  [in] The time elapsed in the current tick before the sleep, in units.
+ * @param  [in] The kernel tick rate in Hz.
+ * @param  [in] The sleep timer frequency in Hz.
+ * @param  [out] The time elapsed in the tick running after the sleep, in units.
+ * @return The number of complete ticks.
+ */
+uint32_t sleptTicks(uint32_t counts, uint32_t elapsedUnits, uint32_t tickRateHz, uint32_t timerHz,
+					uint32_t *remainingUnits);
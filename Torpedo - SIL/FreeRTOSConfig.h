@@ -0,0 +1,73 @@
+#pragma once
+#ifndef FREERTOSCONFIG_H
+#define FREERTOSCONFIG_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    FreeRTOSConfig.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   The kernel configuration of the firmware, adapted to the FreeRTOS POSIX port.
+ ********************************************************************************/
+
+/**
+ * The software-in-the-loop build runs the kernel configuration of the
+ * firmware, only the settings depending on the Cortex-M3 core differ.
+ */
+#include "../Torpedo - EFM32GG/FreeRTOSConfig.h"
+
+/**
+ * The POSIX port keeps the tick running, the sleep of the board
+ * (src/low_power.c) needs the RTC and the SysTick of the core.
+ */
+#undef configUSE_TICKLESS_IDLE
+#define configUSE_TICKLESS_IDLE                   ( 0 )
+
+/**
+ * Every task runs on a thread of the host, placed on the stack of the
+ * task, which must hold at least PTHREAD_STACK_MIN bytes. The timer
+ * task stack follows configMINIMAL_STACK_SIZE.
+ */
+#undef configMINIMAL_STACK_SIZE
+#define configMINIMAL_STACK_SIZE                  (( unsigned short ) 16384)
+
+/**
+ * The functions of atomic.h are static, only forced inline if the port
+ * says how. The Cortex-M3 port does, the POSIX port does not, so every
+ * unit including the header would define them unused.
+ */
+#define portFORCE_INLINE                          inline __attribute__(( always_inline ))
+
+/**
+ * The event trace timestamps are read from the DWT cycle counter of the
+ * core, which is not simulated. The run time stats use TIMER1, which is.
+ */
+#if configUSE_EVENT_TRACE
+#error "The event trace is not supported by the software-in-the-loop build"
+#endif
+
+#endif // FREERTOSCONFIG_H
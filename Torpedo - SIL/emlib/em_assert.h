@@ -0,0 +1,46 @@
+#pragma once
+#ifndef EM_ASSERT_H
+#define EM_ASSERT_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    em_assert.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Assertions of the firmware, reported on the host.
+ ********************************************************************************/
+
+/**
+ * @brief Reports the failed assertion of the firmware (configASSERT) and aborts.
+ * @param [in] The source file of the assertion.
+ * @param [in] The line of the assertion.
+ */
+void assertEFM(const char *file, int line);
+
+#define EFM_ASSERT(expr)            ((expr) ? (void)0 : assertEFM(__FILE__, __LINE__))
+
+#endif // EM_ASSERT_H
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef EM_CHIP_H
+#define EM_CHIP_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    em_chip.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated chip initialization, starting the simulated board.
+ ********************************************************************************/
+
+/**
+ * @brief Starts the simulated board: opens the pseudo terminal of UART0,
+ *        and creates the task serving the simulated interrupts. The
+ *        firmware calls it first in main(), before creating its tasks.
+ */
+void CHIP_Init(void);
+
+#endif // EM_CHIP_H
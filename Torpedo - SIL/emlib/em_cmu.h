@@ -0,0 +1,61 @@
+#pragma once
+#ifndef EM_CMU_H
+#define EM_CMU_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    em_cmu.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated clock management unit, every clock is always running.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+
+// Project includes
+#include "em_device.h"
+
+
+/**
+ * @brief The clocks enabled by the firmware.
+ */
+typedef enum {
+    cmuClock_GPIO,
+    cmuClock_UART0,
+    cmuClock_TIMER1,
+    cmuClock_CORELE,
+    cmuClock_RTC,
+    cmuClock_LCD
+} CMU_Clock_TypeDef;
+
+/**
+ * @brief Enables or disables a clock, the simulation ignores it.
+ */
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable);
+
+#endif // EM_CMU_H
@@ -0,0 +1,140 @@
+#pragma once
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    em_device.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated device header of the EFM32GG, the registers, interrupts and core functions used by the firmware.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * @brief The interrupt priority bits of the Cortex-M3 core of the EFM32GG.
+ */
+#define __NVIC_PRIO_BITS            (3)
+
+/**
+ * @brief The interrupts of the EFM32GG used by the firmware, numbered
+ *        as in its vector table. At equal priority the simulated NVIC
+ *        serves the lower number first, like the hardware.
+ */
+typedef enum {
+    GPIO_EVEN_IRQn  = 1,
+    GPIO_ODD_IRQn   = 11,
+    TIMER1_IRQn     = 12,
+    UART0_RX_IRQn   = 20,
+    RTC_IRQn        = 30,
+    LCD_IRQn        = 34
+} IRQn_Type;
+
+/**
+ * @brief The number of interrupt lines of the simulated NVIC.
+ */
+#define SIL_IRQ_COUNT               (64)
+
+/**
+ * @brief The UART registers kept up to date by the simulated UART. Data
+ *        is read with USART_RxDataGet(), the status with USART_StatusGet().
+ */
+typedef struct {
+    volatile uint32_t STATUS;       /**< The status flags (USART_STATUS_x)      */
+    volatile uint32_t CLKDIV;       /**< The baud-rate set by the firmware      */
+    volatile uint32_t IEN;          /**< The enabled interrupts                 */
+    volatile uint32_t IF;           /**< The raised interrupts                  */
+    volatile uint32_t ROUTE;        /**< The pin routing                        */
+} USART_TypeDef;
+
+extern USART_TypeDef silUart0;
+#define UART0                       (&silUart0)
+
+#define USART_STATUS_TXC            (1UL << 5)
+#define USART_STATUS_TXBL           (1UL << 6)
+#define USART_STATUS_RXDATAV        (1UL << 7)
+
+#define USART_ROUTE_RXPEN           (1UL << 0)
+#define USART_ROUTE_TXPEN           (1UL << 1)
+#define USART_ROUTE_LOCATION_LOC1   (1UL << 8)
+
+#define UART_IEN_RXDATAV            (1UL << 2)
+#define UART_IF_RXDATAV             (1UL << 2)
+
+/**
+ * @brief The timer registers of the simulated TIMER1, counted from the
+ *        monotonic clock of the host at the prescaled core clock.
+ */
+typedef struct {
+    volatile uint32_t CTRL;         /**< The prescaler of the counter           */
+    volatile uint32_t IEN;          /**< The enabled interrupts                 */
+    volatile uint32_t IF;           /**< The raised interrupts                  */
+} TIMER_TypeDef;
+
+extern TIMER_TypeDef silTimer1;
+#define TIMER1                      (&silTimer1)
+
+#define TIMER_IF_OF                 (1UL << 0)
+#define TIMER_IEN_OF                (1UL << 0)
+
+#define LCD_IF_FC                   (1UL << 0)
+#define LCD_IEN_FC                  (1UL << 0)
+
+/**
+ * @brief The flash of the simulated EFM32GG. Only the last pages of
+ *        the flash are simulated, the firmware stores its game history
+ *        there, the image itself runs from the memory of the host.
+ */
+#define FLASH_PAGE_SIZE             (4096)
+#define FLASH_SIZE                  (16 * FLASH_PAGE_SIZE)
+
+extern uint32_t silFlash[FLASH_SIZE / sizeof(uint32_t)];
+#define FLASH_BASE                  ((uintptr_t) silFlash)
+
+/**
+ * @brief Memory barriers, the simulated peripherals share memory with
+ *        the interrupt task.
+ */
+static inline void __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __ISB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+/**
+ * @brief The simulated NVIC. Pending and enabled interrupts are served
+ *        by the interrupt task of the simulated board (see sil_board.h).
+ */
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_SetPendingIRQ(IRQn_Type irq);
+void NVIC_ClearPendingIRQ(IRQn_Type irq);
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority);
+
+#endif // EM_DEVICE_H
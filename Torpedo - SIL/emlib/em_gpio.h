@@ -0,0 +1,64 @@
+#pragma once
+#ifndef EM_GPIO_H
+#define EM_GPIO_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    em_gpio.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated GPIO, the pins of the UART are connected to the pseudo terminal.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "em_device.h"
+
+
+typedef enum {gpioPortA, gpioPortB, gpioPortC, gpioPortD, gpioPortE, gpioPortF} GPIO_Port_TypeDef;
+
+typedef enum {gpioModeDisabled, gpioModeInput, gpioModePushPull} GPIO_Mode_TypeDef;
+
+/**
+ * @brief Configures a pin, the simulation ignores it.
+ */
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out);
+
+/**
+ * @brief Configures the interrupt of a pin, the simulation ignores it.
+ */
+void GPIO_IntConfig(GPIO_Port_TypeDef port, unsigned int pin, bool risingEdge, bool fallingEdge, bool enable);
+
+/**
+ * @brief Clears the interrupt flags of the pins, the simulation ignores it.
+ */
+void GPIO_IntClear(uint32_t flags);
+
+#endif // EM_GPIO_H
@@ -0,0 +1,119 @@
+#pragma once
+#ifndef EM_LCD_H
+#define EM_LCD_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    em_lcd.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated LCD controller, rendering the segment registers into an inspectable framebuffer.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "em_device.h"
+
+
+typedef enum {lcdFCPrescDiv1, lcdFCPrescDiv2, lcdFCPrescDiv4, lcdFCPrescDiv8} LCD_FCPreScale_TypeDef;
+
+typedef enum {lcdAnimShiftNone, lcdAnimShiftLeft, lcdAnimShiftRight} LCD_AnimShift_TypeDef;
+
+typedef enum {lcdAnimLogicAnd, lcdAnimLogicOr} LCD_AnimLogic_TypeDef;
+
+/**
+ * @brief The configuration of the animation controller, driving the
+ *        eight segments of the ring from the AREGA and AREGB registers.
+ */
+typedef struct {
+    bool enable;
+    uint32_t AReg;
+    LCD_AnimShift_TypeDef AShift;
+    uint32_t BReg;
+    LCD_AnimShift_TypeDef BShift;
+    LCD_AnimLogic_TypeDef animLogic;
+    int startSeg;
+} LCD_AnimInit_TypeDef;
+
+/**
+ * @brief The configuration of the frame counter, raising LCD_IF_FC
+ *        every (top + 1) << prescale frames.
+ */
+typedef struct {
+    bool enable;
+    uint32_t top;
+    LCD_FCPreScale_TypeDef prescale;
+} LCD_FrameCountInit_TypeDef;
+
+/**
+ * @brief The frame rate of the simulated LCD, the frame rate of the board.
+ */
+#define SIL_LCD_FRAME_RATE_HZ       (64)
+
+/**
+ * @brief The COM lines and the segment data registers of the LCD.
+ */
+#define SIL_LCD_COM_COUNT           (8)
+
+/**
+ * @brief The state of the simulated LCD. The segment data registers
+ *        are latched into the displayed frame when the registers are
+ *        unfrozen, every displayed frame is logged (see sil_lcd.c).
+ */
+typedef struct {
+    uint32_t segd[SIL_LCD_COM_COUNT][2];        /**< The segment data registers, low and high   */
+    uint32_t displayed[SIL_LCD_COM_COUNT][2];   /**< The frame shown by the display             */
+    bool frozen;                                /**< Set while the registers are frozen         */
+    bool animationEnabled;                      /**< Set while the ring is animated             */
+    uint8_t animationA;                         /**< The AREGA register                         */
+    uint8_t animationB;                         /**< The AREGB register                         */
+    LCD_AnimInit_TypeDef animation;             /**< The animation configuration                */
+    LCD_FrameCountInit_TypeDef frameCount;      /**< The frame counter configuration            */
+    uint32_t ien;                               /**< The enabled interrupts                     */
+    uint32_t flags;                             /**< The raised interrupts                      */
+} SIL_LCD_TypeDef;
+
+extern SIL_LCD_TypeDef silLcd;
+
+void LCD_FrameCountInit(const LCD_FrameCountInit_TypeDef *fcInit);
+void LCD_AnimInit(const LCD_AnimInit_TypeDef *animInit);
+void LCD_AnimEnable(bool enable);
+void LCD_SegmentSet(int com, int bit, bool enable);
+void LCD_SegmentSetLow(int com, uint32_t mask, uint32_t bits);
+void LCD_SegmentSetHigh(int com, uint32_t mask, uint32_t bits);
+void LCD_FreezeEnable(bool enable);
+uint32_t LCD_SyncBusyGet(void);
+void LCD_SyncBusyDelay(uint32_t flags);
+uint32_t LCD_IntGet(void);
+void LCD_IntEnable(uint32_t flags);
+void LCD_IntDisable(uint32_t flags);
+void LCD_IntClear(uint32_t flags);
+
+#endif // EM_LCD_H
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef EM_MSC_H
+#define EM_MSC_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    em_msc.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated memory system controller, writing and erasing the simulated flash of the EFM32GG.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdint.h>
+
+// Project includes
+#include "em_device.h"
+
+
+typedef enum {
+    mscReturnOk          = 0,
+    mscReturnInvalidAddr = -1,
+    mscReturnLocked      = -2,
+    mscReturnTimeOut     = -3,
+    mscReturnUnaligned   = -4
+} MSC_Status_TypeDef;
+
+/**
+ * @brief Enables writing and erasing the simulated flash.
+ */
+void MSC_Init(void);
+
+/**
+ * @brief Disables writing and erasing the simulated flash.
+ */
+void MSC_Deinit(void);
+
+/**
+ * @brief   Writes words to the simulated flash. Like the flash of the
+ *          board, a write can only clear bits, and writing a word twice
+ *          without an erase is reported as an error of the firmware.
+ * @param   [in] The word aligned address in the flash.
+ * @param   [in] The data to write.
+ * @param   [in] The number of bytes to write, a multiple of 4.
+ * @returns mscReturnOk on success, the reason of the failure otherwise.
+ */
+MSC_Status_TypeDef MSC_WriteWord(uint32_t *address, void const *data, uint32_t numBytes);
+
+/**
+ * @brief   Erases a page of the simulated flash to all ones.
+ * @param   [in] The first word of the page.
+ * @returns mscReturnOk on success, the reason of the failure otherwise.
+ */
+MSC_Status_TypeDef MSC_ErasePage(uint32_t *startAddress);
+
+#endif // EM_MSC_H
@@ -0,0 +1,76 @@
+#pragma once
+#ifndef EM_TIMER_H
+#define EM_TIMER_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    em_timer.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated timers, counting the monotonic clock of the host.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "em_device.h"
+
+
+typedef enum {
+    timerPrescale1, timerPrescale2, timerPrescale4, timerPrescale8, timerPrescale16, timerPrescale32,
+    timerPrescale64, timerPrescale128, timerPrescale256, timerPrescale512, timerPrescale1024
+} TIMER_Prescale_TypeDef;
+
+/**
+ * @brief The configuration of a timer, the simulated timers always
+ *        count up, with the core clock divided by the prescaler.
+ */
+typedef struct {
+    bool enable;
+    TIMER_Prescale_TypeDef prescale;
+} TIMER_Init_TypeDef;
+
+#define TIMER_INIT_DEFAULT          {true, timerPrescale1}
+
+/**
+ * @brief The clock of the simulated timers, the core clock of the board.
+ */
+#define SIL_TIMER_CLOCK_HZ          (14000000)
+
+void TIMER_Init(TIMER_TypeDef *timer, const TIMER_Init_TypeDef *init);
+void TIMER_IntClear(TIMER_TypeDef *timer, uint32_t flags);
+void TIMER_IntEnable(TIMER_TypeDef *timer, uint32_t flags);
+uint32_t TIMER_IntGet(TIMER_TypeDef *timer);
+
+/**
+ * @brief Returns the 16 bit counter of the timer.
+ */
+uint32_t TIMER_CounterGet(TIMER_TypeDef *timer);
+
+#endif // EM_TIMER_H
@@ -0,0 +1,97 @@
+#pragma once
+#ifndef EM_USART_H
+#define EM_USART_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    em_usart.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated UART0, connected to a pseudo terminal of the host.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "em_device.h"
+
+
+typedef enum {usartDisable, usartEnableRx, usartEnableTx, usartEnable} USART_Enable_TypeDef;
+
+typedef enum {usartOVS16, usartOVS8, usartOVS6, usartOVS4} USART_OVS_TypeDef;
+
+typedef enum {usartDatabits8 = 8, usartDatabits9 = 9} USART_Databits_TypeDef;
+
+typedef enum {usartNoParity, usartEvenParity, usartOddParity} USART_Parity_TypeDef;
+
+typedef enum {usartStopbits1, usartStopbits2} USART_Stopbits_TypeDef;
+
+typedef enum {usartPrsRxCh0} USART_PrsRxCh_TypeDef;
+
+/**
+ * @brief The asynchronous configuration of the UART, the simulation
+ *        only uses the baud-rate to pace the transfers.
+ */
+typedef struct {
+    USART_Enable_TypeDef enable;
+    uint32_t refFreq;
+    uint32_t baudrate;
+    USART_OVS_TypeDef oversampling;
+    USART_Databits_TypeDef databits;
+    USART_Parity_TypeDef parity;
+    USART_Stopbits_TypeDef stopbits;
+    bool mvdis;
+    bool prsRxEnable;
+    USART_PrsRxCh_TypeDef prsRxCh;
+    bool autoCsEnable;
+} USART_InitAsync_TypeDef;
+
+void USART_InitAsync(USART_TypeDef *usart, const USART_InitAsync_TypeDef *init);
+void USART_BaudrateAsyncSet(USART_TypeDef *usart, uint32_t refFreq, uint32_t baudrate, USART_OVS_TypeDef ovs);
+void USART_IntClear(USART_TypeDef *usart, uint32_t flags);
+void USART_IntEnable(USART_TypeDef *usart, uint32_t flags);
+
+/**
+ * @brief  Returns the status flags of the UART (USART_STATUS_x).
+ * @detail RXDATAV is set while received data is waiting, TXC is set
+ *         once the last byte left the wire at the current baud-rate.
+ */
+uint32_t USART_StatusGet(USART_TypeDef *usart);
+
+/**
+ * @brief  Takes the oldest received byte, like reading RXDATA.
+ */
+uint8_t USART_RxDataGet(USART_TypeDef *usart);
+
+/**
+ * @brief Sends a byte, waiting while the previous one is on the wire.
+ */
+void USART_Tx(USART_TypeDef *usart, uint8_t data);
+
+#endif // EM_USART_H
@@ -0,0 +1,78 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+# The GCC/Posix port of the FreeRTOS-Kernel V10.3.1 release, matching the
+# kernel of the firmware, e.g. qmake FREERTOS_POSIX_PORT=<kernel>/portable/ThirdParty/GCC/Posix
+isEmpty(FREERTOS_POSIX_PORT): error("Set FREERTOS_POSIX_PORT to the FreeRTOS POSIX port directory")
+
+FIRMWARE = "$$PWD/../Torpedo - EFM32GG"
+KERNEL = "$$FIRMWARE/FreeRTOS"
+
+# The simulated SDK headers come first, shadowing the drivers of the board
+INCLUDEPATH += \
+    "$$PWD" \
+    "$$PWD/emlib" \
+    "$$FIRMWARE/src" \
+    "$$KERNEL/include" \
+    "$$FREERTOS_POSIX_PORT" \
+    "$$FREERTOS_POSIX_PORT/utils"
+
+SOURCES += \
+    sil_board.c \
+    sil_uart.c \
+    sil_lcd.c \
+    sil_timer.c \
+    sil_flash.c \
+    "$$FIRMWARE/src/animation.c" \
+    "$$FIRMWARE/src/event_trace.c" \
+    "$$FIRMWARE/src/game_core.c" \
+    "$$FIRMWARE/src/game_logic.c" \
+    "$$FIRMWARE/src/graphics.c" \
+    "$$FIRMWARE/src/history.c" \
+    "$$FIRMWARE/src/input.c" \
+    "$$FIRMWARE/src/link.c" \
+    "$$FIRMWARE/src/low_power.c" \
+    "$$FIRMWARE/src/main.c" \
+    "$$FIRMWARE/src/runtime_stats.c" \
+    "$$FIRMWARE/src/statistics.c" \
+    "$$FIRMWARE/src/tick_suppression.c" \
+    "$$FIRMWARE/drivers/lcd/segmentlcd_individual.c" \
+    "$$KERNEL/tasks.c" \
+    "$$KERNEL/queue.c" \
+    "$$KERNEL/list.c" \
+    "$$KERNEL/timers.c" \
+    "$$KERNEL/event_groups.c" \
+    "$$KERNEL/stream_buffer.c" \
+    "$$KERNEL/croutine.c" \
+    "$$FREERTOS_POSIX_PORT/port.c" \
+    "$$FREERTOS_POSIX_PORT/utils/wait_for_event.c"
+
+HEADERS += \
+    sil_board.h \
+    FreeRTOSConfig.h \
+    emlib/em_assert.h \
+    emlib/em_chip.h \
+    emlib/em_cmu.h \
+    emlib/em_device.h \
+    emlib/em_gpio.h \
+    emlib/em_lcd.h \
+    emlib/em_msc.h \
+    emlib/em_timer.h \
+    emlib/em_usart.h \
+    emlib/segmentlcd.h
+
+# The zero-heap build, qmake CONFIG+=zero_heap, creates every kernel object
+# statically and links without a heap, like the Static configuration of the board
+zero_heap {
+    DEFINES += configSUPPORT_STATIC_ALLOCATION=1
+} else {
+    SOURCES += "$$KERNEL/portable/MemMang/heap_3.c"
+}
+
+# The firmware declares its shared globals in the headers
+QMAKE_CFLAGS += -fcommon
+
+LIBS += \
+    -pthread
@@ -0,0 +1,212 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    sil_board.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   The simulated EFM32GG board running the firmware as a Linux process on the FreeRTOS POSIX port.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Board includes
+#include "em_assert.h"
+#include "em_chip.h"
+#include "em_cmu.h"
+#include "em_gpio.h"
+
+// Project includes
+#include "sil_board.h"
+
+
+/**
+ * @brief The task serving the simulated interrupts.
+ */
+TaskHandle_t silInterruptTask = NULL;
+
+/**
+ * @brief The enabled and the pending interrupts of the simulated NVIC,
+ *        one bit for each interrupt number.
+ */
+static uint64_t enabledInterrupts = 0;
+static uint64_t pendingInterrupts = 0;
+
+/**
+ * @brief Serves the interrupts enabled without a handler in the firmware,
+ *        the default handler of the board loops forever.
+ */
+static void defaultHandler(void) {
+    fprintf(stderr, "Error: Unexpected interrupt.\n");
+    abort();
+}
+
+/**
+ * @brief The interrupt handlers of the firmware, the ones not compiled
+ *        into the firmware fall back to the default handler.
+ */
+void GPIO_EVEN_IRQHandler(void) __attribute__((weak, alias("defaultHandler")));
+void GPIO_ODD_IRQHandler(void) __attribute__((weak, alias("defaultHandler")));
+void TIMER1_IRQHandler(void) __attribute__((weak, alias("defaultHandler")));
+void UART0_RX_IRQHandler(void) __attribute__((weak, alias("defaultHandler")));
+void RTC_IRQHandler(void) __attribute__((weak, alias("defaultHandler")));
+void LCD_IRQHandler(void) __attribute__((weak, alias("defaultHandler")));
+
+/**
+ * @brief The vector table of the simulated NVIC.
+ */
+static void (*const vectorTable[SIL_IRQ_COUNT])(void) = {
+    [GPIO_EVEN_IRQn] = GPIO_EVEN_IRQHandler,
+    [GPIO_ODD_IRQn] = GPIO_ODD_IRQHandler,
+    [TIMER1_IRQn] = TIMER1_IRQHandler,
+    [UART0_RX_IRQn] = UART0_RX_IRQHandler,
+    [RTC_IRQn] = RTC_IRQHandler,
+    [LCD_IRQn] = LCD_IRQHandler
+};
+
+uint64_t silMonotonicNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+bool silInterruptEnabled(IRQn_Type irq) {
+    return (__atomic_load_n(&enabledInterrupts, __ATOMIC_SEQ_CST) >> irq) & 1;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq) {
+    __atomic_fetch_or(&enabledInterrupts, 1ULL << irq, __ATOMIC_SEQ_CST);
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq) {
+    __atomic_fetch_and(&enabledInterrupts, ~(1ULL << irq), __ATOMIC_SEQ_CST);
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type irq) {
+    __atomic_fetch_or(&pendingInterrupts, 1ULL << irq, __ATOMIC_SEQ_CST);
+
+    // Serving the interrupt without waiting for the next tick, when pended by a task.
+    // The tasks share the priority of the interrupt task, so the caller yields to it.
+    if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING && xTaskGetCurrentTaskHandle() != silInterruptTask) {
+        xTaskNotifyGive(silInterruptTask);
+        taskYIELD();
+    }
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq) {
+    __atomic_fetch_and(&pendingInterrupts, ~(1ULL << irq), __ATOMIC_SEQ_CST);
+}
+
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) {
+    // Every simulated interrupt runs at the same priority
+}
+
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable) {
+    // The simulated peripherals are always clocked
+}
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out) {
+    // The UART pins are connected to the pseudo terminal
+}
+
+void GPIO_IntConfig(GPIO_Port_TypeDef port, unsigned int pin, bool risingEdge, bool fallingEdge, bool enable) {
+    // The pin interrupts only wake the board from sleep
+}
+
+void GPIO_IntClear(uint32_t flags) {
+    // The pin interrupts only wake the board from sleep
+}
+
+void assertEFM(const char *file, int line) {
+    fprintf(stderr, "Error: Assertion failed at %s:%d.\n", file, line);
+    abort();
+}
+
+/**
+ * @brief Calls the handlers of the pending and enabled interrupts,
+ *        the lowest interrupt number first, like the NVIC.
+ */
+static void serveInterrupts(void) {
+
+    uint64_t ready;
+    while((ready = __atomic_load_n(&pendingInterrupts, __ATOMIC_SEQ_CST) &
+                   __atomic_load_n(&enabledInterrupts, __ATOMIC_SEQ_CST)) != 0) {
+
+        IRQn_Type irq = __builtin_ctzll(ready);
+        NVIC_ClearPendingIRQ(irq);
+
+        if(vectorTable[irq] != NULL) {
+            vectorTable[irq]();
+        } else {
+            defaultHandler();
+        }
+    }
+}
+
+/**
+ * @brief  The task serving the simulated interrupts.
+ * @param  [in] The parameters of the task (unused).
+ */
+static void prvInterruptTask(void *prvParam) {
+
+    while(1) {
+
+        // Advancing the peripherals to the current tick
+        pollSimulatedUart();
+        pollSimulatedLcd(xTaskGetTickCount());
+        pollSimulatedTimer();
+
+        // Running the handlers without preemption by the tasks, like on the board
+        vTaskSuspendAll();
+        serveInterrupts();
+        xTaskResumeAll();
+
+        // Sleeping until the next tick, or until a task pends an interrupt
+        ulTaskNotifyTake(pdTRUE, 1);
+    }
+}
+
+void CHIP_Init(void) {
+
+    // Connecting the peripherals to the host
+    initSimulatedUart();
+    initSimulatedLcd();
+    initSimulatedFlash();
+
+    // Creating the interrupt task, started with the tasks of the firmware
+#if configSUPPORT_STATIC_ALLOCATION
+    static StackType_t interruptStack[configMINIMAL_STACK_SIZE];
+    static StaticTask_t interruptTCB;
+
+    silInterruptTask = xTaskCreateStatic(prvInterruptTask, "SIL_IRQ", configMINIMAL_STACK_SIZE, NULL,
+                                         SIL_INTERRUPT_TASK_PRIORITY, interruptStack, &interruptTCB);
+#else
+    xTaskCreate(prvInterruptTask, "SIL_IRQ", configMINIMAL_STACK_SIZE, NULL,
+                SIL_INTERRUPT_TASK_PRIORITY, &silInterruptTask);
+#endif
+}
@@ -0,0 +1,135 @@
+#pragma once
+#ifndef SIL_BOARD_H
+#define SIL_BOARD_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    sil_board.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   The simulated EFM32GG board running the firmware as a Linux process on the FreeRTOS POSIX port.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// FreeRTOS includes
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Project includes
+#include "em_device.h"
+
+
+/**
+ * @brief The priority of the task serving the simulated interrupts, the
+ *        highest priority of the kernel. The priorities of the firmware
+ *        tasks are capped to the same priority by the kernel.
+ */
+#define SIL_INTERRUPT_TASK_PRIORITY     (configMAX_PRIORITIES - 1)
+
+/**
+ * @brief The environment variable naming a symbolic link created to the
+ *        pseudo terminal of UART0, e.g. for pep_hf_unix -p.
+ */
+#define SIL_LINK_ENV                    "PEP_HF_SIL_LINK"
+
+/**
+ * @brief The environment variable naming the file every frame shown
+ *        by the simulated LCD is logged to.
+ */
+#define SIL_LCD_LOG_ENV                 "PEP_HF_SIL_LCD"
+
+/**
+ * @brief The environment variable naming the file the simulated flash is
+ *        kept in between runs. Without it the flash starts erased.
+ */
+#define SIL_FLASH_ENV                   "PEP_HF_SIL_FLASH"
+
+/**
+ * @brief The task serving the simulated interrupts.
+ * @details The POSIX port has no interrupts besides the tick, so the
+ *          peripherals are advanced by this task on every kernel tick.
+ *          The handlers of the pending interrupts run with the scheduler
+ *          suspended: like on the board, no task runs in between, and
+ *          the context switch requested by portYIELD_FROM_ISR() happens
+ *          when the handlers return.
+ */
+extern TaskHandle_t silInterruptTask;
+
+/**
+ * @brief  Returns the monotonic time of the host in nanoseconds.
+ * @return The time in nanoseconds.
+ */
+uint64_t silMonotonicNs(void);
+
+/**
+ * @brief  Returns whether the interrupt is enabled in the simulated NVIC.
+ * @param  [in] The interrupt.
+ * @return True if the interrupt is enabled.
+ */
+bool silInterruptEnabled(IRQn_Type irq);
+
+/**
+ * @brief Opens the pseudo terminal of UART0.
+ */
+void initSimulatedUart(void);
+
+/**
+ * @brief Receives the bytes arriving on UART0 since the last poll,
+ *        at most as many as the baud-rate allows.
+ */
+void pollSimulatedUart(void);
+
+/**
+ * @brief Opens the frame log of the LCD.
+ */
+void initSimulatedLcd(void);
+
+/**
+ * @brief Advances the frame counter and the animation of the LCD.
+ * @param [in] The current kernel tick.
+ */
+void pollSimulatedLcd(TickType_t tick);
+
+/**
+ * @brief Raises the overflow interrupt of TIMER1.
+ */
+void pollSimulatedTimer(void);
+
+/**
+ * @brief The number of erases of each page of the simulated flash since the start.
+ */
+extern uint32_t silFlashEraseCounts[FLASH_SIZE / FLASH_PAGE_SIZE];
+
+/**
+ * @brief Loads the simulated flash from its file, or erases it.
+ */
+void initSimulatedFlash(void);
+
+#endif // SIL_BOARD_H
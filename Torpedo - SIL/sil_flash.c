@@ -0,0 +1,194 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    sil_flash.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated flash of the board, optionally kept in a file of the host between runs.
+ ********************************************************************************/
+
+// Standard includes
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Board includes
+#include "em_msc.h"
+
+// Project includes
+#include "sil_board.h"
+
+
+/**
+ * @brief The number of pages of the simulated flash.
+ */
+#define SIL_FLASH_PAGE_COUNT    (FLASH_SIZE / FLASH_PAGE_SIZE)
+
+/**
+ * @brief The content of the simulated flash.
+ */
+uint32_t silFlash[FLASH_SIZE / sizeof(uint32_t)];
+
+/**
+ * @brief The file the flash is kept in, -1 if not requested.
+ */
+static int flashFd = -1;
+
+/**
+ * @brief Indicating whether writing and erasing is enabled by MSC_Init().
+ */
+static bool flashUnlocked = false;
+
+/**
+ * @brief The number of erases of each page since the start.
+ */
+uint32_t silFlashEraseCounts[SIL_FLASH_PAGE_COUNT];
+
+/**
+ * @brief Writes a changed range of the flash to its file.
+ * @param [in] The first changed word.
+ * @param [in] The number of changed bytes.
+ */
+static void storeFlash(const uint32_t *start, uint32_t numBytes) {
+
+    if(flashFd < 0) {
+        return;
+    }
+
+    off_t offset = (const uint8_t *) start - (const uint8_t *) silFlash;
+    if(pwrite(flashFd, start, numBytes, offset) != (ssize_t) numBytes) {
+        fprintf(stderr, "Error: Could not write the flash file: %s\n", strerror(errno));
+    }
+}
+
+/**
+ * @brief   Checks an operation on the flash, like the memory system controller.
+ * @param   [in] The word aligned address in the flash.
+ * @param   [in] The number of bytes, a multiple of 4.
+ * @returns mscReturnOk if the operation is allowed, the reason of the failure otherwise.
+ */
+static MSC_Status_TypeDef checkOperation(const uint32_t *address, uint32_t numBytes) {
+
+    uintptr_t offset = (uintptr_t) address - (uintptr_t) silFlash;
+
+    if(!flashUnlocked) {
+        return mscReturnLocked;
+    }
+    if((uintptr_t) address % sizeof(uint32_t) != 0 || numBytes % sizeof(uint32_t) != 0) {
+        return mscReturnUnaligned;
+    }
+    if((uintptr_t) address < (uintptr_t) silFlash || offset + numBytes > sizeof(silFlash)) {
+        return mscReturnInvalidAddr;
+    }
+
+    return mscReturnOk;
+}
+
+void initSimulatedFlash(void) {
+
+    // The flash of a new board is erased
+    memset(silFlash, 0xFF, sizeof(silFlash));
+
+    const char *path = getenv(SIL_FLASH_ENV);
+    if(path == NULL) {
+        return;
+    }
+
+    flashFd = open(path, O_RDWR | O_CREAT, 0644);
+    if(flashFd < 0) {
+        fprintf(stderr, "Error: Could not open %s: %s\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    // Loading the flash of the previous runs, a new file stays erased
+    if(pread(flashFd, silFlash, sizeof(silFlash), 0) < 0) {
+        fprintf(stderr, "Error: Could not read %s: %s\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("INFO: The flash is kept in %s\n", path);
+}
+
+void MSC_Init(void) {
+    flashUnlocked = true;
+}
+
+void MSC_Deinit(void) {
+    flashUnlocked = false;
+}
+
+MSC_Status_TypeDef MSC_WriteWord(uint32_t *address, void const *data, uint32_t numBytes) {
+
+    MSC_Status_TypeDef status = checkOperation(address, numBytes);
+    if(status != mscReturnOk) {
+        return status;
+    }
+
+    for(uint32_t i = 0; i < numBytes / sizeof(uint32_t); i++) {
+
+        uint32_t word;
+        memcpy(&word, (const uint8_t *) data + i * sizeof(uint32_t), sizeof(word));
+
+        // Reporting the words the firmware writes again without an erase
+        if(address[i] != 0xFFFFFFFFUL) {
+            fprintf(stderr, "Error: Flash word at offset 0x%lx written twice without an erase.\n",
+                    (unsigned long) ((uintptr_t) &address[i] - (uintptr_t) silFlash));
+        }
+
+        // Programming can only clear bits
+        address[i] &= word;
+    }
+
+    storeFlash(address, numBytes);
+    return mscReturnOk;
+}
+
+MSC_Status_TypeDef MSC_ErasePage(uint32_t *startAddress) {
+
+    MSC_Status_TypeDef status = checkOperation(startAddress, FLASH_PAGE_SIZE);
+    if(status != mscReturnOk) {
+        return status;
+    }
+
+    uintptr_t offset = (uintptr_t) startAddress - (uintptr_t) silFlash;
+    if(offset % FLASH_PAGE_SIZE != 0) {
+        return mscReturnInvalidAddr;
+    }
+
+    memset(startAddress, 0xFF, FLASH_PAGE_SIZE);
+    storeFlash(startAddress, FLASH_PAGE_SIZE);
+
+    // Reporting the wear of the page
+    uint32_t page = offset / FLASH_PAGE_SIZE;
+    silFlashEraseCounts[page]++;
+    printf("INFO: Flash page %lu erased, %lu erases since the start\n",
+           (unsigned long) page, (unsigned long) silFlashEraseCounts[page]);
+
+    return mscReturnOk;
+}
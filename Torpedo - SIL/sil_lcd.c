@@ -0,0 +1,277 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    sil_lcd.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated LCD controller, rendering the segment registers into an inspectable framebuffer.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Board includes
+#include "em_lcd.h"
+#include "segmentlcd.h"
+#include "../drivers/lcd/segmentlcd_individual.h"
+
+// Project includes
+#include "sil_board.h"
+
+
+/**
+ * @brief The state of the simulated LCD.
+ */
+SIL_LCD_TypeDef silLcd;
+
+/**
+ * @brief The frame log, NULL if not requested, and the last logged frame.
+ */
+static FILE *frameLog = NULL;
+static char loggedFrame[64];
+
+/**
+ * @brief The frames shown since the last frame counter event, and
+ *        the number of the last frame shown.
+ */
+static uint32_t framesCounted;
+static uint64_t lastFrame;
+
+/**
+ * @brief  Returns the character shown by a digit of the upper display.
+ * @param  [in] The 7-segment pattern, segment A in bit 0.
+ * @return The character, '?' for unknown patterns.
+ */
+static char upperCharacter(uint8_t pattern) {
+
+    static const uint8_t digits[10] = {0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F};
+
+    for(int i = 0; i < 10; i++) {
+        if(digits[i] == pattern) return '0' + i;
+    }
+
+    return pattern == 0 ? ' ' : pattern == 0x40 ? '-' : '?';
+}
+
+/**
+ * @brief  Returns the state of a segment in the shown frame.
+ * @param  [in] The location of the segment.
+ * @return True if the segment is lit.
+ */
+static bool segmentLit(const SegmentLCD_SegmentLocation_TypeDef *location) {
+    return silLcd.displayed[location->com][location->high] & location->mask;
+}
+
+/**
+ * @brief Writes the shown frame to the log if it changed: the tick, the
+ *        upper digits, the lit segments of every lower character in hex,
+ *        and the segments of the ring.
+ * @param [in] The current kernel tick.
+ */
+static void logFrame(TickType_t tick) {
+
+    char frame[sizeof(loggedFrame)];
+    int length = 0;
+
+    for(int c = 0; c < SEGMENT_LCD_NUM_OF_UPPER_CHARS; c++) {
+        uint8_t pattern = 0;
+        for(int s = 0; s < 7; s++) {
+            SegmentLCD_SegmentLocation_TypeDef location;
+            SegmentLCD_UpperSegmentLocation(c, s, &location);
+            if(segmentLit(&location)) pattern |= 1 << s;
+        }
+        // Digit 0 is the rightmost one
+        frame[SEGMENT_LCD_NUM_OF_UPPER_CHARS - 1 - c] = upperCharacter(pattern);
+    }
+    length = SEGMENT_LCD_NUM_OF_UPPER_CHARS;
+
+    for(int c = 0; c < SEGMENT_LCD_NUM_OF_LOWER_CHARS; c++) {
+        uint16_t segments = 0;
+        for(int s = 0; s < 14; s++) {
+            SegmentLCD_SegmentLocation_TypeDef location;
+            SegmentLCD_LowerSegmentLocation(c, s, &location);
+            if(segmentLit(&location)) segments |= 1 << s;
+        }
+        length += sprintf(&frame[length], " %04x", segments);
+    }
+
+    uint8_t ring = 0;
+    if(silLcd.animationEnabled) {
+        ring = silLcd.animation.animLogic == lcdAnimLogicAnd ? silLcd.animationA & silLcd.animationB
+                                                             : silLcd.animationA | silLcd.animationB;
+    }
+    sprintf(&frame[length], " ring %02x", ring);
+
+    // Logging only the changes
+    if(strcmp(frame, loggedFrame) != 0) {
+        strcpy(loggedFrame, frame);
+        fprintf(frameLog, "%10lu %s\n", (unsigned long) tick, frame);
+        fflush(frameLog);
+    }
+}
+
+/**
+ * @brief  Rotates an animation register by one step.
+ * @param  [in] The register.
+ * @param  [in] The direction.
+ * @return The rotated register.
+ */
+static uint8_t rotateAnimation(uint8_t reg, LCD_AnimShift_TypeDef shift) {
+    switch(shift) {
+        case lcdAnimShiftLeft:  return (uint8_t)(reg << 1 | reg >> 7);
+        case lcdAnimShiftRight: return (uint8_t)(reg >> 1 | reg << 7);
+        default:                return reg;
+    }
+}
+
+void initSimulatedLcd(void) {
+
+    const char *path = getenv(SIL_LCD_LOG_ENV);
+    if(path == NULL) {
+        return;
+    }
+
+    frameLog = fopen(path, "w");
+    if(frameLog == NULL) {
+        fprintf(stderr, "Error: Could not open %s.\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    printf("INFO: LCD frames are logged to %s\n", path);
+}
+
+void pollSimulatedLcd(TickType_t tick) {
+
+    // Showing the registers on the next frame, unless frozen
+    if(!silLcd.frozen) {
+        memcpy(silLcd.displayed, silLcd.segd, sizeof(silLcd.displayed));
+    }
+
+    // Counting the frames shown since the last poll
+    uint64_t frame = (uint64_t) tick * SIL_LCD_FRAME_RATE_HZ / configTICK_RATE_HZ;
+    uint32_t period = (silLcd.frameCount.top + 1) << silLcd.frameCount.prescale;
+    bool event = false;
+
+    for(; lastFrame < frame; lastFrame++) {
+
+        if(!silLcd.frameCount.enable || ++framesCounted < period) {
+            continue;
+        }
+        framesCounted = 0;
+        event = true;
+
+        // Stepping the animation on every frame counter event
+        if(silLcd.animationEnabled) {
+            silLcd.animationA = rotateAnimation(silLcd.animationA, silLcd.animation.AShift);
+            silLcd.animationB = rotateAnimation(silLcd.animationB, silLcd.animation.BShift);
+        }
+    }
+
+    // Raising the frame counter interrupt, events missed in between are merged
+    if(event) {
+        silLcd.flags |= LCD_IF_FC;
+        if(silLcd.ien & LCD_IEN_FC) {
+            NVIC_SetPendingIRQ(LCD_IRQn);
+        }
+    }
+
+    if(frameLog != NULL) {
+        logFrame(tick);
+    }
+}
+
+void LCD_FrameCountInit(const LCD_FrameCountInit_TypeDef *fcInit) {
+    silLcd.frameCount = *fcInit;
+    framesCounted = 0;
+}
+
+void LCD_AnimInit(const LCD_AnimInit_TypeDef *animInit) {
+    silLcd.animation = *animInit;
+    silLcd.animationA = animInit->AReg;
+    silLcd.animationB = animInit->BReg;
+    silLcd.animationEnabled = animInit->enable;
+}
+
+void LCD_AnimEnable(bool enable) {
+    silLcd.animationEnabled = enable;
+}
+
+void LCD_SegmentSet(int com, int bit, bool enable) {
+
+    uint32_t mask = 1UL << (bit & 31);
+
+    if(enable) {
+        silLcd.segd[com][bit >> 5] |= mask;
+    } else {
+        silLcd.segd[com][bit >> 5] &= ~mask;
+    }
+}
+
+void LCD_SegmentSetLow(int com, uint32_t mask, uint32_t bits) {
+    silLcd.segd[com][0] = (silLcd.segd[com][0] & ~mask) | (bits & mask);
+}
+
+void LCD_SegmentSetHigh(int com, uint32_t mask, uint32_t bits) {
+    silLcd.segd[com][1] = (silLcd.segd[com][1] & ~mask) | (bits & mask);
+}
+
+void LCD_FreezeEnable(bool enable) {
+    silLcd.frozen = enable;
+}
+
+uint32_t LCD_SyncBusyGet(void) {
+    // The registers are written immediately
+    return 0;
+}
+
+void LCD_SyncBusyDelay(uint32_t flags) {
+    // The registers are written immediately
+}
+
+uint32_t LCD_IntGet(void) {
+    return silLcd.flags;
+}
+
+void LCD_IntEnable(uint32_t flags) {
+    silLcd.ien |= flags;
+}
+
+void LCD_IntDisable(uint32_t flags) {
+    silLcd.ien &= ~flags;
+}
+
+void LCD_IntClear(uint32_t flags) {
+    silLcd.flags &= ~flags;
+}
+
+void SegmentLCD_Init(bool useBoost) {
+
+    // Clearing the display
+    memset(silLcd.segd, 0, sizeof(silLcd.segd));
+    memset(silLcd.displayed, 0, sizeof(silLcd.displayed));
+}
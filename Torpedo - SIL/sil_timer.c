@@ -0,0 +1,93 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    sil_timer.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated TIMER1 of the board, counting the monotonic time of the host.
+ ********************************************************************************/
+
+// Board includes
+#include "em_timer.h"
+
+// Project includes
+#include "sil_board.h"
+
+
+/**
+ * @brief The registers of TIMER1.
+ */
+TIMER_TypeDef silTimer1;
+
+/**
+ * @brief The number of counter overflows raised so far.
+ */
+static uint64_t overflows;
+
+/**
+ * @brief  Returns the counter of the timer, extended to 64 bits.
+ * @param  [in] The timer.
+ * @return The counter.
+ */
+static uint64_t extendedCounter(TIMER_TypeDef *timer) {
+    return silMonotonicNs() * (SIL_TIMER_CLOCK_HZ / 1000000) / 1000 >> timer->CTRL;
+}
+
+void pollSimulatedTimer(void) {
+
+    // Raising one interrupt for the wraps since the last poll
+    uint64_t wraps = extendedCounter(TIMER1) >> 16;
+    if(wraps == overflows) {
+        return;
+    }
+    overflows = wraps;
+
+    TIMER1->IF |= TIMER_IF_OF;
+    if(TIMER1->IEN & TIMER_IEN_OF) {
+        NVIC_SetPendingIRQ(TIMER1_IRQn);
+    }
+}
+
+void TIMER_Init(TIMER_TypeDef *timer, const TIMER_Init_TypeDef *init) {
+    timer->CTRL = init->prescale;
+    overflows = extendedCounter(timer) >> 16;
+}
+
+void TIMER_IntClear(TIMER_TypeDef *timer, uint32_t flags) {
+    timer->IF &= ~flags;
+}
+
+void TIMER_IntEnable(TIMER_TypeDef *timer, uint32_t flags) {
+    timer->IEN |= flags;
+}
+
+uint32_t TIMER_IntGet(TIMER_TypeDef *timer) {
+    return timer->IF;
+}
+
+uint32_t TIMER_CounterGet(TIMER_TypeDef *timer) {
+    return extendedCounter(timer) & 0xFFFF;
+}
@@ -0,0 +1,237 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    sil_uart.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated UART0 of the board, connected to a pseudo terminal of the host.
+ ********************************************************************************/
+
+// Standard includes
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Board includes
+#include "em_usart.h"
+
+// Project includes
+#include "sil_board.h"
+
+
+/**
+ * @brief The depth of the receive FIFO. The UART of the board buffers
+ *        2 bytes, the simulation buffers the bytes of a few ticks, so
+ *        a late poll of the interrupt task does not drop input.
+ */
+#define SIL_UART_FIFO_SIZE      (128)
+
+/**
+ * @brief The bits transferred for each byte: start, 8 data and stop bits.
+ */
+#define SIL_UART_FRAME_BITS     (10)
+
+/**
+ * @brief The registers of UART0.
+ */
+USART_TypeDef silUart0;
+
+/**
+ * @brief The master side of the pseudo terminal, and the slave side
+ *        kept open so the terminal survives the host disconnecting.
+ */
+static int masterFd = -1;
+static int slaveFd = -1;
+
+/**
+ * @brief The receive FIFO, only accessed by the interrupt task
+ *        and the handler it calls.
+ */
+static uint8_t rxFifo[SIL_UART_FIFO_SIZE];
+static uint32_t rxHead;
+static uint32_t rxTail;
+
+/**
+ * @brief The baud-rate set by the firmware, the receive credit in
+ *        bytes scaled by the tick rate, and the time of the last poll.
+ */
+static uint32_t uartBaudrate = 115200;
+static uint64_t rxCredit;
+static TickType_t lastPollTick;
+
+/**
+ * @brief The time the transmitter finishes the last written byte.
+ */
+static uint64_t txIdleNs;
+
+void initSimulatedUart(void) {
+
+    // Opening a pseudo terminal
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if(masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0) {
+        fprintf(stderr, "Error: Could not open a pseudo terminal: %s\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    const char *slaveName = ptsname(masterFd);
+
+    // Keeping the slave open in raw mode, the host client opens it again
+    slaveFd = open(slaveName, O_RDWR | O_NOCTTY);
+    if(slaveFd < 0) {
+        fprintf(stderr, "Error: Could not open %s: %s\n", slaveName, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    struct termios settings;
+    tcgetattr(slaveFd, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(slaveFd, TCSANOW, &settings);
+
+    // The interrupt task polls the master
+    fcntl(masterFd, F_SETFL, fcntl(masterFd, F_GETFL) | O_NONBLOCK);
+
+    printf("INFO: UART0 is connected to %s\n", slaveName);
+
+    // Linking the terminal to a known path
+    const char *link = getenv(SIL_LINK_ENV);
+    if(link != NULL) {
+        unlink(link);
+        if(symlink(slaveName, link) != 0) {
+            fprintf(stderr, "Error: Could not link %s: %s\n", link, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+        printf("INFO: UART0 is linked to %s\n", link);
+    }
+
+    fflush(stdout);
+}
+
+void pollSimulatedUart(void) {
+
+    // Gaining the bytes transferable at the baud-rate since the last poll
+    TickType_t tick = xTaskGetTickCount();
+    rxCredit += (uint64_t)(TickType_t)(tick - lastPollTick) * uartBaudrate / SIL_UART_FRAME_BITS;
+    lastPollTick = tick;
+
+    uint32_t free = SIL_UART_FIFO_SIZE - (rxHead - rxTail);
+    uint64_t allowed = rxCredit / configTICK_RATE_HZ;
+    if(allowed > free) allowed = free;
+
+    // Receiving into the FIFO, the unused credit does not accumulate while idle
+    uint32_t received = 0;
+    while(received < allowed) {
+        uint8_t buffer[SIL_UART_FIFO_SIZE];
+        ssize_t length = read(masterFd, buffer, allowed - received);
+        if(length <= 0) break;
+
+        for(ssize_t i = 0; i < length; i++) {
+            rxFifo[rxHead++ & (SIL_UART_FIFO_SIZE - 1)] = buffer[i];
+        }
+        received += length;
+    }
+
+    rxCredit = received < allowed ? 0 : rxCredit - (uint64_t)received * configTICK_RATE_HZ;
+    if(rxCredit > (uint64_t)SIL_UART_FIFO_SIZE * configTICK_RATE_HZ) {
+        rxCredit = (uint64_t)SIL_UART_FIFO_SIZE * configTICK_RATE_HZ;
+    }
+
+    // Raising the receive interrupt while data is available
+    if(rxHead != rxTail) {
+        silUart0.IF |= UART_IF_RXDATAV;
+        if(silUart0.IEN & UART_IEN_RXDATAV) {
+            NVIC_SetPendingIRQ(UART0_RX_IRQn);
+        }
+    }
+}
+
+void USART_InitAsync(USART_TypeDef *usart, const USART_InitAsync_TypeDef *init) {
+    USART_BaudrateAsyncSet(usart, init->refFreq, init->baudrate, init->oversampling);
+}
+
+void USART_BaudrateAsyncSet(USART_TypeDef *usart, uint32_t refFreq, uint32_t baudrate, USART_OVS_TypeDef ovs) {
+    usart->CLKDIV = baudrate;
+    uartBaudrate = baudrate;
+}
+
+void USART_IntClear(USART_TypeDef *usart, uint32_t flags) {
+    usart->IF &= ~flags;
+}
+
+void USART_IntEnable(USART_TypeDef *usart, uint32_t flags) {
+    usart->IEN |= flags;
+}
+
+uint32_t USART_StatusGet(USART_TypeDef *usart) {
+
+    uint32_t status = 0;
+
+    if(rxHead != rxTail) {
+        status |= USART_STATUS_RXDATAV;
+    }
+
+    // The transmitter holds a single byte besides the shift register
+    uint64_t now = silMonotonicNs();
+    uint64_t byteNs = 1000000000ULL * SIL_UART_FRAME_BITS / uartBaudrate;
+
+    if(now >= txIdleNs) {
+        status |= USART_STATUS_TXC;
+    }
+    if(now + byteNs >= txIdleNs) {
+        status |= USART_STATUS_TXBL;
+    }
+
+    usart->STATUS = status;
+    return status;
+}
+
+uint8_t USART_RxDataGet(USART_TypeDef *usart) {
+
+    if(rxHead == rxTail) {
+        return 0;
+    }
+
+    return rxFifo[rxTail++ & (SIL_UART_FIFO_SIZE - 1)];
+}
+
+void USART_Tx(USART_TypeDef *usart, uint8_t data) {
+
+    // Waiting for the transmit buffer, like the emlib driver
+    while(!(USART_StatusGet(usart) & USART_STATUS_TXBL));
+
+    // Dropping the byte when nobody reads the terminal, like an unconnected wire
+    if(write(masterFd, &data, 1) != 1 && errno != EAGAIN) {
+        fprintf(stderr, "Error: Could not write UART0: %s\n", strerror(errno));
+    }
+
+    uint64_t now = silMonotonicNs();
+    uint64_t start = txIdleNs > now ? txIdleNs : now;
+    txIdleNs = start + 1000000000ULL * SIL_UART_FRAME_BITS / uartBaudrate;
+}
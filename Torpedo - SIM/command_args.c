@@ -0,0 +1,158 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    command_args.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Command line parsing implementation of the simulator.
+ ********************************************************************************/
+
+// Standard includes
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// Project includes
+#include "command_args.h"
+
+
+/**
+ * @brief  Parses the specified command line arguments into the options,
+ *         the options not specified are left unchanged.
+ * @param  [in] The number of arguments.
+ * @param  [in] The string array of arguments.
+ * @param  [out] The options of the simulator.
+ * @return 0 on success, -1 on an invalid argument.
+ */
+int parseCommandLine(int argc, char*const* argv, struct simOptions *options) {
+
+    // Identifier of the current argument
+    int opt = 0;
+
+    // Parsing command line arguments
+    while((opt = getopt(argc, argv, "hSn:j:r:s:k:t:m:")) != -1) {
+        switch(opt) {
+
+        // Printing program help
+        case 'h':
+            printHelp();
+            exit(EXIT_SUCCESS);
+
+        // Solving the optimal play instead of simulating
+        case 'S':
+            options->solve = 1;
+            break;
+
+        // Setting the number of games
+        case 'n':
+            options->games = strtoull(optarg, NULL, 0);
+            break;
+
+        // Setting the number of threads
+        case 'j':
+            if(atoi(optarg) < 1 || atoi(optarg) > SIM_MAX_THREADS) {
+                fprintf(stderr, "ERROR: The number of threads must be between 1 and %d!\n", SIM_MAX_THREADS);
+                return -1;
+            }
+            options->threads = atoi(optarg);
+            break;
+
+        // Setting the seed
+        case 'r':
+            options->seed = strtoull(optarg, NULL, 0);
+            break;
+
+        // Setting the strategy of the players
+        case 's':
+            if(parseStrategy(optarg, &options->strategy) != 0) {
+                fprintf(stderr, "ERROR: The strategy \"%s\" is unknown!\n", optarg);
+                return -1;
+            }
+            break;
+
+        // Setting the key script, selecting the script strategy
+        case 'k':
+            options->script = optarg;
+            options->strategy = ScriptStrategy;
+            break;
+
+        // Setting the tick period of the game
+        case 't':
+            if(atoi(optarg) < 1 || atoi(optarg) > 255) {
+                fprintf(stderr, "ERROR: The tick period must be between 1 and 255 ms!\n");
+                return -1;
+            }
+            options->tickPeriodMs = atoi(optarg);
+            break;
+
+        // Setting the tick limit of a game
+        case 'm':
+            options->maxTicks = strtoul(optarg, NULL, 0);
+            break;
+
+        default: return -1;
+        };
+    }
+
+    // Checking the script of the script strategy
+    if(options->strategy == ScriptStrategy && options->script == NULL) {
+        fprintf(stderr, "ERROR: The script strategy needs a key script (-k)!\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Prints the command line usage help to STDOUT.
+ */
+void printHelp(void) {
+    printf("                                                     \n"
+           "Torpedo simulator help:                              \n"
+           "-----------------------                              \n"
+           "-h: Prints this help.                                \n"
+           "-n <games>: Sets the number of simulated games.      \n"
+           "-j <threads>: Sets the number of threads (default:   \n"
+           "   one per core).                                    \n"
+           "-r <seed>: Sets the seed of the simulation.          \n"
+           "-s <strategy>: Sets the strategy of the players:     \n"
+           "   sweep, random, candidates (default), optimal or   \n"
+           "   script.                                           \n"
+           "-k <keys>: Replays the keys (w/a/s/d moves, space    \n"
+           "   fires) in every game, repeating them.             \n"
+           "-t <ms>: Sets the game tick period (default: 10 ms). \n"
+           "-m <ticks>: Sets the tick limit of a game.           \n"
+           "-S: Solves the optimal play and prints the shots it  \n"
+           "   takes on each map, instead of simulating.         \n"
+           "                                                     \n"
+           "The games run the game core of the firmware with     \n"
+           "simulated drivers and no sleeping. The results only  \n"
+           "depend on the seed, not on the number of threads.    \n"
+           "                                                     \n"
+           "Example usage:                                       \n"
+           "./pep_hf_sim -n 10000000 -s random -r 42           \n\n");
+}
@@ -0,0 +1,83 @@
+#pragma once
+#ifndef COMMAND_ARGS_H
+#define COMMAND_ARGS_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    command_args.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Command line argument parsing declarations of the simulator.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdint.h>
+
+// Project includes
+#include "strategy.h"
+
+
+/**
+ * @brief The default number of simulated games.
+ */
+#define SIM_DEFAULT_GAMES       (1000000)
+
+/**
+ * @brief The largest number of simulation threads.
+ */
+#define SIM_MAX_THREADS         (256)
+
+/**
+ * @brief This structure contains the options of the simulator.
+ */
+struct simOptions {
+    uint64_t games;             /**< The number of games to simulate            */
+    unsigned threads;           /**< The number of threads, 0 for one per core  */
+    uint64_t seed;              /**< The seed of the simulation                 */
+    StrategyType strategy;      /**< The strategy of the players                */
+    const char *script;         /**< The keys of ScriptStrategy                 */
+    uint8_t tickPeriodMs;       /**< The time between game ticks                */
+    uint32_t maxTicks;          /**< The tick limit of a game                   */
+    int solve;                  /**< Prints the optimal play table and exits    */
+};
+
+/**
+ * @brief  Parses the specified command line arguments into the options,
+ *         the options not specified are left unchanged.
+ * @param  [in] The number of arguments.
+ * @param  [in] The string array of arguments.
+ * @param  [out] The options of the simulator.
+ * @return 0 on success, -1 on an invalid argument.
+ */
+int parseCommandLine(int argc, char*const* argv, struct simOptions *options);
+
+/**
+ * @brief Prints the command line usage help to STDOUT.
+ */
+void printHelp(void);
+
+#endif // COMMAND_ARGS_H
@@ -0,0 +1,214 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    main.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Defines the entry point for the simulator.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+// Project includes
+#include "command_args.h"
+#include "simulator.h"
+#include "solver.h"
+
+
+/**
+ * @brief  Returns the monotonic time in seconds.
+ * @return The time in seconds.
+ */
+static double monotonicSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Prints the statistics of the simulated games per map.
+ * @param [in] The results of the simulation.
+ * @param [in] The time between game ticks in milliseconds.
+ */
+static void printResults(const struct simResults *results, uint8_t tickPeriodMs) {
+
+    printf("Map   Games         Shots    Ticks      Time [s]\n");
+
+    for(int i = 0; i < PREDEFINED_MAP_COUNT; i++) {
+        if(results->mapGames[i] == 0) continue;
+
+        double games = results->mapGames[i];
+        printf("%-5d %-13llu %-8.2f %-10.1f %.2f\n", i, (unsigned long long) results->mapGames[i],
+               results->mapShots[i] / games, results->mapTicks[i] / games,
+               results->mapTicks[i] * tickPeriodMs / games / 1000.0);
+    }
+
+    if(results->games != 0) {
+        double games = results->games;
+        printf("All   %-13llu %-8.2f %-10.1f %.2f\n", (unsigned long long) results->games,
+               results->shots / games, results->ticks / games,
+               results->ticks * tickPeriodMs / games / 1000.0);
+    }
+
+    if(results->unfinishedGames != 0) {
+        printf("Unfinished games: %llu\n", (unsigned long long) results->unfinishedGames);
+    }
+}
+
+/**
+ * @brief Prints the shots the optimal play takes on each map, firing
+ *        at the lowest optimal segment, and the fewest and most shots
+ *        over every choice between equally good segments.
+ */
+static void printDifficulty(void) {
+
+    printf("Map   Shots    Fewest   Most\n");
+
+    unsigned shots = 0;
+    for(uint8_t map = 0; map < PREDEFINED_MAP_COUNT; map++) {
+        uint8_t mapShots = optimalShotsOfMap(map);
+        uint8_t fewest, most;
+        optimalShotsRangeOfMap(map, &fewest, &most);
+
+        shots += mapShots;
+        printf("%-5u %-8u %-8u %u\n", map, mapShots, fewest, most);
+    }
+
+    printf("All   %-8.2f %.2f expected\n", (double) shots / PREDEFINED_MAP_COUNT,
+           SHIP_SEGMENTS_COUNT + expectedMisses(ALL_CANDIDATE_MAPS));
+}
+
+/**
+ * @brief   The entry point for the simulator.
+ * @details Splits the games between the simulation threads, waits
+ *          for them to join, and reports the merged statistics and
+ *          the simulation speed.
+ * @param   argc
+ * @param   argv
+ * @return  EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(int argc, char *argv[])
+{
+    // Command line parameters
+    struct simOptions options = {
+        .games = SIM_DEFAULT_GAMES,
+        .threads = 0,
+        .seed = 1,
+        .strategy = CandidateStrategy,
+        .script = NULL,
+        .tickPeriodMs = SIM_TICK_PERIOD_MS,
+        .maxTicks = SIM_MAX_GAME_TICKS,
+        .solve = 0
+    };
+
+    // Parsing command line
+    if(parseCommandLine(argc, argv, &options) != 0) {
+        printHelp();
+        exit(EXIT_FAILURE);
+    }
+
+    // Indexing the predefined maps for the players and the solver
+    initMapSolver();
+
+    // Running a thread on every core by default
+    if(options.threads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        options.threads = cores < 1 ? 1 : cores > SIM_MAX_THREADS ? SIM_MAX_THREADS : cores;
+    }
+
+    // Solving the optimal play for the solver and the optimal strategy
+    if(options.solve || options.strategy == OptimalStrategy) {
+        double solveStart = monotonicSeconds();
+        solveOptimalPlay(options.threads);
+        printf("INFO: Solved the optimal play of %lu candidate sets in %.3f s\n",
+               CANDIDATE_SET_COUNT, monotonicSeconds() - solveStart);
+    }
+
+    if(options.solve) {
+        printDifficulty();
+        exit(EXIT_SUCCESS);
+    }
+
+    printf("INFO: Simulating %llu games with the %s strategy on %u threads, seed %llu\n",
+           (unsigned long long) options.games, strategyName(options.strategy), options.threads,
+           (unsigned long long) options.seed);
+    printf("INFO: Board of %d digits of %d segments\n", LCD_DIGITS_COUNT, LCD_LOWER_SEGMENTS_COUNT);
+
+    // The threads executing the simulation and their parameters
+    pthread_t simulationTasks[SIM_MAX_THREADS];
+    struct simulationParams sParams[SIM_MAX_THREADS];
+
+    double startTime = monotonicSeconds();
+
+    for(unsigned i = 0; i < options.threads; i++) {
+
+        // Assembling parameters for the simulation task, splitting the games evenly
+        sParams[i].strategy = options.strategy;
+        sParams[i].script = options.script;
+        sParams[i].seed = options.seed;
+        sParams[i].firstGame = options.games * i / options.threads;
+        sParams[i].gameCount = options.games * (i + 1) / options.threads - sParams[i].firstGame;
+        sParams[i].tickPeriodMs = options.tickPeriodMs;
+        sParams[i].maxTicks = options.maxTicks;
+
+        // Creating the simulation task
+        if(pthread_create(&simulationTasks[i], NULL, simulationTaskFunction, (void*) &sParams[i]) != 0) {
+            fprintf(stderr, "Error: The simulation thread can not be created.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Waiting for the simulation tasks and merging their results
+    struct simResults results;
+    memset(&results, 0, sizeof(results));
+
+    for(unsigned i = 0; i < options.threads; i++) {
+        pthread_join(simulationTasks[i], NULL);
+        mergeResults(&results, &sParams[i].results);
+    }
+
+    double elapsed = monotonicSeconds() - startTime;
+
+    // Printing the statistics and the benchmark
+    printResults(&results, options.tickPeriodMs);
+    printf("Wall time: %.3f s\n", elapsed);
+    printf("Simulated games per second: %.0f\n", (results.games + results.unfinishedGames) / elapsed);
+
+    // The cost of a tick includes the simulated drivers and the player
+    if(results.updates != 0) {
+        printf("Executed game ticks: %llu, %.1f ns CPU time per tick\n", (unsigned long long) results.updates,
+               results.cpuSeconds * 1e9 / results.updates);
+    }
+
+    // Exit with success
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,30 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += \
+    "$$PWD/../Torpedo - EFM32GG/src"
+
+SOURCES += main.c \
+    simulator.c \
+    strategy.c \
+    solver.c \
+    command_args.c \
+    "$$PWD/../Torpedo - EFM32GG/src/game_core.c" \
+    "$$PWD/../Torpedo - EFM32GG/src/map_solver.c"
+
+HEADERS += \
+    simulator.h \
+    strategy.h \
+    solver.h \
+    command_args.h \
+    "$$PWD/../Torpedo - EFM32GG/src/game_core.h" \
+    "$$PWD/../Torpedo - EFM32GG/src/map_solver.h"
+
+LIBS += \
+    -pthread
+
+# The geometry of the virtual board, e.g. qmake BOARD_DIGITS=1000
+!isEmpty(BOARD_DIGITS): DEFINES += LCD_DIGITS_COUNT=$$BOARD_DIGITS
+!isEmpty(BOARD_SEGMENTS): DEFINES += LCD_LOWER_SEGMENTS_COUNT=$$BOARD_SEGMENTS
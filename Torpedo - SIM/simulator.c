@@ -0,0 +1,220 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    simulator.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated drivers running the game core of the firmware on the host.
+ ********************************************************************************/
+
+// Standard includes
+#include <string.h>
+#include <time.h>
+
+// Project includes
+#include "simulator.h"
+
+
+/**
+ * @brief  Returns the n-th value of the splitmix64 sequence of the seed,
+ *         used to derive independent seeds for every game.
+ * @param  [in] The seed of the simulation.
+ * @param  [in] The index of the value.
+ * @return The random value.
+ */
+static uint64_t mixSeed(uint64_t seed, uint64_t n) {
+    uint64_t z = seed + (n + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static void prepareSimulation(GameContext *game) {
+
+    struct simGame *sim = game->driverData;
+
+    // Starting the new game with an empty input queue
+    sim->planLength = 0;
+    sim->planPosition = 0;
+    sim->animationEndTick = 0;
+}
+
+static bool readSimulatedAction(GameContext *game, uint8_t *action) {
+
+    struct simGame *sim = game->driverData;
+
+    // Replaying the script
+    if(sim->player.strategy == ScriptStrategy) {
+        return nextScriptAction(&sim->player, action);
+    }
+
+    // Planning the inputs of the next shot
+    if(sim->planPosition == sim->planLength) {
+        SegmentId target = chooseTarget(&sim->player, game->selectedSegment);
+        if(target == CURSOR_HIDDEN) return false;
+
+        sim->planLength = planMoves(game->selectedSegment, target, sim->plan);
+        sim->planPosition = 0;
+    }
+
+    *action = sim->plan[sim->planPosition++];
+    return true;
+}
+
+static void setSimulatedCursor(GameContext *game, SegmentId segment) {
+    // The simulation has no display
+}
+
+static void invalidateSimulatedDisplay(GameContext *game, uint32_t regions) {
+    // The simulation has no display
+}
+
+static void startSimulatedAnimation(GameContext *game, GameAnimations animation) {
+
+    struct simGame *sim = game->driverData;
+
+    // Converting the animation length to game ticks
+    uint32_t durationMs = animation == SpinnerAnimation ? SPINNER_ANIMATION_MS : HIT_ANIMATION_MS;
+    sim->animationEndTick = game->gameTick + (durationMs + sim->tickPeriodMs - 1) / sim->tickPeriodMs;
+}
+
+static bool isSimulatedAnimationRunning(GameContext *game) {
+
+    struct simGame *sim = game->driverData;
+    return game->gameTick < sim->animationEndTick;
+}
+
+static void reportSimulatedEvent(GameContext *game, GameEvents event) {
+
+    struct simGame *sim = game->driverData;
+
+    switch(event) {
+    case GameStartedEvent:      resetPlayer(&sim->player);                                      break;
+    case SegmentHitEvent:       observeShot(&sim->player, game->selectedSegment, true);         break;
+    case SegmentMissedEvent:    observeShot(&sim->player, game->selectedSegment, false);        break;
+    case GameFinishedEvent:     sim->finished = true;                                           break;
+    default: break;
+    }
+}
+
+/**
+ * @brief The drivers of the simulated games.
+ */
+static const GameDrivers simulatedDrivers = {
+    .prepareGame = prepareSimulation,
+    .readAction = readSimulatedAction,
+    .setCursor = setSimulatedCursor,
+    .invalidateDisplay = invalidateSimulatedDisplay,
+    .startAnimation = startSimulatedAnimation,
+    .isAnimationRunning = isSimulatedAnimationRunning,
+    .reportEvent = reportSimulatedEvent
+};
+
+bool runGame(struct simGame *sim, uint64_t seed, uint32_t maxTicks) {
+
+    // Deriving the seeds of the map selection and the player
+    uint64_t random = mixSeed(seed, 0);
+    sim->player.randomState = (uint32_t) random | 1;
+    sim->player.scriptPosition = 0;
+    sim->finished = false;
+    sim->updates = 0;
+
+    initGame(&sim->game, &simulatedDrivers, sim, (uint32_t)(random >> 32));
+
+    while(!sim->finished && sim->game.gameTick < maxTicks) {
+
+        // Skipping the ticks that only wait for the animation
+        if((sim->game.state == SegmentFire || sim->game.state == SegmentHit) &&
+           sim->game.gameTick + 1 < sim->animationEndTick) {
+            sim->game.gameTick = sim->animationEndTick - 1;
+        }
+
+        updateGame(&sim->game);
+        sim->updates++;
+    }
+
+    return sim->finished;
+}
+
+void mergeResults(struct simResults *total, const struct simResults *results) {
+
+    total->games += results->games;
+    total->unfinishedGames += results->unfinishedGames;
+    total->shots += results->shots;
+    total->ticks += results->ticks;
+    total->updates += results->updates;
+    total->cpuSeconds += results->cpuSeconds;
+
+    for(int i = 0; i < PREDEFINED_MAP_COUNT; i++) {
+        total->mapGames[i] += results->mapGames[i];
+        total->mapShots[i] += results->mapShots[i];
+        total->mapTicks[i] += results->mapTicks[i];
+    }
+}
+
+void *simulationTaskFunction(void *params) {
+
+    struct simulationParams *sParams = params;
+    struct simResults *results = &sParams->results;
+    memset(results, 0, sizeof(*results));
+
+    // The game reused for every simulation of the thread
+    struct simGame sim;
+    memset(&sim, 0, sizeof(sim));
+    sim.player.strategy = sParams->strategy;
+    sim.player.script = sParams->script;
+    sim.tickPeriodMs = sParams->tickPeriodMs;
+
+    // Measuring the CPU time of the thread for the cost of a tick
+    struct timespec start, stop;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+
+    for(uint64_t i = sParams->firstGame; i < sParams->firstGame + sParams->gameCount; i++) {
+
+        // Every game is seeded by its index, independently of the threads
+        bool finished = runGame(&sim, mixSeed(sParams->seed, i), sParams->maxTicks);
+        results->updates += sim.updates;
+
+        if(!finished) {
+            results->unfinishedGames++;
+            continue;
+        }
+
+        // Accumulating the statistics of the game
+        uint8_t map = sim.game.mapIndex;
+        results->games++;
+        results->shots += sim.game.shotsTotal;
+        results->ticks += sim.game.gameTick;
+        results->mapGames[map]++;
+        results->mapShots[map] += sim.game.shotsTotal;
+        results->mapTicks[map] += sim.game.gameTick;
+    }
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &stop);
+    results->cpuSeconds = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+
+    return NULL;
+}
@@ -0,0 +1,140 @@
+#pragma once
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    simulator.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated drivers running the game core of the firmware on the host.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "game_core.h"
+#include "strategy.h"
+
+
+/**
+ * @brief The durations of the spinner and hit animations of the board in
+ *        milliseconds, SPINNER_ANIMATION_STEPS and HIT_ANIMATION_STEPS
+ *        steps of ANIMATION_STEP_MS (see animation.h of the firmware).
+ */
+#define SPINNER_ANIMATION_MS    (8 * 160)
+#define HIT_ANIMATION_MS        (6 * 160)
+
+/**
+ * @brief The default time delay between game ticks in milliseconds,
+ *        GAMEPLAY_TICK_DELAY_MS of the firmware.
+ */
+#define SIM_TICK_PERIOD_MS      (10)
+
+/**
+ * @brief The default number of ticks after which an unfinished game is abandoned.
+ */
+#define SIM_MAX_GAME_TICKS      (1000000)
+
+/**
+ * @brief The state of a single simulated game: the game core context and
+ *        the state of its simulated drivers.
+ */
+struct simGame {
+    GameContext game;                           /**< The context of the game core       */
+    struct simPlayer player;                    /**< The simulated player               */
+    uint8_t plan[MOVE_PLAN_MAX_LENGTH];         /**< The planned inputs of the player   */
+    uint16_t planLength;                        /**< The number of planned inputs       */
+    uint16_t planPosition;                      /**< The next planned input             */
+    uint8_t tickPeriodMs;                       /**< The time between game ticks        */
+    uint32_t animationEndTick;                  /**< The tick the animation ends at     */
+    uint32_t updates;                           /**< The ticks executed by the core     */
+    bool finished;                              /**< Set when the game is over          */
+};
+
+/**
+ * @brief The statistics of a set of simulated games.
+ */
+struct simResults {
+    uint64_t games;                             /**< The number of finished games       */
+    uint64_t unfinishedGames;                   /**< The number of abandoned games      */
+    uint64_t shots;                             /**< The shots of the finished games    */
+    uint64_t ticks;                             /**< The ticks of the finished games    */
+    uint64_t updates;                           /**< The ticks executed by the core     */
+    double cpuSeconds;                          /**< The CPU time of the simulation     */
+    uint64_t mapGames[PREDEFINED_MAP_COUNT];    /**< The finished games per map         */
+    uint64_t mapShots[PREDEFINED_MAP_COUNT];    /**< The shots per map                  */
+    uint64_t mapTicks[PREDEFINED_MAP_COUNT];    /**< The ticks per map                  */
+};
+
+/**
+ * @brief This structure contains the parameters of a simulation thread.
+ *        The thread plays the games [firstGame, firstGame + gameCount).
+ */
+struct simulationParams {
+    StrategyType strategy;                      /**< The strategy of the players        */
+    const char *script;                         /**< The keys of ScriptStrategy         */
+    uint64_t seed;                              /**< The seed of the simulation         */
+    uint64_t firstGame;                         /**< The index of the first game        */
+    uint64_t gameCount;                         /**< The number of games to play        */
+    uint8_t tickPeriodMs;                       /**< The time between game ticks        */
+    uint32_t maxTicks;                          /**< The tick limit of a game           */
+    struct simResults results;                  /**< The results of the thread          */
+};
+
+/**
+ * @brief  Plays a single game with the simulated drivers.
+ * @detail The game is deterministic under its seed. Virtual ticks
+ *         are advanced without sleeping, and the ticks spent
+ *         waiting for an animation are skipped at once. The
+ *         ticks executed by the core are counted in updates.
+ * @param  [in] The game, its player strategy, script and tick
+ *              period set by the caller.
+ * @param  [in] The seed of the game.
+ * @param  [in] The tick limit of the game.
+ * @return True if the game finished within the tick limit.
+ */
+bool runGame(struct simGame *sim, uint64_t seed, uint32_t maxTicks);
+
+/**
+ * @brief Adds the results of the second set to the first one.
+ * @param [in] The accumulated results.
+ * @param [in] The results to add.
+ */
+void mergeResults(struct simResults *total, const struct simResults *results);
+
+/**
+ * @brief  The thread function playing the games specified by its
+ *         simulationParams, and storing their statistics in it.
+ * @param  [in] The simulationParams of the thread.
+ * @return NULL
+ */
+void *simulationTaskFunction(void *params);
+
+#endif // SIMULATOR_H
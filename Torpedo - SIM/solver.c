@@ -0,0 +1,172 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    solver.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Exact expectimax solver of the optimal play over the predefined maps.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+
+// Project includes
+#include "solver.h"
+
+
+/**
+ * @brief The fewest and most misses of the optimal plays for each
+ *        candidate set of the map searched by optimalShotsRangeOfMap().
+ */
+static uint8_t fewestMisses[CANDIDATE_SET_COUNT];
+static uint8_t mostMisses[CANDIDATE_SET_COUNT];
+
+/**
+ * @brief The parameters of a thread solving a part of a layer.
+ */
+struct layerParams {
+    int size;           /**< The number of candidates in the sets of the layer  */
+    uint32_t first;     /**< The first candidate set of the part                */
+    uint32_t last;      /**< The candidate set after the part                   */
+};
+
+/**
+ * @brief  Solves the candidate sets of one layer in the specified range.
+ * @param  [in] The layerParams of the thread.
+ * @return NULL
+ */
+static void *solveLayerTask(void *params) {
+
+    struct layerParams *lParams = params;
+
+    for(uint32_t candidates = lParams->first; candidates < lParams->last; candidates++) {
+        if(__builtin_popcount(candidates) != lParams->size) continue;
+
+        // Memoizing the set, its splits are solved by the previous layers
+        expectedMisses(candidates);
+    }
+
+    return NULL;
+}
+
+void solveOptimalPlay(unsigned threads) {
+
+    pthread_t layerTasks[threads];
+    struct layerParams lParams[threads];
+
+    // Solving the layers in increasing candidate set size
+    for(int size = 2; size <= PREDEFINED_MAP_COUNT; size++) {
+
+        for(unsigned i = 0; i < threads; i++) {
+            lParams[i].size = size;
+            lParams[i].first = CANDIDATE_SET_COUNT * i / threads;
+            lParams[i].last = CANDIDATE_SET_COUNT * (i + 1) / threads;
+
+            if(pthread_create(&layerTasks[i], NULL, solveLayerTask, (void*) &lParams[i]) != 0) {
+                fprintf(stderr, "Error: The solver thread can not be created.\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        // Waiting for the layer before solving the next one
+        for(unsigned i = 0; i < threads; i++) {
+            pthread_join(layerTasks[i], NULL);
+        }
+    }
+}
+
+/**
+ * @brief Searches the fewest and most misses of the optimal plays
+ *        finishing the map, memoized until the map changes.
+ * @param [in] The bitset of the candidate maps, including the map.
+ * @param [in] The index of the map.
+ */
+static void searchMissRange(uint16_t candidates, uint8_t map) {
+
+    if(fewestMisses[candidates] != UINT8_MAX) return;
+
+    // A single candidate is finished without misses
+    if(__builtin_popcount(candidates) <= 1) {
+        fewestMisses[candidates] = 0;
+        mostMisses[candidates] = 0;
+        return;
+    }
+
+    uint8_t fewest = UINT8_MAX;
+    uint8_t most = 0;
+
+    // Following every optimal shot
+    double best = expectedMisses(candidates);
+    for(SegmentId i = 0; i < shotCount; i++) {
+        uint16_t ships = shotMasks[i] & candidates;
+        if(ships == 0 || ships == candidates || expectedMissesAfterShot(candidates, ships) > best + MISSES_EPSILON) continue;
+
+        bool hit = ships & (1U << map);
+        uint16_t next = hit ? ships : candidates & ~ships;
+        searchMissRange(next, map);
+
+        if(fewestMisses[next] + !hit < fewest) fewest = fewestMisses[next] + !hit;
+        if(mostMisses[next] + !hit > most) most = mostMisses[next] + !hit;
+    }
+
+    fewestMisses[candidates] = fewest;
+    mostMisses[candidates] = most;
+}
+
+uint8_t optimalShotsOfMap(uint8_t map) {
+
+    uint16_t candidates = ALL_CANDIDATE_MAPS;
+    uint8_t misses = 0;
+
+    // Playing until the map is identified
+    while(__builtin_popcount(candidates) > 1) {
+        uint16_t ships = segmentMaps[optimalShot(candidates)];
+
+        if(ships & (1U << map)) {
+            candidates &= ships;
+        } else {
+            candidates &= ~ships;
+            misses++;
+        }
+    }
+
+    return SHIP_SEGMENTS_COUNT + misses;
+}
+
+void optimalShotsRangeOfMap(uint8_t map, uint8_t *fewest, uint8_t *most) {
+
+    // Forgetting the searches of the previous map
+    memset(fewestMisses, UINT8_MAX, sizeof(fewestMisses));
+
+    searchMissRange(ALL_CANDIDATE_MAPS, map);
+
+    *fewest = SHIP_SEGMENTS_COUNT + fewestMisses[ALL_CANDIDATE_MAPS];
+    *most = SHIP_SEGMENTS_COUNT + mostMisses[ALL_CANDIDATE_MAPS];
+}
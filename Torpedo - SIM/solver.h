@@ -0,0 +1,73 @@
+#pragma once
+#ifndef SOLVER_H
+#define SOLVER_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    solver.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Exact expectimax solver of the optimal play over the predefined maps.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdint.h>
+
+// Project includes
+#include "game_core.h"
+#include "map_solver.h"
+
+
+/**
+ * @brief   Solves the expected misses of the optimal play for every set
+ *          of candidate maps ahead, with expectedMisses().
+ * @details The sets are solved in layers of equal size, a layer only
+ *          depends on the smaller ones and is split between the threads.
+ *          The simulation threads then only read the solutions.
+ * @param   [in] The number of threads.
+ */
+void solveOptimalPlay(unsigned threads);
+
+/**
+ * @brief   Returns the shots the optimal play takes to finish a map.
+ * @details The play always fires at optimalShot() until a single
+ *          candidate is left.
+ * @param   [in] The index of the map.
+ * @returns The number of shots.
+ */
+uint8_t optimalShotsOfMap(uint8_t map);
+
+/**
+ * @brief   Returns the fewest and most shots the optimal plays take to
+ *          finish a map, over every choice between equally good shots.
+ * @param   [in] The index of the map.
+ * @param   [out] The fewest shots.
+ * @param   [out] The most shots.
+ */
+void optimalShotsRangeOfMap(uint8_t map, uint8_t *fewest, uint8_t *most);
+
+#endif // SOLVER_H
@@ -0,0 +1,198 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    strategy.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Strategies of the simulated players and cursor move planning.
+ ********************************************************************************/
+
+// Standard includes
+#include <string.h>
+
+// Project includes
+#include "strategy.h"
+
+
+/**
+ * @brief The names of the strategies, indexed by StrategyType.
+ */
+static const char *strategyNames[] = {"sweep", "random", "candidates", "optimal", "script"};
+
+/**
+ * @brief  Returns the next value of the xorshift generator of the player.
+ * @param  [in] The player.
+ * @return The random value.
+ */
+static uint32_t nextRandom(struct simPlayer *player) {
+    uint32_t x = player->randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return player->randomState = x;
+}
+
+int parseStrategy(const char *name, StrategyType *strategy) {
+
+    // Searching the strategy by name
+    for(unsigned i = 0; i < sizeof(strategyNames) / sizeof(strategyNames[0]); i++) {
+        if(strcmp(name, strategyNames[i]) == 0) {
+            *strategy = (StrategyType) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+const char *strategyName(StrategyType strategy) {
+    return strategyNames[strategy];
+}
+
+void resetPlayer(struct simPlayer *player) {
+
+    // Forgetting the shots of the previous game
+    memset(player->firedMap, 0, sizeof(player->firedMap));
+    player->candidateMaps = ALL_CANDIDATE_MAPS;
+
+    // Listing every segment as unfired, in increasing order
+    for(SegmentId i = 0; i < LCD_SEGMENTS_COUNT; i++) {
+        player->unfired[i] = i;
+        player->unfiredPosition[i] = i;
+    }
+    player->unfiredCount = LCD_SEGMENTS_COUNT;
+    player->sweepPosition = 0;
+}
+
+SegmentId chooseTarget(struct simPlayer *player, SegmentId selectedSegment) {
+
+    if(player->unfiredCount == 0) return CURSOR_HIDDEN;
+
+    switch(player->strategy) {
+
+    // Picking a random unfired segment
+    case RandomStrategy:
+        return player->unfired[nextRandom(player) % player->unfiredCount];
+
+    // Picking the segment with a ship in the most candidate maps
+    case CandidateStrategy:
+    {
+        SegmentId best = CURSOR_HIDDEN;
+        uint8_t bestVotes = 0;
+        uint16_t bestMoves = 0;
+
+        for(SegmentId n = 0; n < player->unfiredCount; n++) {
+            SegmentId i = player->unfired[n];
+            uint8_t votes = __builtin_popcount(segmentMaps[i] & player->candidateMaps);
+            if(votes == 0 || votes < bestVotes) continue;
+
+            // Preferring the closest segment among equal votes
+            uint16_t moves = segmentDistance(selectedSegment, i);
+            if(votes > bestVotes || moves < bestMoves) {
+                best = i;
+                bestVotes = votes;
+                bestMoves = moves;
+            }
+        }
+        if(best != CURSOR_HIDDEN) return best;
+        break;
+    }
+
+    // Picking the closest segment of an optimal shot, or of the identified map
+    case OptimalStrategy:
+    {
+        uint16_t candidates = player->candidateMaps;
+        bool identified = __builtin_popcount(candidates) <= 1;
+        double best = expectedMisses(candidates);
+
+        SegmentId target = CURSOR_HIDDEN;
+        uint16_t targetMoves = 0;
+
+        for(SegmentId n = 0; n < player->unfiredCount; n++) {
+            SegmentId i = player->unfired[n];
+            uint16_t ships = segmentMaps[i] & candidates;
+
+            if(identified) {
+                if(ships == 0) continue;
+            } else {
+                if(ships == 0 || ships == candidates || expectedMissesAfterShot(candidates, ships) > best + MISSES_EPSILON) continue;
+            }
+
+            uint16_t moves = segmentDistance(selectedSegment, i);
+            if(target == CURSOR_HIDDEN || moves < targetMoves) {
+                target = i;
+                targetMoves = moves;
+            }
+        }
+        if(target != CURSOR_HIDDEN) return target;
+        break;
+    }
+
+    default: break;
+    }
+
+    // Picking the lowest unfired segment
+    while(segmentMapTest(player->firedMap, player->sweepPosition)) player->sweepPosition++;
+    return player->sweepPosition;
+}
+
+void observeShot(struct simPlayer *player, SegmentId segment, bool hit) {
+
+    // Keeping the maps agreeing with the result of the shot
+    player->candidateMaps &= hit ? segmentMaps[segment] : ~segmentMaps[segment];
+
+    // Scripted players may fire at a segment again
+    if(segmentMapTest(player->firedMap, segment)) return;
+    segmentMapSet(player->firedMap, segment);
+
+    // Removing the segment from the unfired list, moving the last one in its place
+    SegmentId position = player->unfiredPosition[segment];
+    SegmentId last = player->unfired[--player->unfiredCount];
+    player->unfired[position] = last;
+    player->unfiredPosition[last] = position;
+}
+
+bool nextScriptAction(struct simPlayer *player, uint8_t *action) {
+
+    size_t length = strlen(player->script);
+
+    // Searching the next key with an action, at most once around the script
+    for(size_t i = 0; i < length; i++) {
+        char key = player->script[player->scriptPosition];
+        player->scriptPosition = (player->scriptPosition + 1) % length;
+
+        switch(key) {
+        case 'a': *action = MoveLeft;   return true;
+        case 'd': *action = MoveRight;  return true;
+        case 'w': *action = MoveUp;     return true;
+        case 's': *action = MoveDown;   return true;
+        case ' ': *action = Fire;       return true;
+        default: break;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,125 @@
+#pragma once
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    strategy.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Strategies of the simulated players and cursor move planning.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Project includes
+#include "game_core.h"
+#include "map_solver.h"
+
+
+/**
+ * @brief The strategies of the simulated player.
+ */
+typedef enum {
+    SweepStrategy,      /**< Fires at the segments in increasing order              */
+    RandomStrategy,     /**< Fires at a random segment not fired at yet             */
+    CandidateStrategy,  /**< Fires at the segment holding a ship in the most maps
+                             still matching the hits and misses of the game         */
+    OptimalStrategy,    /**< Fires at the closest segment minimizing the expected
+                             misses, needs solveOptimalPlay()                       */
+    ScriptStrategy      /**< Replays a fixed key sequence                           */
+} StrategyType;
+
+/**
+ * @brief The state of a simulated player during a game.
+ */
+struct simPlayer {
+    StrategyType strategy;      /**< The strategy of the player                     */
+    uint32_t randomState;       /**< The state of the random generator              */
+    SegmentMap firedMap;        /**< The segments fired at in the current game      */
+    uint16_t candidateMaps;     /**< The maps matching the shots of the game        */
+    SegmentId unfired[LCD_SEGMENTS_COUNT];          /**< The segments not fired at  */
+    SegmentId unfiredPosition[LCD_SEGMENTS_COUNT];  /**< The index of each segment
+                                                         in unfired[]               */
+    SegmentId unfiredCount;     /**< The number of segments not fired at            */
+    SegmentId sweepPosition;    /**< The lowest segment possibly not fired at       */
+    const char *script;         /**< The keys of ScriptStrategy                     */
+    size_t scriptPosition;      /**< The next key of the script                     */
+};
+
+/**
+ * @brief  Returns the strategy of the specified name.
+ * @param  [in] The name of the strategy.
+ * @param  [out] The strategy.
+ * @return 0 on success, -1 if the name is unknown.
+ */
+int parseStrategy(const char *name, StrategyType *strategy);
+
+/**
+ * @brief  Returns the name of the specified strategy.
+ * @param  [in] The strategy.
+ * @return The name of the strategy.
+ */
+const char *strategyName(StrategyType strategy);
+
+/**
+ * @brief Prepares the player for a new game.
+ * @param [in] The player.
+ */
+void resetPlayer(struct simPlayer *player);
+
+/**
+ * @brief  Chooses the next segment to fire at.
+ * @param  [in] The player.
+ * @param  [in] The segment currently selected in the game.
+ * @return The ID of the segment or CURSOR_HIDDEN if every segment
+ *         was fired at already.
+ */
+SegmentId chooseTarget(struct simPlayer *player, SegmentId selectedSegment);
+
+/**
+ * @brief Records the result of a shot, narrowing the candidate maps.
+ * @param [in] The player.
+ * @param [in] The ID of the segment fired at.
+ * @param [in] True if the shot hit a ship.
+ */
+void observeShot(struct simPlayer *player, SegmentId segment, bool hit);
+
+/**
+ * @brief  Returns the next action of the ScriptStrategy key sequence.
+ * @detail The script is repeated when it ends, keys with no action
+ *         are skipped.
+ * @param  [in] The player.
+ * @param  [out] The action (InputStates).
+ * @return True if the script contains an action.
+ */
+bool nextScriptAction(struct simPlayer *player, uint8_t *action);
+
+#endif // STRATEGY_H
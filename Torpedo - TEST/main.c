@@ -0,0 +1,89 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    main.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Defines the entry point of the host tests, running every test suite.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+
+// Project includes
+#include "test.h"
+
+
+/**
+ * @brief The number of checks run and failed.
+ */
+static unsigned checkCount = 0;
+static unsigned failureCount = 0;
+
+/**
+ * @brief The test suites in the order they run.
+ */
+static const struct {
+    const char *name;
+    void (*run)(void);
+} testSuites[] = {
+    {"tick_suppression", testTickSuppression},
+    {"animation", testAnimation},
+    {"statistics", testStatistics},
+    {"link", testLink},
+    {"bot", testBot},
+    {"history", testHistory}
+};
+
+bool testCheck(bool passed, const char *condition, const char *file, int line) {
+
+    checkCount++;
+
+    if(!passed) {
+        failureCount++;
+        fprintf(stderr, "Error: Check failed at %s:%d: %s\n", file, line, condition);
+    }
+
+    return passed;
+}
+
+int main(int argc, char *argv[]) {
+
+    for(size_t i = 0; i < sizeof(testSuites) / sizeof(testSuites[0]); i++) {
+
+        unsigned failuresBefore = failureCount;
+
+        testResetBoard();
+        testSuites[i].run();
+
+        printf("INFO: %-20s %s\n", testSuites[i].name, failureCount == failuresBefore ? "passed" : "FAILED");
+    }
+
+    printf("INFO: %u checks, %u failed\n", checkCount, failureCount);
+
+    return failureCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
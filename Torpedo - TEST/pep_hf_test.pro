@@ -0,0 +1,71 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+# The firmware modules are tested on the simulated drivers of the SIL
+# build, see "Torpedo - SIL/pep_hf_sil.pro" for FREERTOS_POSIX_PORT
+isEmpty(FREERTOS_POSIX_PORT): error("Set FREERTOS_POSIX_PORT to the FreeRTOS POSIX port directory")
+
+FIRMWARE = "$$PWD/../Torpedo - EFM32GG"
+CLIENT = "$$PWD/../Torpedo - UNIX"
+SIL = "$$PWD/../Torpedo - SIL"
+KERNEL = "$$FIRMWARE/FreeRTOS"
+
+# The simulated SDK headers come first, shadowing the drivers of the board
+INCLUDEPATH += \
+    "$$PWD" \
+    "$$SIL" \
+    "$$SIL/emlib" \
+    "$$FIRMWARE/src" \
+    "$$CLIENT" \
+    "$$KERNEL/include" \
+    "$$FREERTOS_POSIX_PORT" \
+    "$$FREERTOS_POSIX_PORT/utils"
+
+SOURCES += main.c \
+    test_board.c \
+    test_tick_suppression.c \
+    test_animation.c \
+    test_statistics.c \
+    test_link.c \
+    test_bot.c \
+    test_history.c \
+    "$$SIL/sil_lcd.c" \
+    "$$SIL/sil_flash.c" \
+    "$$FIRMWARE/src/tick_suppression.c" \
+    "$$FIRMWARE/src/animation.c" \
+    "$$FIRMWARE/src/statistics.c" \
+    "$$FIRMWARE/src/link.c" \
+    "$$FIRMWARE/src/history.c" \
+    "$$FIRMWARE/src/game_core.c" \
+    "$$FIRMWARE/src/map_solver.c" \
+    "$$CLIENT/bot.c" \
+    "$$CLIENT/map_index.c" \
+    "$$FIRMWARE/drivers/lcd/segmentlcd_individual.c" \
+    "$$KERNEL/tasks.c" \
+    "$$KERNEL/queue.c" \
+    "$$KERNEL/list.c" \
+    "$$KERNEL/timers.c" \
+    "$$KERNEL/portable/MemMang/heap_3.c" \
+    "$$FREERTOS_POSIX_PORT/port.c" \
+    "$$FREERTOS_POSIX_PORT/utils/wait_for_event.c"
+
+HEADERS += \
+    test.h \
+    "$$SIL/sil_board.h" \
+    "$$FIRMWARE/src/tick_suppression.h" \
+    "$$FIRMWARE/src/animation.h" \
+    "$$FIRMWARE/src/statistics.h" \
+    "$$FIRMWARE/src/link.h" \
+    "$$FIRMWARE/src/history.h" \
+    "$$FIRMWARE/src/game_core.h" \
+    "$$FIRMWARE/src/map_solver.h" \
+    "$$CLIENT/bot.h" \
+    "$$CLIENT/map_index.h"
+
+# The firmware declares its shared globals in the headers
+QMAKE_CFLAGS += -fcommon
+
+LIBS += \
+    -pthread
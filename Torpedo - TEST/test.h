@@ -0,0 +1,134 @@
+#pragma once
+#ifndef TEST_H
+#define TEST_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    test.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Checks and the simulated board shared by the tests of the firmware and host modules.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "em_device.h"
+
+
+/**
+ * @brief Checks a condition of a test, a failed check is printed with
+ *        its location and counted, the test goes on.
+ */
+#define TEST_CHECK(condition)           testCheck((condition), #condition, __FILE__, __LINE__)
+
+/**
+ * @brief The number of bytes the simulated UART keeps, the bytes sent
+ *        after it is full are lost.
+ */
+#define TEST_UART_BUFFER_SIZE           (65536)
+
+/**
+ * @brief The bytes sent over UART0 since the last testResetBoard().
+ */
+extern uint8_t testUartData[TEST_UART_BUFFER_SIZE];
+extern uint32_t testUartLength;
+
+/**
+ * @brief The number of bytes the simulated UART receiver holds.
+ */
+#define TEST_UART_RX_SIZE               (64)
+
+/**
+ * @brief The baud-rate UART0 was last set to.
+ */
+extern uint32_t testUartBaudrate;
+
+/**
+ * @brief Called before every byte sent over UART0 while set, to run
+ *        interrupts in the middle of a transmission.
+ */
+extern void (*testTransmitHook)(void);
+
+/**
+ * @brief  Places bytes into the receiver of UART0, the received bytes
+ *         are held until the firmware reads them.
+ * @param  [in] The received bytes.
+ * @param  [in] The number of bytes.
+ */
+void testReceive(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief  Returns the number of received bytes the firmware did not read.
+ * @return The number of bytes held by the receiver.
+ */
+uint32_t testReceivedLength(void);
+
+/**
+ * @brief  Passes a command frame of the host to the link byte by byte,
+ *         like the UART interrupt.
+ * @param  [in] The command identifier followed by its fields.
+ * @param  [in] The length of the command and its fields.
+ */
+void testSendCommand(const uint8_t *command, uint32_t length);
+
+/**
+ * @brief  Counts a check and prints it if it failed.
+ * @param  [in] The result of the check.
+ * @param  [in] The checked condition as text.
+ * @param  [in] The source file of the check.
+ * @param  [in] The line of the check.
+ * @return The result of the check.
+ */
+bool testCheck(bool passed, const char *condition, const char *file, int line);
+
+/**
+ * @brief Clears the bytes sent and received over the UART, the transmit
+ *        hook and the pending interrupts.
+ */
+void testResetBoard(void);
+
+/**
+ * @brief  Returns whether the interrupt is pending and clears it.
+ * @param  [in] The interrupt.
+ * @return True if the interrupt was pending.
+ */
+bool testTakeInterrupt(IRQn_Type irq);
+
+/**
+ * @brief The test suites, each one runs its tests on a freshly reset board.
+ */
+void testTickSuppression(void);
+void testAnimation(void);
+void testStatistics(void);
+void testLink(void);
+void testBot(void);
+void testHistory(void);
+
+#endif // TEST_H
@@ -0,0 +1,275 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    test_animation.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Tests of the animations driven by the frame counter of the simulated LCD controller.
+ ********************************************************************************/
+
+// Project includes
+#include "test.h"
+#include "sil_board.h"
+#include "animation.h"
+
+
+/**
+ * @brief The calls of the graphics module by the LCD interrupt.
+ */
+static unsigned blinkCount;
+static unsigned commitCount;
+
+/**
+ * @brief Whether the graphics module reports a shown cursor.
+ */
+static bool cursorShown;
+
+/**
+ * @brief The kernel tick the simulated LCD was advanced to.
+ */
+static TickType_t lcdTick;
+
+bool blinkCursorFromISR(void) {
+    blinkCount++;
+    return cursorShown;
+}
+
+void commitDisplayFromISR(void) {
+    commitCount++;
+}
+
+/**
+ * @brief  Returns the ring segments shown by the animation controller.
+ * @return The lit segments of the ring, segment 0 in bit 0.
+ */
+static uint8_t ringSegments(void) {
+
+    if(!silLcd.animationEnabled) {
+        return 0;
+    }
+
+    return silLcd.animation.animLogic == lcdAnimLogicAnd ? silLcd.animationA & silLcd.animationB
+                                                         : silLcd.animationA | silLcd.animationB;
+}
+
+/**
+ * @brief  Advances the LCD by the kernel ticks, serving its interrupt
+ *         after every tick like the interrupt task of the SIL build.
+ * @param  [in] The number of ticks.
+ * @return The number of frame counter events served.
+ */
+static unsigned runTicks(TickType_t ticks) {
+
+    unsigned blinks = blinkCount;
+
+    for(TickType_t i = 0; i < ticks; i++) {
+        pollSimulatedLcd(++lcdTick);
+        if(testTakeInterrupt(LCD_IRQn)) {
+            LCD_IRQHandler();
+        }
+    }
+
+    return blinkCount - blinks;
+}
+
+/**
+ * @brief  Advances the LCD to the next frame counter event.
+ * @return The number of ticks it took.
+ */
+static TickType_t runStep(void) {
+
+    TickType_t ticks = 0;
+
+    do {
+        ticks++;
+    } while(runTicks(1) == 0 && ticks < configTICK_RATE_HZ);
+
+    return ticks;
+}
+
+/**
+ * @brief The frame counter raises one event per animation step, its
+ *        interrupt runs only while the cursor is shown.
+ */
+static void testStepRate(void) {
+
+    cursorShown = false;
+    initAnimation();
+
+    TEST_CHECK(silLcd.frameCount.enable);
+    TEST_CHECK(silLcd.frameCount.top == ANIMATION_STEP_FRAMES - 1);
+    TEST_CHECK(!(silLcd.ien & LCD_IEN_FC));
+    TEST_CHECK(!silLcd.animationEnabled);
+    TEST_CHECK(!isAnimationRunning());
+
+    // Nothing is animated, the CPU is not woken up
+    TEST_CHECK(runTicks(configTICK_RATE_HZ) == 0);
+
+    // 64 frames per second, 10 frames per step
+    cursorShown = true;
+    startCursorBlink();
+    TEST_CHECK(silLcd.ien & LCD_IEN_FC);
+    TEST_CHECK(runTicks(configTICK_RATE_HZ) == LCD_FRAME_RATE_HZ / ANIMATION_STEP_FRAMES);
+
+    // The step length is rounded to whole frames
+    runStep();
+    TickType_t ticks = runStep();
+    TEST_CHECK(ticks <= ANIMATION_STEP_MS);
+    TEST_CHECK(ticks + 1000 / LCD_FRAME_RATE_HZ >= ANIMATION_STEP_MS);
+
+    // The cursor blinks without any animation
+    TEST_CHECK(!isAnimationRunning());
+
+    // The events stop on the first step the cursor is hidden
+    cursorShown = false;
+    TEST_CHECK(runStep() <= ANIMATION_STEP_MS);
+    TEST_CHECK(!(silLcd.ien & LCD_IEN_FC));
+    TEST_CHECK(runTicks(configTICK_RATE_HZ) == 0);
+}
+
+/**
+ * @brief The spinner rotates one segment around the ring, then the
+ *        animation stops by itself.
+ */
+static void testSpinner(void) {
+
+    initAnimation();
+    runStep();
+
+    startSpinnerAnimation();
+
+    TEST_CHECK(isAnimationRunning());
+    TEST_CHECK(ringSegments() == 0x01);
+
+    for(int step = 1; step < SPINNER_ANIMATION_STEPS; step++) {
+        runStep();
+        TEST_CHECK(isAnimationRunning());
+        TEST_CHECK(ringSegments() == 1 << step);
+    }
+
+    runStep();
+    TEST_CHECK(!isAnimationRunning());
+    TEST_CHECK(!silLcd.animationEnabled);
+    TEST_CHECK(ringSegments() == 0);
+
+    // Staying stopped, without frame counter events
+    TEST_CHECK(!(silLcd.ien & LCD_IEN_FC));
+    TEST_CHECK(runTicks(configTICK_RATE_HZ) == 0);
+    TEST_CHECK(!isAnimationRunning());
+}
+
+/**
+ * @brief The hit animation blinks the whole ring three times.
+ */
+static void testHit(void) {
+
+    initAnimation();
+    runStep();
+
+    startHitAnimation();
+
+    TEST_CHECK(isAnimationRunning());
+    TEST_CHECK(ringSegments() == 0xFF);
+
+    for(int step = 1; step < HIT_ANIMATION_STEPS; step++) {
+        runStep();
+        TEST_CHECK(isAnimationRunning());
+        TEST_CHECK(ringSegments() == (step % 2 ? 0x00 : 0xFF));
+    }
+
+    runStep();
+    TEST_CHECK(!isAnimationRunning());
+    TEST_CHECK(ringSegments() == 0);
+    TEST_CHECK(!(silLcd.ien & LCD_IEN_FC));
+}
+
+/**
+ * @brief A new animation replaces the running one with its full length.
+ */
+static void testRestart(void) {
+
+    initAnimation();
+    runStep();
+
+    startSpinnerAnimation();
+    for(int step = 0; step < SPINNER_ANIMATION_STEPS / 2; step++) {
+        runStep();
+    }
+
+    startHitAnimation();
+    TEST_CHECK(ringSegments() == 0xFF);
+
+    for(int step = 1; step < HIT_ANIMATION_STEPS; step++) {
+        runStep();
+        TEST_CHECK(isAnimationRunning());
+    }
+
+    runStep();
+    TEST_CHECK(!isAnimationRunning());
+}
+
+/**
+ * @brief The interrupt pended by software to commit a frame neither
+ *        advances the animation nor blinks the cursor.
+ */
+static void testSoftwareCommit(void) {
+
+    initAnimation();
+    runStep();
+
+    startSpinnerAnimation();
+
+    unsigned blinks = blinkCount;
+    unsigned commits = commitCount;
+
+    for(int i = 0; i < 2 * SPINNER_ANIMATION_STEPS; i++) {
+        NVIC_SetPendingIRQ(LCD_IRQn);
+        TEST_CHECK(testTakeInterrupt(LCD_IRQn));
+        LCD_IRQHandler();
+    }
+
+    TEST_CHECK(isAnimationRunning());
+    TEST_CHECK(ringSegments() == 0x01);
+    TEST_CHECK(blinkCount == blinks);
+    TEST_CHECK(commitCount == commits + 2 * SPINNER_ANIMATION_STEPS);
+
+    // Every frame counter event commits the display too
+    runStep();
+    TEST_CHECK(blinkCount == blinks + 1);
+    TEST_CHECK(commitCount == commits + 2 * SPINNER_ANIMATION_STEPS + 1);
+}
+
+void testAnimation(void) {
+
+    // Starting from a cleared display
+    SegmentLCD_Init(false);
+
+    testStepRate();
+    testSpinner();
+    testHit();
+    testRestart();
+    testSoftwareCommit();
+}
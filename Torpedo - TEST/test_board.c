@@ -0,0 +1,152 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    test_board.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Simulated board of the host tests: the UART keeps the sent and received bytes, the NVIC only records the pending interrupts.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Board includes
+#include "em_assert.h"
+#include "em_usart.h"
+
+// Project includes
+#include "test.h"
+#include "link.h"
+
+
+/**
+ * @brief The registers of UART0, unused by the tests.
+ */
+USART_TypeDef silUart0;
+
+uint8_t testUartData[TEST_UART_BUFFER_SIZE];
+uint32_t testUartLength;
+
+uint32_t testUartBaudrate = LINK_DEFAULT_BAUDRATE;
+
+void (*testTransmitHook)(void);
+
+/**
+ * @brief The bytes held by the receiver of UART0, free running indices.
+ */
+static uint8_t rxData[TEST_UART_RX_SIZE];
+static uint32_t rxHead;
+static uint32_t rxTail;
+
+/**
+ * @brief The interrupts pended since the last testResetBoard(),
+ *        one bit for each interrupt number.
+ */
+static uint64_t pendingInterrupts;
+
+void testResetBoard(void) {
+    testUartLength = 0;
+    testTransmitHook = NULL;
+    rxTail = rxHead;
+    pendingInterrupts = 0;
+}
+
+void testReceive(const uint8_t *data, uint32_t length) {
+    for(uint32_t i = 0; i < length && rxHead - rxTail < TEST_UART_RX_SIZE; i++) {
+        rxData[rxHead++ % TEST_UART_RX_SIZE] = data[i];
+    }
+}
+
+uint32_t testReceivedLength(void) {
+    return rxHead - rxTail;
+}
+
+void testSendCommand(const uint8_t *command, uint32_t length) {
+
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+    receiveCommandByteFromISR(COMMAND_START, &higherPriorityTaskWoken);
+    for(uint32_t i = 0; i < length; i++) {
+        receiveCommandByteFromISR(command[i], &higherPriorityTaskWoken);
+    }
+}
+
+bool testTakeInterrupt(IRQn_Type irq) {
+
+    bool pending = (pendingInterrupts >> irq) & 1;
+    pendingInterrupts &= ~(1ULL << irq);
+
+    return pending;
+}
+
+void USART_Tx(USART_TypeDef *usart, uint8_t data) {
+    if(testTransmitHook != NULL) {
+        testTransmitHook();
+    }
+    if(testUartLength < TEST_UART_BUFFER_SIZE) {
+        testUartData[testUartLength++] = data;
+    }
+}
+
+uint32_t USART_StatusGet(USART_TypeDef *usart) {
+    // Every byte is sent at once
+    return USART_STATUS_TXC | USART_STATUS_TXBL | (rxHead != rxTail ? USART_STATUS_RXDATAV : 0);
+}
+
+uint8_t USART_RxDataGet(USART_TypeDef *usart) {
+    return rxHead != rxTail ? rxData[rxTail++ % TEST_UART_RX_SIZE] : 0;
+}
+
+void USART_BaudrateAsyncSet(USART_TypeDef *usart, uint32_t refFreq, uint32_t baudrate, USART_OVS_TypeDef ovs) {
+    testUartBaudrate = baudrate;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq) {
+    // The tests call the handlers themselves
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq) {
+    // The tests call the handlers themselves
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type irq) {
+    pendingInterrupts |= 1ULL << irq;
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq) {
+    pendingInterrupts &= ~(1ULL << irq);
+}
+
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) {
+    // The tests call the handlers themselves
+}
+
+void assertEFM(const char *file, int line) {
+    fprintf(stderr, "Error: Assertion failed at %s:%d.\n", file, line);
+    abort();
+}
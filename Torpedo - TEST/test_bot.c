@@ -0,0 +1,243 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    test_bot.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Tests of the autoplayer of the host client, playing the game core of the firmware.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdio.h>
+#include <string.h>
+
+// Project includes
+#include "test.h"
+#include "game_core.h"
+#include "map_solver.h"
+#include "bot.h"
+#include "map_index.h"
+#include "serial_link.h"
+
+
+/**
+ * @brief The number of games played by the autoplayer.
+ */
+#define BOT_TEST_GAMES          (2000)
+
+/**
+ * @brief The tick limit of a game, far above the shots of any play.
+ */
+#define BOT_TEST_MAX_TICKS      (10000)
+
+/**
+ * @brief The largest difference of the average shots from the expected
+ *        shots of the optimal play over BOT_TEST_GAMES games.
+ */
+#define BOT_TEST_SHOTS_EPSILON  (0.15)
+
+/**
+ * @brief The flags of the link, the autoplayer waits while they are set.
+ */
+volatile int linkNegotiating = 0;
+volatile int backlogReplaying = 0;
+
+/**
+ * @brief The keys written by the autoplayer, read by the game as input.
+ */
+static uint8_t keys[256];
+static unsigned keyHead;
+static unsigned keyTail;
+
+/**
+ * @brief The game played, and the results of its last game.
+ */
+static GameContext game;
+static bool gameFinished;
+static unsigned gameShots;
+static unsigned gameRepeatedShots;
+static unsigned leftoverKeys;
+static SegmentMap firedMap;
+
+int writeToBoard(int terminalFileDescriptor, const uint8_t *data, size_t length) {
+
+    TEST_CHECK(length <= WRITE_MAX_LENGTH);
+
+    for(size_t i = 0; i < length; i++) {
+        keys[keyHead++ % sizeof(keys)] = data[i];
+    }
+    return 0;
+}
+
+static void prepareTestGame(GameContext *game) {
+}
+
+/**
+ * @brief Converts the keys written by the autoplayer to the input actions,
+ *        like the UART interrupt of the EFM32GG.
+ */
+static bool readTestAction(GameContext *game, uint8_t *action) {
+
+    while(keyTail != keyHead) {
+        switch(keys[keyTail++ % sizeof(keys)]) {
+        case 'a': *action = MoveLeft;   return true;
+        case 'd': *action = MoveRight;  return true;
+        case 'w': *action = MoveUp;     return true;
+        case 's': *action = MoveDown;   return true;
+        case ' ': *action = Fire;       return true;
+        default: break;
+        }
+    }
+
+    return false;
+}
+
+static void setTestCursor(GameContext *game, SegmentId segment) {
+}
+
+static void invalidateTestDisplay(GameContext *game, uint32_t regions) {
+}
+
+static void startTestAnimation(GameContext *game, GameAnimations animation) {
+}
+
+static bool isTestAnimationRunning(GameContext *game) {
+    return false;
+}
+
+/**
+ * @brief Passes the events of the game to the autoplayer, like the
+ *        statistics task of the host client decoding the messages.
+ */
+static void reportTestEvent(GameContext *game, GameEvents event) {
+
+    SegmentId segment = game->selectedSegment;
+
+    switch(event) {
+    case GameStartedEvent:
+        resetCandidateMaps();
+        memset(firedMap, 0, sizeof(firedMap));
+        botGameStarted(0);
+        break;
+
+    case SegmentSelectedEvent:
+        botSegmentSelected(segment);
+        break;
+
+    case SegmentFiredEvent:
+        gameShots++;
+        if(segmentMapTest(firedMap, segment)) gameRepeatedShots++;
+        segmentMapSet(firedMap, segment);
+        botSegmentSelected(segment);
+        break;
+
+    case SegmentHitEvent:
+    case SegmentMissedEvent:
+        narrowCandidateMaps(segment, event == SegmentHitEvent);
+        botShotResult(0, segment);
+        break;
+
+    case GameFinishedEvent:
+        gameFinished = true;
+        leftoverKeys = keyHead - keyTail;
+        break;
+    }
+}
+
+static const GameDrivers testDrivers = {
+    .prepareGame        = prepareTestGame,
+    .readAction         = readTestAction,
+    .setCursor          = setTestCursor,
+    .invalidateDisplay  = invalidateTestDisplay,
+    .startAnimation     = startTestAnimation,
+    .isAnimationRunning = isTestAnimationRunning,
+    .reportEvent        = reportTestEvent
+};
+
+/**
+ * @brief  Plays one game with the autoplayer.
+ * @return True if the game finished within BOT_TEST_MAX_TICKS.
+ */
+static bool playGame(void) {
+
+    gameFinished = false;
+    gameShots = 0;
+    gameRepeatedShots = 0;
+
+    for(uint32_t tick = 0; tick < BOT_TEST_MAX_TICKS && !gameFinished; tick++) {
+        updateGame(&game);
+    }
+
+    return gameFinished;
+}
+
+/**
+ * @brief Plays BOT_TEST_GAMES games on random maps, the autoplayer must
+ *        finish every game, never fire at a segment twice, leave no inputs
+ *        for the next game, and average the shots of the optimal play.
+ */
+static void testOptimalPlay(void) {
+
+    unsigned finished = 0;
+    unsigned shots = 0;
+    unsigned repeated = 0;
+    unsigned leftover = 0;
+    unsigned mostShots = 0;
+
+    for(unsigned i = 0; i < BOT_TEST_GAMES; i++) {
+        if(!playGame()) continue;
+
+        finished++;
+        shots += gameShots;
+        repeated += gameRepeatedShots;
+        leftover += leftoverKeys;
+        if(gameShots > mostShots) mostShots = gameShots;
+    }
+
+    double averageShots = (double) shots / finished;
+    double optimalShots = SHIP_SEGMENTS_COUNT + expectedMisses(ALL_CANDIDATE_MAPS);
+
+    TEST_CHECK(finished == BOT_TEST_GAMES);
+    TEST_CHECK(repeated == 0);
+    TEST_CHECK(leftover == 0);
+    TEST_CHECK(averageShots > optimalShots - BOT_TEST_SHOTS_EPSILON);
+    TEST_CHECK(averageShots < optimalShots + BOT_TEST_SHOTS_EPSILON);
+
+    printf("INFO: %u games, %.2f shots on average, %.2f expected, %u at most\n",
+           finished, averageShots, optimalShots, mostShots);
+}
+
+void testBot(void) {
+
+    initMapIndex();
+    initGame(&game, &testDrivers, NULL, 1);
+
+    botEnabled = 1;
+
+    testOptimalPlay();
+
+    botEnabled = 0;
+}
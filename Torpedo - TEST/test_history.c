@@ -0,0 +1,413 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    test_history.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Tests of the game history log of the firmware on the simulated flash of the SIL build.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdlib.h>
+#include <string.h>
+
+// Project includes
+#include "test.h"
+#include "history.h"
+#include "statistics.h"
+#include "sil_board.h"
+
+
+/**
+ * @brief The number of records the history holds at most.
+ */
+#define TEST_HISTORY_RECORDS    (HISTORY_PAGE_COUNT * HISTORY_PAGE_RECORDS)
+
+/**
+ * @brief The lengths of the parts of the history message on the wire.
+ */
+#define HISTORY_HEADER_LENGTH   (1 + 4 + 1)
+#define HISTORY_TOTALS_LENGTH   (4 * 4)
+#define HISTORY_RECORD_LENGTH   (1 + 4 + 2 + 2)
+
+/**
+ * @brief The history decoded from the last history message.
+ */
+static uint32_t historySequence;
+static HistoryTotals historyTotals[PREDEFINED_MAP_COUNT];
+static GameSummary historyRecords[TEST_HISTORY_RECORDS];
+static uint16_t historyCount;
+
+/**
+ * @brief  Returns a little-endian field of the sent bytes.
+ * @param  [in] The offset of the field.
+ * @param  [in] The length of the field in bytes.
+ * @return The value of the field.
+ */
+static uint32_t readField(uint32_t offset, int length) {
+
+    uint32_t value = 0;
+    for(int i = length - 1; i >= 0; i--) {
+        value = value << 8 | testUartData[offset + i];
+    }
+
+    return value;
+}
+
+/**
+ * @brief  Returns the summary of the specified test game.
+ * @param  [in] The number of the game.
+ * @return The summary of the game.
+ */
+static GameSummary testGame(uint32_t game) {
+    return (GameSummary){
+        .gameTicks   = 1000 + game,
+        .shotsTotal  = SHIP_SEGMENTS_COUNT + game % 7,
+        .shotsMissed = game % 7,
+        .mapIndex    = game % PREDEFINED_MAP_COUNT
+    };
+}
+
+/**
+ * @brief Stores the summaries of the specified test games, serviced
+ *        by the history task one by one.
+ * @param [in] The number of the first game.
+ * @param [in] The number of games.
+ */
+static void storeGames(uint32_t first, uint32_t count) {
+
+    for(uint32_t game = first; game < first + count; game++) {
+        GameSummary summary = testGame(game);
+        storeGameSummary(&summary);
+        serviceHistory();
+    }
+}
+
+/**
+ * @brief Starts the history on an erased flash, like a new board.
+ */
+static void resetHistory(void) {
+
+    // Not loading the flash file of the SIL
+    unsetenv(SIL_FLASH_ENV);
+
+    initSimulatedFlash();
+    initHistory();
+    serviceHistory();
+
+    historyDroppedCount = 0;
+}
+
+/**
+ * @brief  Sends the history and decodes the message.
+ * @return True if the message is well-formed.
+ */
+static bool readHistory(void) {
+
+    testResetBoard();
+    transmitHistory();
+
+    if(testUartLength < HISTORY_HEADER_LENGTH || testUartData[0] != HistoryMsg ||
+       testUartData[5] != PREDEFINED_MAP_COUNT) return false;
+
+    historySequence = readField(1, 4);
+
+    uint32_t offset = HISTORY_HEADER_LENGTH;
+    for(int map = 0; map < PREDEFINED_MAP_COUNT; map++, offset += HISTORY_TOTALS_LENGTH) {
+        historyTotals[map].games       = readField(offset, 4);
+        historyTotals[map].gameTicks   = readField(offset + 4, 4);
+        historyTotals[map].shotsTotal  = readField(offset + 8, 4);
+        historyTotals[map].shotsMissed = readField(offset + 12, 4);
+    }
+
+    historyCount = readField(offset, 2);
+    offset += 2;
+
+    if(historyCount > TEST_HISTORY_RECORDS ||
+       testUartLength != offset + historyCount * HISTORY_RECORD_LENGTH) return false;
+
+    for(int i = 0; i < historyCount; i++, offset += HISTORY_RECORD_LENGTH) {
+        historyRecords[i].mapIndex    = testUartData[offset];
+        historyRecords[i].gameTicks   = readField(offset + 1, 4);
+        historyRecords[i].shotsTotal  = readField(offset + 5, 2);
+        historyRecords[i].shotsMissed = readField(offset + 7, 2);
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Checks a decoded record against the summary of a test game.
+ * @param  [in] The index of the record.
+ * @param  [in] The number of the game.
+ * @return True if the record holds the summary of the game.
+ */
+static bool checkRecord(int index, uint32_t game) {
+
+    GameSummary expected = testGame(game);
+    const GameSummary *record = &historyRecords[index];
+
+    return record->mapIndex == expected.mapIndex && record->gameTicks == expected.gameTicks &&
+           record->shotsTotal == expected.shotsTotal && record->shotsMissed == expected.shotsMissed;
+}
+
+/**
+ * @brief  Checks that the totals hold the specified test games.
+ * @param  [in] The number of games that left the log, from the first.
+ * @return True if the totals of every map match.
+ */
+static bool checkTotals(uint32_t count) {
+
+    HistoryTotals expected[PREDEFINED_MAP_COUNT] = {0};
+
+    for(uint32_t game = 0; game < count; game++) {
+        GameSummary summary = testGame(game);
+        HistoryTotals *totals = &expected[summary.mapIndex];
+
+        totals->games++;
+        totals->gameTicks   += summary.gameTicks;
+        totals->shotsTotal  += summary.shotsTotal;
+        totals->shotsMissed += summary.shotsMissed;
+    }
+
+    return memcmp(expected, historyTotals, sizeof(expected)) == 0;
+}
+
+/**
+ * @brief  Returns the first word of a history page.
+ * @param  [in] The index of the page.
+ * @return The first word of the page.
+ */
+static uint32_t *historyPage(uint8_t page) {
+    return HISTORY_BASE + page * (FLASH_PAGE_SIZE / sizeof(uint32_t));
+}
+
+/**
+ * @brief The summaries are appended in order, and sent from the oldest.
+ */
+static void testAppend(void) {
+
+    resetHistory();
+
+    // An empty history has no active page
+    if(!TEST_CHECK(readHistory())) return;
+    TEST_CHECK(historySequence == 0 && historyCount == 0);
+    TEST_CHECK(!isHistoryBusy());
+
+    // The next game is held until the summary is written
+    GameSummary summary = testGame(0);
+    storeGameSummary(&summary);
+    TEST_CHECK(isHistoryBusy());
+
+    serviceHistory();
+    TEST_CHECK(!isHistoryBusy());
+
+    storeGames(1, 9);
+
+    if(!TEST_CHECK(readHistory())) return;
+    TEST_CHECK(historySequence == 1);
+    if(!TEST_CHECK(historyCount == 10)) return;
+
+    for(int i = 0; i < historyCount; i++) {
+        TEST_CHECK(checkRecord(i, i));
+    }
+
+    TEST_CHECK(checkTotals(0));
+    TEST_CHECK(historyDroppedCount == 0);
+}
+
+/**
+ * @brief A full page activates the next one. Once every page was used,
+ *        the oldest page leaves the log: its summaries are folded into
+ *        the totals and the page is erased for the next activation.
+ */
+static void testRotation(void) {
+
+    resetHistory();
+
+    // Filling every page but the erased one, then starting the last one
+    storeGames(0, (HISTORY_PAGE_COUNT - 1) * HISTORY_PAGE_RECORDS + 5);
+
+    if(!TEST_CHECK(readHistory())) return;
+    TEST_CHECK(historySequence == HISTORY_PAGE_COUNT);
+    if(!TEST_CHECK(historyCount == (HISTORY_PAGE_COUNT - 2) * HISTORY_PAGE_RECORDS + 5)) return;
+
+    // The first page left the log
+    for(int i = 0; i < historyCount; i++) {
+        TEST_CHECK(checkRecord(i, HISTORY_PAGE_RECORDS + i));
+    }
+    TEST_CHECK(checkTotals(HISTORY_PAGE_RECORDS));
+
+    // And was erased in the background
+    const uint32_t *words = historyPage(0);
+    bool erased = true;
+    for(uint32_t i = 0; i < FLASH_PAGE_SIZE / sizeof(uint32_t); i++) {
+        erased = erased && words[i] == 0xFFFFFFFFUL;
+    }
+    TEST_CHECK(erased);
+
+    // Wrapping around to the first page
+    uint32_t stored = (HISTORY_PAGE_COUNT - 1) * HISTORY_PAGE_RECORDS + 5;
+    storeGames(stored, HISTORY_PAGE_RECORDS - 5 + 1);
+    stored += HISTORY_PAGE_RECORDS - 5 + 1;
+
+    if(!TEST_CHECK(readHistory())) return;
+    TEST_CHECK(historySequence == HISTORY_PAGE_COUNT + 1);
+    if(!TEST_CHECK(historyCount == (HISTORY_PAGE_COUNT - 2) * HISTORY_PAGE_RECORDS + 1)) return;
+
+    TEST_CHECK(checkRecord(0, 2 * HISTORY_PAGE_RECORDS));
+    TEST_CHECK(checkRecord(historyCount - 1, stored - 1));
+    TEST_CHECK(checkTotals(2 * HISTORY_PAGE_RECORDS));
+    TEST_CHECK(historyDroppedCount == 0);
+}
+
+/**
+ * @brief A record torn by a reset is sent as lost after the reboot, and
+ *        the next summary is appended after it.
+ */
+static void testTornRecord(void) {
+
+    resetHistory();
+    storeGames(0, 5);
+
+    // Resetting while the sixth record is written, before its checksum
+    GameSummary summary = testGame(5);
+    HistoryRecord record = {.gameTicks = summary.gameTicks, .shotsTotal = summary.shotsTotal,
+                            .shotsMissed = summary.shotsMissed};
+    HistoryRecord *slot = (HistoryRecord *)((HistoryPageHeader *)historyPage(0) + 1) + 5;
+
+    MSC_Init();
+    TEST_CHECK(MSC_WriteWord((uint32_t *)slot, &record, 2 * sizeof(uint32_t)) == mscReturnOk);
+    MSC_Deinit();
+
+    initHistory();
+
+    if(!TEST_CHECK(readHistory())) return;
+    if(!TEST_CHECK(historyCount == 6)) return;
+
+    for(int i = 0; i < 5; i++) {
+        TEST_CHECK(checkRecord(i, i));
+    }
+    TEST_CHECK(historyRecords[5].mapIndex == HISTORY_LOST_RECORD);
+
+    // The torn slot is skipped
+    storeGames(6, 1);
+
+    if(!TEST_CHECK(readHistory())) return;
+    if(!TEST_CHECK(historyCount == 7)) return;
+    TEST_CHECK(checkRecord(6, 6));
+    TEST_CHECK(historyDroppedCount == 0);
+}
+
+/**
+ * @brief After a reboot the index rebuilt from the page headers sends the
+ *        same history, and appending goes on where it stopped. A page
+ *        header torn by a reset during an activation is erased before
+ *        the page is used.
+ */
+static void testReboot(void) {
+
+    static uint8_t before[TEST_UART_BUFFER_SIZE];
+
+    resetHistory();
+    storeGames(0, HISTORY_PAGE_RECORDS + 7);
+
+    if(!TEST_CHECK(readHistory())) return;
+    uint32_t length = testUartLength;
+    memcpy(before, testUartData, length);
+
+    // The first game is held until the stale pages are checked
+    initHistory();
+    TEST_CHECK(isHistoryBusy());
+    serviceHistory();
+    TEST_CHECK(!isHistoryBusy());
+
+    if(!TEST_CHECK(readHistory())) return;
+    TEST_CHECK(testUartLength == length && memcmp(before, testUartData, length) == 0);
+
+    // Resetting while the header of the next page is written
+    HistoryPageHeader header = {.magic = HISTORY_PAGE_MAGIC, .sequence = 3};
+
+    MSC_Init();
+    TEST_CHECK(MSC_WriteWord(historyPage(2), &header, 2 * sizeof(uint32_t)) == mscReturnOk);
+    MSC_Deinit();
+
+    initHistory();
+
+    // Filling the active page, then activating the next one
+    storeGames(HISTORY_PAGE_RECORDS + 7, HISTORY_PAGE_RECORDS - 7 + 1);
+
+    if(!TEST_CHECK(readHistory())) return;
+    TEST_CHECK(historySequence == 3);
+    if(!TEST_CHECK(historyCount == 2 * HISTORY_PAGE_RECORDS + 1)) return;
+
+    for(int i = 0; i < historyCount; i++) {
+        TEST_CHECK(checkRecord(i, i));
+    }
+    TEST_CHECK(historyDroppedCount == 0);
+}
+
+/**
+ * @brief The pages are used in turn, so they are erased equally often.
+ */
+static void testWear(void) {
+
+    const uint32_t firstPage = (FLASH_SIZE - HISTORY_PAGE_COUNT * FLASH_PAGE_SIZE) / FLASH_PAGE_SIZE;
+    const uint32_t rotations = 3;
+
+    uint32_t erasesBefore[HISTORY_PAGE_COUNT];
+    for(uint8_t page = 0; page < HISTORY_PAGE_COUNT; page++) {
+        erasesBefore[page] = silFlashEraseCounts[firstPage + page];
+    }
+
+    resetHistory();
+    storeGames(0, rotations * HISTORY_PAGE_COUNT * HISTORY_PAGE_RECORDS);
+
+    // Every activation after the first HISTORY_PAGE_COUNT - 1 erased one page
+    uint32_t erases = 0;
+    uint32_t fewest = UINT32_MAX;
+    uint32_t most = 0;
+
+    for(uint8_t page = 0; page < HISTORY_PAGE_COUNT; page++) {
+        uint32_t count = silFlashEraseCounts[firstPage + page] - erasesBefore[page];
+
+        erases += count;
+        if(count < fewest) fewest = count;
+        if(count > most) most = count;
+    }
+
+    TEST_CHECK(erases == rotations * HISTORY_PAGE_COUNT - (HISTORY_PAGE_COUNT - 1));
+    TEST_CHECK(most - fewest <= 1);
+    TEST_CHECK(historyDroppedCount == 0);
+}
+
+void testHistory(void) {
+    testAppend();
+    testRotation();
+    testTornRecord();
+    testReboot();
+    testWear();
+}
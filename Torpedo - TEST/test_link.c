@@ -0,0 +1,191 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    test_link.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Tests of the host commands and the baud-rate switch of the firmware link.
+ ********************************************************************************/
+
+// Project includes
+#include "test.h"
+#include "link.h"
+#include "statistics.h"
+
+
+/**
+ * @brief The baud-rate the host proposes in the tests.
+ */
+#define TEST_LINK_BAUDRATE      (921600)
+
+/**
+ * @brief The values of the echoes sent by the host: one of an earlier
+ *        switch received late, and the one verifying the current switch.
+ */
+#define TEST_STALE_ECHO         (0x11)
+#define TEST_VERIFY_ECHO        (0x5A)
+
+/**
+ * @brief The task created to set up the lists of the kernel, so the tick
+ *        can be advanced. The scheduler is never started, it never runs.
+ */
+static TaskHandle_t tickTask;
+
+/**
+ * @brief The body of the task, never run.
+ */
+static void prvTickTask(void *prvParam) {
+    while(1) vTaskSuspend(NULL);
+}
+
+/**
+ * @brief  Lets the specified number of ticks pass.
+ * @param  [in] The number of ticks.
+ */
+static void waitTicks(TickType_t ticks) {
+    for(TickType_t i = 0; i < ticks; i++) {
+        xTaskIncrementTick();
+    }
+}
+
+/**
+ * @brief  Runs the link like the statistics task: the buffered messages
+ *         are sent unless a new baud-rate is being verified.
+ * @return False while a new baud-rate is verified.
+ */
+static bool runLink(void) {
+
+    bool verified = serviceLink();
+    if(verified) {
+        transmitStatistics();
+    }
+
+    return verified;
+}
+
+/**
+ * @brief  Proposes a baud-rate to the link, like the host.
+ * @param  [in] The proposed baud-rate.
+ */
+static void proposeBaudrate(uint32_t baudrate) {
+    const uint8_t command[] = {CommandProposeBaudrate, baudrate, baudrate >> 8, baudrate >> 16, baudrate >> 24};
+    testSendCommand(command, sizeof(command));
+}
+
+/**
+ * @brief  Sends an echo command to the link, like the host.
+ * @param  [in] The echoed value.
+ */
+static void sendEcho(uint8_t value) {
+    const uint8_t command[] = {CommandEcho, value};
+    testSendCommand(command, sizeof(command));
+}
+
+/**
+ * @brief  Returns whether the link sent only an echo message since the
+ *         last reset of the board.
+ * @param  [in] The expected echo value.
+ * @return True if the echo was sent.
+ */
+static bool isEchoSent(uint8_t value) {
+    return testUartLength == 4 && testUartData[0] == EchoMsg && testUartData[3] == value;
+}
+
+/**
+ * @brief The transmit hook delivering the late echoes of an earlier switch
+ *        while the acknowledgement of the next one is sent: one is handled
+ *        by the interrupt, the other one is still held by the receiver.
+ */
+static void receiveStaleEchoes(void) {
+
+    testTransmitHook = NULL;
+
+    sendEcho(TEST_STALE_ECHO);
+
+    const uint8_t frame[] = {COMMAND_START, CommandEcho, TEST_STALE_ECHO};
+    testReceive(frame, sizeof(frame));
+}
+
+/**
+ * @brief A switch the host does not verify falls back to the previous
+ *        baud-rate. The late echo of the failed switch does not verify a
+ *        retry, only the echo received after the retry switched does.
+ */
+static void testFailedSwitch(void) {
+
+    // Starting at the default rate with an attached host
+    linkBaudrate = LINK_DEFAULT_BAUDRATE;
+    const uint8_t attach = CommandAttach;
+    testSendCommand(&attach, 1);
+    runLink();
+
+    // Switching without an echo
+    testResetBoard();
+    proposeBaudrate(TEST_LINK_BAUDRATE);
+    TEST_CHECK(!runLink());
+    TEST_CHECK(testUartLength > 0 && testUartData[0] == BaudrateAckMsg);
+    TEST_CHECK(testUartBaudrate == TEST_LINK_BAUDRATE);
+
+    // Falling back after the verification timed out
+    waitTicks(pdMS_TO_TICKS(LINK_VERIFY_TIMEOUT_MS) - 1);
+    TEST_CHECK(linkServiceDelay() == 1);
+    TEST_CHECK(!runLink());
+
+    waitTicks(1);
+    TEST_CHECK(linkServiceDelay() == 0);
+    TEST_CHECK(runLink());
+    TEST_CHECK(testUartBaudrate == LINK_DEFAULT_BAUDRATE);
+    TEST_CHECK(linkServiceDelay() == portMAX_DELAY);
+
+    // Retrying, while the echoes of the failed switch arrive late
+    testResetBoard();
+    testTransmitHook = receiveStaleEchoes;
+    proposeBaudrate(TEST_LINK_BAUDRATE);
+    TEST_CHECK(!runLink());
+    TEST_CHECK(testUartBaudrate == TEST_LINK_BAUDRATE);
+
+    // The stale echoes are discarded, and do not verify the new rate
+    TEST_CHECK(testReceivedLength() == 0);
+    testResetBoard();
+    TEST_CHECK(!runLink());
+    TEST_CHECK(testUartLength == 0);
+
+    // The echo of the host at the new rate verifies it
+    sendEcho(TEST_VERIFY_ECHO);
+    TEST_CHECK(runLink());
+    TEST_CHECK(isEchoSent(TEST_VERIFY_ECHO));
+    TEST_CHECK(testUartBaudrate == TEST_LINK_BAUDRATE);
+    TEST_CHECK(linkServiceDelay() == portMAX_DELAY);
+}
+
+void testLink(void) {
+
+    if(tickTask == NULL) {
+        xTaskCreate(prvTickTask, "TICK", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, &tickTask);
+    }
+
+    testFailedSwitch();
+}
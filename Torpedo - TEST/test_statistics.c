@@ -0,0 +1,369 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    test_statistics.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Tests of the telemetry messages encoded into the transmit buffer of the firmware.
+ ********************************************************************************/
+
+// Standard includes
+#include <string.h>
+
+// Project includes
+#include "test.h"
+#include "statistics.h"
+#include "link.h"
+
+
+/**
+ * @brief The length of each buffered message type on the wire, as
+ *        decoded by pep_hf_unix.
+ */
+static const uint8_t wireLengths[] = {
+    [GameStartedMsg]     = 9,
+    [GameFinishedMsg]    = 13,
+    [SegmentSelectedMsg] = 8,
+    [SegmentFiredMsg]    = 8,
+    [SegmentHitMsg]      = 8,
+    [SegmentMissedMsg]   = 8,
+    [TaskStatsMsg]       = 15,
+    [TickPeriodMsg]      = 8,
+    [BaudrateAckMsg]     = 8,
+    [EchoMsg]            = 4,
+    [IdleStatsMsg]       = 15
+};
+
+/**
+ * @brief The length of the backlog message header: type, count and tick.
+ */
+#define BACKLOG_HEADER_LENGTH   (7)
+
+/**
+ * @brief  Attaches or detaches the host with its commands.
+ * @param  [in] True to attach the host.
+ */
+static void setHostAttached(bool attached) {
+    const uint8_t command = attached ? CommandAttach : CommandDetach;
+    testSendCommand(&command, 1);
+}
+
+/**
+ * @brief  Returns a little-endian field of a message.
+ * @param  [in] The first byte of the field.
+ * @param  [in] The length of the field in bytes.
+ * @return The value of the field.
+ */
+static uint32_t readField(const uint8_t *data, int length) {
+
+    uint32_t value = 0;
+    for(int i = length - 1; i >= 0; i--) {
+        value = value << 8 | data[i];
+    }
+
+    return value;
+}
+
+/**
+ * @brief  Splits the bytes sent over the UART into messages.
+ * @param  [in] The offset of the first message in the sent bytes.
+ * @param  [out] The offsets of the messages.
+ * @param  [in] The size of the offsets array.
+ * @return The number of messages, -1 if the bytes do not end with a whole message.
+ */
+static int splitMessages(uint32_t offset, uint32_t offsets[], int maxCount) {
+
+    int count = 0;
+
+    while(offset < testUartLength && count < maxCount) {
+
+        uint8_t type = testUartData[offset];
+        if(type >= sizeof(wireLengths) || wireLengths[type] == 0) return -1;
+
+        offsets[count++] = offset;
+        offset += wireLengths[type];
+    }
+
+    return offset == testUartLength ? count : -1;
+}
+
+/**
+ * @brief  Attaches the host and sends every buffered message to it, the
+ *         backlog flushed when the host was away is discarded.
+ * @param  [out] The offsets of the sent messages.
+ * @param  [in] The size of the offsets array.
+ * @return The number of messages sent, -1 on a malformed transmission.
+ */
+static int transmitMessages(uint32_t offsets[], int maxCount) {
+
+    setHostAttached(true);
+    serviceLink();
+
+    testResetBoard();
+    transmitStatistics();
+
+    return splitMessages(0, offsets, maxCount);
+}
+
+/**
+ * @brief  Checks a sent message against its expected bytes.
+ * @param  [in] The offset of the message in the sent bytes.
+ * @param  [in] The expected sequence number.
+ * @param  [in] The expected type and fields, without the sequence number.
+ * @param  [in] The length of the expected type and fields.
+ * @return True if the message matches.
+ */
+static bool checkMessage(uint32_t offset, uint16_t sequence, const uint8_t *expected, uint32_t length) {
+
+    const uint8_t *message = &testUartData[offset];
+
+    return message[0] == expected[0] && readField(&message[1], 2) == sequence &&
+           memcmp(&message[3], &expected[1], length - 1) == 0;
+}
+
+/**
+ * @brief Every message type is encoded with its sequence number and
+ *        little-endian fields, in the order the messages were sent.
+ */
+static void testEncoding(void) {
+
+    uint32_t offsets[16];
+
+    // Starting from an empty buffer
+    transmitMessages(offsets, 16);
+
+    sendGameStartedMessage(0x01020304, 10, 7);
+    sendSegmentMessage(SegmentHitMsg, 0x0A0B0C0D, 42);
+    sendGameFinishedMessage(0x11223344, 0x01C8, 0x0102, 0x0304);
+    sendTaskStatsMessage("GAME_LOOP_TASK", 0x0123, 0x0456);
+    sendTaskStatsMessage("IDLE", 0x0789, 0x0ABC);
+    sendTickPeriodMessage(0x55667788, 20);
+    sendBaudrateAckMessage(921600, true);
+    sendEchoMessage(0x5A);
+    sendIdleStatsMessage(0x01020304, 0x05060708, 0x090A0B0C);
+
+    int count = transmitMessages(offsets, 16);
+    if(!TEST_CHECK(count == 9)) return;
+
+    uint16_t sequence = readField(&testUartData[offsets[0] + 1], 2);
+
+    const uint8_t gameStarted[] = {GameStartedMsg, 0x04, 0x03, 0x02, 0x01, 10, 7};
+    const uint8_t segmentHit[] = {SegmentHitMsg, 0x0D, 0x0C, 0x0B, 0x0A, 42};
+    const uint8_t gameFinished[] = {GameFinishedMsg, 0x44, 0x33, 0x22, 0x11, 0xC8, 0x01, 0x02, 0x01, 0x04, 0x03};
+    const uint8_t longName[] = {TaskStatsMsg, 'G', 'A', 'M', 'E', '_', 'L', 'O', 'O', 0x23, 0x01, 0x56, 0x04};
+    const uint8_t shortName[] = {TaskStatsMsg, 'I', 'D', 'L', 'E', 0, 0, 0, 0, 0x89, 0x07, 0xBC, 0x0A};
+    const uint8_t tickPeriod[] = {TickPeriodMsg, 0x88, 0x77, 0x66, 0x55, 20};
+    const uint8_t baudrateAck[] = {BaudrateAckMsg, 0x00, 0x10, 0x0E, 0x00, 1};
+    const uint8_t echo[] = {EchoMsg, 0x5A};
+    const uint8_t idleStats[] = {IdleStatsMsg, 4, 3, 2, 1, 8, 7, 6, 5, 12, 11, 10, 9};
+
+    TEST_CHECK(checkMessage(offsets[0], sequence, gameStarted, sizeof(gameStarted)));
+    TEST_CHECK(checkMessage(offsets[1], sequence + 1, segmentHit, sizeof(segmentHit)));
+    TEST_CHECK(checkMessage(offsets[2], sequence + 2, gameFinished, sizeof(gameFinished)));
+    TEST_CHECK(checkMessage(offsets[3], sequence + 3, longName, sizeof(longName)));
+    TEST_CHECK(checkMessage(offsets[4], sequence + 4, shortName, sizeof(shortName)));
+    TEST_CHECK(checkMessage(offsets[5], sequence + 5, tickPeriod, sizeof(tickPeriod)));
+    TEST_CHECK(checkMessage(offsets[6], sequence + 6, baudrateAck, sizeof(baudrateAck)));
+    TEST_CHECK(checkMessage(offsets[7], sequence + 7, echo, sizeof(echo)));
+    TEST_CHECK(checkMessage(offsets[8], sequence + 8, idleStats, sizeof(idleStats)));
+
+    // The buffer is empty after the transmission
+    TEST_CHECK(transmitMessages(offsets, 16) == 0);
+}
+
+/**
+ * @brief While the host is detached the game messages are stored, the
+ *        live messages are dropped without a sequence number, and the
+ *        stored ones are sent as a backlog when the host attaches.
+ */
+static void testDetached(void) {
+
+    uint32_t offsets[16];
+    transmitMessages(offsets, 16);
+
+    setHostAttached(false);
+
+    sendSegmentMessage(SegmentSelectedMsg, 1, 1);
+    sendSegmentMessage(SegmentFiredMsg, 2, 2);
+    sendEchoMessage(3);
+    sendSegmentMessage(SegmentMissedMsg, 4, 2);
+
+    // Nothing is sent while detached
+    testResetBoard();
+    transmitStatistics();
+    TEST_CHECK(testUartLength == 0);
+
+    testResetBoard();
+    setHostAttached(true);
+    serviceLink();
+
+    if(!TEST_CHECK(testUartLength > BACKLOG_HEADER_LENGTH)) return;
+    TEST_CHECK(testUartData[0] == BacklogMsg);
+    TEST_CHECK(readField(&testUartData[1], 2) == 2);
+
+    int count = splitMessages(BACKLOG_HEADER_LENGTH, offsets, 16);
+    if(!TEST_CHECK(count == 2)) return;
+
+    const uint8_t *fired = &testUartData[offsets[0]];
+    const uint8_t *missed = &testUartData[offsets[1]];
+
+    TEST_CHECK(fired[0] == SegmentFiredMsg && readField(&fired[3], 4) == 2);
+    TEST_CHECK(missed[0] == SegmentMissedMsg && readField(&missed[3], 4) == 4);
+
+    // No sequence number is taken by the dropped live messages
+    TEST_CHECK((uint16_t)(readField(&missed[1], 2) - readField(&fired[1], 2)) == 1);
+}
+
+/**
+ * @brief A full buffer drops whole messages by the overflow policy while
+ *        the host is attached, and the lost ones leave a gap in the
+ *        sequence numbers.
+ */
+static void testOverflow(void) {
+
+    static uint32_t offsets[STATISTICS_BUFFER_SIZE];
+    transmitMessages(offsets, STATISTICS_BUFFER_SIZE);
+
+    // Filling the buffer faster than it is sent, with a few more than fit
+    const int capacity = STATISTICS_BUFFER_SIZE / wireLengths[SegmentFiredMsg];
+    const int extra = 10;
+
+    uint32_t droppedBefore = statisticsDroppedCount;
+
+    for(int i = 0; i < capacity + extra; i++) {
+        sendSegmentMessage(SegmentFiredMsg, i, 0);
+    }
+
+    TEST_CHECK(statisticsDroppedCount - droppedBefore == extra);
+
+    int count = transmitMessages(offsets, STATISTICS_BUFFER_SIZE);
+    if(!TEST_CHECK(count == capacity)) return;
+
+    // The kept messages are consecutive
+    for(int i = 1; i < count; i++) {
+        TEST_CHECK((uint16_t)(readField(&testUartData[offsets[i] + 1], 2) -
+                              readField(&testUartData[offsets[i - 1] + 1], 2)) == 1);
+    }
+
+#if STATISTICS_OVERFLOW_POLICY == STATISTICS_DROP_OLDEST
+    // The newest messages are kept
+    TEST_CHECK(readField(&testUartData[offsets[0] + 3], 4) == extra);
+#else
+    // The oldest messages are kept
+    TEST_CHECK(readField(&testUartData[offsets[count - 1] + 3], 4) == capacity - 1);
+#endif
+
+    // The next message reveals the lost ones to the host
+    uint16_t lastSequence = readField(&testUartData[offsets[count - 1] + 1], 2);
+    sendSegmentMessage(SegmentFiredMsg, 0, 0);
+
+    count = transmitMessages(offsets, STATISTICS_BUFFER_SIZE);
+    if(!TEST_CHECK(count == 1)) return;
+
+#if STATISTICS_OVERFLOW_POLICY == STATISTICS_DROP_OLDEST
+    TEST_CHECK((uint16_t)(readField(&testUartData[offsets[0] + 1], 2) - lastSequence) == 1);
+#else
+    TEST_CHECK((uint16_t)(readField(&testUartData[offsets[0] + 1], 2) - lastSequence) == extra + 1);
+#endif
+}
+
+/**
+ * @brief While the host is detached a full buffer evicts the oldest games
+ *        as a whole, so the backlog holds the newest games from their
+ *        start to their summary. A game filling the buffer alone only
+ *        loses its oldest messages.
+ */
+static void testEvictGames(void) {
+
+    static uint32_t offsets[STATISTICS_BUFFER_SIZE];
+    transmitMessages(offsets, STATISTICS_BUFFER_SIZE);
+
+    // Games of ten shots, more than fit
+    const int shots = 10;
+    const int gameMessages = 2 + 2 * shots;
+    const int gameLength = wireLengths[GameStartedMsg] + wireLengths[GameFinishedMsg] +
+                           shots * (wireLengths[SegmentFiredMsg] + wireLengths[SegmentMissedMsg]);
+    const int capacity = STATISTICS_BUFFER_SIZE / gameLength;
+    const int games = capacity + 4;
+
+    setHostAttached(false);
+    uint32_t droppedBefore = statisticsDroppedCount;
+
+    for(int game = 0; game < games; game++) {
+        sendGameStartedMessage(0, 10, game);
+        for(int shot = 0; shot < shots; shot++) {
+            sendSegmentMessage(SegmentFiredMsg, shot, shot);
+            sendSegmentMessage(SegmentMissedMsg, shot, shot);
+        }
+        sendGameFinishedMessage(shots, shots, 0, 0);
+    }
+
+    // Only whole games are lost
+    TEST_CHECK(statisticsDroppedCount - droppedBefore == (uint32_t)(games - capacity) * gameMessages);
+
+    testResetBoard();
+    setHostAttached(true);
+    serviceLink();
+
+    int count = splitMessages(BACKLOG_HEADER_LENGTH, offsets, STATISTICS_BUFFER_SIZE);
+    if(!TEST_CHECK(count == capacity * gameMessages)) return;
+
+    // The newest games are kept, each from its start to its summary
+    for(int i = 0; i < capacity; i++) {
+        const uint8_t *started = &testUartData[offsets[i * gameMessages]];
+        const uint8_t *finished = &testUartData[offsets[(i + 1) * gameMessages - 1]];
+
+        TEST_CHECK(started[0] == GameStartedMsg && started[8] == games - capacity + i);
+        TEST_CHECK(finished[0] == GameFinishedMsg && readField(&finished[7], 2) == shots);
+    }
+
+    // A single game longer than the buffer keeps its newest messages
+    const int capacityShots = STATISTICS_BUFFER_SIZE / (wireLengths[SegmentFiredMsg] + wireLengths[SegmentMissedMsg]);
+
+    setHostAttached(false);
+    sendGameStartedMessage(0, 10, 0);
+    for(int shot = 0; shot < capacityShots + shots; shot++) {
+        sendSegmentMessage(SegmentFiredMsg, shot, 0);
+        sendSegmentMessage(SegmentMissedMsg, shot, 0);
+    }
+
+    testResetBoard();
+    setHostAttached(true);
+    serviceLink();
+
+    count = splitMessages(BACKLOG_HEADER_LENGTH, offsets, STATISTICS_BUFFER_SIZE);
+    if(!TEST_CHECK(count > 0)) return;
+
+    const uint8_t *last = &testUartData[offsets[count - 1]];
+    TEST_CHECK(last[0] == SegmentMissedMsg && readField(&last[3], 4) == (uint32_t)(capacityShots + shots - 1));
+}
+
+void testStatistics(void) {
+    testEncoding();
+    testDetached();
+    testOverflow();
+    testEvictGames();
+}
@@ -0,0 +1,138 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    test_tick_suppression.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Tests of the tickless idle arithmetic of the firmware.
+ ********************************************************************************/
+
+// Project includes
+#include "test.h"
+#include "tick_suppression.h"
+
+
+/**
+ * @brief The kernel tick rate and the RTC frequency of the firmware.
+ */
+#define TICK_RATE_HZ        (1000)
+#define SLEEP_TIMER_HZ      (32768)
+
+/**
+ * @brief The longest sleep fits the 24-bit RTC.
+ */
+static void testMaxSuppressedTicks(void) {
+
+    uint32_t maxTicks = maxSuppressedTicks(TICK_RATE_HZ, SLEEP_TIMER_HZ, 0xFFFFFF);
+
+    TEST_CHECK(maxTicks == 511999);
+    TEST_CHECK((uint64_t)maxTicks * SLEEP_TIMER_HZ / TICK_RATE_HZ <= 0xFFFFFF);
+    TEST_CHECK(maxSuppressedTicks(100, SLEEP_TIMER_HZ, 0xFFFFFF) == 51199);
+}
+
+/**
+ * @brief The sleep ends at or before the tick boundary, by less than one count.
+ */
+static void testSleepCounts(void) {
+
+    // Whole ticks from the start of a tick
+    TEST_CHECK(sleepCountsUntilTick(1, 0, TICK_RATE_HZ, SLEEP_TIMER_HZ) == 32);
+    TEST_CHECK(sleepCountsUntilTick(10, 0, TICK_RATE_HZ, SLEEP_TIMER_HZ) == 327);
+    TEST_CHECK(sleepCountsUntilTick(1000, 0, TICK_RATE_HZ, SLEEP_TIMER_HZ) == 32768);
+
+    // Boundaries already passed, or reached
+    TEST_CHECK(sleepCountsUntilTick(0, 0, TICK_RATE_HZ, SLEEP_TIMER_HZ) == 0);
+    TEST_CHECK(sleepCountsUntilTick(0, 5000, TICK_RATE_HZ, SLEEP_TIMER_HZ) == 0);
+    TEST_CHECK(sleepCountsUntilTick(1, SLEEP_TIMER_HZ, TICK_RATE_HZ, SLEEP_TIMER_HZ) == 0);
+
+    // Less than one count left to the next boundary: no sleep is possible,
+    // vPortSuppressTicksAndSleep() aborts instead of programming COMP0 = 0
+    TEST_CHECK(sleepCountsUntilTick(1, SLEEP_TIMER_HZ - TICK_RATE_HZ, TICK_RATE_HZ, SLEEP_TIMER_HZ) == 1);
+    TEST_CHECK(sleepCountsUntilTick(1, SLEEP_TIMER_HZ - TICK_RATE_HZ + 1, TICK_RATE_HZ, SLEEP_TIMER_HZ) == 0);
+    TEST_CHECK(sleepCountsUntilTick(1, SLEEP_TIMER_HZ - 1, TICK_RATE_HZ, SLEEP_TIMER_HZ) == 0);
+
+    // A tick later, the sleep is one tick long
+    TEST_CHECK(sleepCountsUntilTick(2, SLEEP_TIMER_HZ - 1, TICK_RATE_HZ, SLEEP_TIMER_HZ) == 32);
+
+    // Rounded down, by less than one count, from every position in the tick
+    for(uint32_t ticks = 1; ticks <= 3; ticks++) {
+        for(uint32_t elapsed = 0; elapsed < SLEEP_TIMER_HZ; elapsed++) {
+
+            uint64_t units = (uint64_t)ticks * SLEEP_TIMER_HZ - elapsed;
+            uint32_t counts = sleepCountsUntilTick(ticks, elapsed, TICK_RATE_HZ, SLEEP_TIMER_HZ);
+
+            if(!TEST_CHECK((uint64_t)counts * TICK_RATE_HZ <= units &&
+                           (uint64_t)(counts + 1) * TICK_RATE_HZ > units)) {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief The ticks slept and the position in the running tick account
+ *        for every unit, so no time is lost between sleeps.
+ */
+static void testSleptTicks(void) {
+
+    uint32_t remaining;
+
+    // No time slept
+    TEST_CHECK(sleptTicks(0, 1234, TICK_RATE_HZ, SLEEP_TIMER_HZ, &remaining) == 0);
+    TEST_CHECK(remaining == 1234);
+
+    // One second
+    TEST_CHECK(sleptTicks(SLEEP_TIMER_HZ, 0, TICK_RATE_HZ, SLEEP_TIMER_HZ, &remaining) == 1000);
+    TEST_CHECK(remaining == 0);
+
+    // The part of a tick carries over
+    TEST_CHECK(sleptTicks(32, 800, TICK_RATE_HZ, SLEEP_TIMER_HZ, &remaining) == 1);
+    TEST_CHECK(remaining == 32 * TICK_RATE_HZ + 800 - SLEEP_TIMER_HZ);
+
+    // The longest sleep does not overflow
+    uint32_t maxTicks = maxSuppressedTicks(TICK_RATE_HZ, SLEEP_TIMER_HZ, 0xFFFFFF);
+    TEST_CHECK(sleptTicks(0xFFFFFF, SLEEP_TIMER_HZ - 1, TICK_RATE_HZ, SLEEP_TIMER_HZ, &remaining) == maxTicks + 1);
+
+    // Sleeping to a boundary ends in the tick before it, or exactly on it
+    for(uint32_t ticks = 1; ticks <= 3; ticks++) {
+        for(uint32_t elapsed = 0; elapsed < SLEEP_TIMER_HZ; elapsed += 7) {
+
+            uint32_t counts = sleepCountsUntilTick(ticks, elapsed, TICK_RATE_HZ, SLEEP_TIMER_HZ);
+            uint32_t slept = sleptTicks(counts, elapsed, TICK_RATE_HZ, SLEEP_TIMER_HZ, &remaining);
+
+            if(!TEST_CHECK((slept == ticks && remaining < TICK_RATE_HZ) ||
+                           (slept == ticks - 1 && remaining > SLEEP_TIMER_HZ - TICK_RATE_HZ))) {
+                return;
+            }
+        }
+    }
+}
+
+void testTickSuppression(void) {
+    testMaxSuppressedTicks();
+    testSleepCounts();
+    testSleptTicks();
+}
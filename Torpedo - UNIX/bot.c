@@ -0,0 +1,226 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    bot.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Autoplayer playing the EFM32GG as fast as it accepts inputs.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Project includes
+#include "bot.h"
+#include "map_index.h"
+#include "serial_link.h"
+
+
+/**
+ * @brief Flag enabling the autoplayer, set from the command line.
+ */
+int botEnabled = 0;
+
+/**
+ * @brief The keys of the input actions, the ACTION_x characters of
+ *        input.h of the EFM32GG.
+ */
+static const uint8_t actionKeys[] = {
+    [MoveLeft] = 'a', [MoveRight] = 'd', [MoveUp] = 'w', [MoveDown] = 's', [Fire] = ' '
+};
+
+// The segment selected on the EFM32GG
+static uint8_t cursorSegment = 0;
+
+// The segments fired at in the running game
+static SegmentMap firedSegments = {0};
+
+// Flag indicating that a game is running and a shot result is awaited
+static int playing = 0;
+
+// The time of the last shot or cursor move
+static struct timespec shotTime;
+
+// The number of finished games and the time of the first game start
+static unsigned gamesFinished = 0;
+static struct timespec firstStartTime;
+
+// The number of decisions, and their total and largest latency in microseconds
+static unsigned decisionCount = 0;
+static double decisionLatencySum = 0;
+static double decisionLatencyMax = 0;
+
+/**
+ * @brief   Returns the microseconds elapsed since the specified time.
+ * @param   [in] The start time.
+ * @returns The elapsed time in microseconds.
+ */
+static double elapsedUs(const struct timespec *since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1e6 + (now.tv_nsec - since->tv_nsec) / 1e3;
+}
+
+/**
+ * @brief   Chooses the next segment to fire at.
+ * @details While several maps are candidates, the segments minimizing the
+ *          expected misses are considered, once the map is identified its
+ *          remaining ship parts. The closest one to the cursor is chosen.
+ *          If the shots match no map, the closest unfired segment is.
+ * @returns The ID of the segment, or CURSOR_HIDDEN if every segment was fired at.
+ */
+static uint8_t chooseTarget(void) {
+
+    uint16_t candidates = candidateMaps;
+    int identified = __builtin_popcount(candidates) == 1;
+    double best = candidates != 0 && !identified ? expectedMisses(candidates) : 0;
+
+    uint8_t target = CURSOR_HIDDEN;
+    uint8_t targetDistance = 0;
+    uint8_t fallback = CURSOR_HIDDEN;
+    uint8_t fallbackDistance = 0;
+
+    for(uint8_t i = 0; i < LCD_SEGMENTS_COUNT; i++) {
+        if(segmentMapTest(firedSegments, i)) continue;
+
+        uint8_t distance = segmentDistance(cursorSegment, i);
+        if(fallback == CURSOR_HIDDEN || distance < fallbackDistance) {
+            fallback = i;
+            fallbackDistance = distance;
+        }
+
+        // Skipping the segments not worth a shot
+        uint16_t ships = segmentMaps[i] & candidates;
+        if(candidates == 0 || ships == 0) continue;
+        if(!identified && (ships == candidates ||
+           expectedMissesAfterShot(candidates, ships) > best + MISSES_EPSILON)) continue;
+
+        if(target == CURSOR_HIDDEN || distance < targetDistance) {
+            target = i;
+            targetDistance = distance;
+        }
+    }
+
+    return target != CURSOR_HIDDEN ? target : fallback;
+}
+
+/**
+ * @brief Sends the inputs of the next shot to the EFM32GG.
+ * @param [in] The file descriptor of the terminal.
+ */
+static void playShot(int terminalFileDescriptor) {
+
+    struct timespec decisionStart;
+    clock_gettime(CLOCK_MONOTONIC, &decisionStart);
+    shotTime = decisionStart;
+
+    // Not interfering with the baud-rate negotiation, and only following
+    // the replayed messages of the EFM32GG, retried when idle
+    if(linkNegotiating || backlogReplaying) return;
+
+    uint8_t target = chooseTarget();
+    if(target == CURSOR_HIDDEN) {
+        playing = 0;
+        return;
+    }
+
+    // Planning the moves and converting them to keys
+    uint8_t actions[MOVE_PLAN_MAX_LENGTH];
+    uint8_t keys[MOVE_PLAN_MAX_LENGTH];
+    uint8_t length = planMoves(cursorSegment, target, actions);
+    for(uint8_t i = 0; i < length; i++) keys[i] = actionKeys[actions[i]];
+
+    writeToBoard(terminalFileDescriptor, keys, length);
+
+    // Measuring the time from the decoded message to the written inputs
+    double latency = elapsedUs(&decisionStart);
+    decisionCount++;
+    decisionLatencySum += latency;
+    if(latency > decisionLatencyMax) decisionLatencyMax = latency;
+}
+
+void botGameStarted(int terminalFileDescriptor) {
+
+    if(!botEnabled) return;
+
+    if(gamesFinished == 0 && decisionCount == 0) {
+        clock_gettime(CLOCK_MONOTONIC, &firstStartTime);
+    }
+
+    // The cursor starts on the first segment
+    cursorSegment = 0;
+    memset(firedSegments, 0, sizeof(firedSegments));
+
+    playing = 1;
+    playShot(terminalFileDescriptor);
+}
+
+void botSegmentSelected(uint8_t segment) {
+    if(segment < LCD_SEGMENTS_COUNT) cursorSegment = segment;
+
+    // The inputs are being processed, so not retried yet
+    clock_gettime(CLOCK_MONOTONIC, &shotTime);
+}
+
+void botShotResult(int terminalFileDescriptor, uint8_t segment) {
+
+    if(!botEnabled || !playing) return;
+
+    if(segment < LCD_SEGMENTS_COUNT) segmentMapSet(firedSegments, segment);
+
+    // The last hit ends the game, further inputs would go to the next one
+    if(hitCount == SHIP_SEGMENTS_COUNT) {
+        playing = 0;
+        return;
+    }
+
+    playShot(terminalFileDescriptor);
+}
+
+void botGameFinished(void) {
+
+    if(!botEnabled) return;
+
+    gamesFinished++;
+    playing = 0;
+
+    double hours = elapsedUs(&firstStartTime) / 3.6e9;
+    printf("[BOT             ]: games = %u, games/hour = %.1lf, decision latency = %.1lf us avg, %.1lf us max\n\n",
+           gamesFinished, gamesFinished / hours,
+           decisionCount ? decisionLatencySum / decisionCount : 0, decisionLatencyMax);
+}
+
+void botIdle(int terminalFileDescriptor) {
+
+    if(!botEnabled || !playing) return;
+
+    // Firing again from the current cursor if the inputs or the result were lost
+    if(elapsedUs(&shotTime) > BOT_RETRY_TIMEOUT_MS * 1000.0) {
+        playShot(terminalFileDescriptor);
+    }
+}
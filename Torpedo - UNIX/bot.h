@@ -0,0 +1,87 @@
+#pragma once
+#ifndef BOT_H
+#define BOT_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    bot.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Autoplayer playing the EFM32GG as fast as it accepts inputs.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/**
+ * @brief Defines the time without a cursor move or a shot result after
+ *        which the autoplayer assumes its inputs were lost and fires again.
+ *        A hit takes 2.24 s on the EFM32GG, the spinner and the blinking.
+ */
+#define BOT_RETRY_TIMEOUT_MS    (5000)
+
+/**
+ * @brief Flag enabling the autoplayer, set from the command line.
+ */
+extern int botEnabled;
+
+/**
+ * @brief Plays the first shot of a new game.
+ * @param [in] The file descriptor of the terminal.
+ */
+void botGameStarted(int terminalFileDescriptor);
+
+/**
+ * @brief Follows the cursor of the EFM32GG.
+ * @param [in] The ID of the segment selected or fired at.
+ */
+void botSegmentSelected(uint8_t segment);
+
+/**
+ * @brief   Plays the next shot after the result of the previous one.
+ * @details The candidate maps must already be narrowed by the result,
+ *          which is all the autoplayer needs to know of it.
+ * @param   [in] The file descriptor of the terminal.
+ * @param   [in] The ID of the segment fired at.
+ */
+void botShotResult(int terminalFileDescriptor, uint8_t segment);
+
+/**
+ * @brief Prints the game rate and the decision latency of the autoplayer.
+ */
+void botGameFinished(void);
+
+/**
+ * @brief   Fires again if a shot result is overdue.
+ * @details Called by the statistics task while no messages arrive.
+ * @param   [in] The file descriptor of the terminal.
+ */
+void botIdle(int terminalFileDescriptor);
+
+#endif // BOT_H
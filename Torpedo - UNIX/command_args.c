@@ -38,6 +38,7 @@
 
 // Project includes
 #include "command_args.h"
+#include "serial_link.h"
 
 
 /**
@@ -82,13 +83,15 @@ struct BNUM_speed g_speed[] = {
 
 /**
  * @brief Parses the specified command line arguments and sets the
- *        termios speed and serial port name values.
+ *        termios speed, serial port name, tick period and bot mode values.
  * @param [in] The number of arguments.
  * @param [in] The string array of arguments.
  * @param [out] The termios speed value.
  * @param [out] The name of the serial port.
+ * @param [out] The requested tick period in milliseconds, unchanged if not specified.
+ * @param [out] Set to 1 if the autoplayer is requested, unchanged otherwise.
  */
-void parseCommandLine(int argc, char*const* argv, uint32_t* speed, char *port) {
+void parseCommandLine(int argc, char*const* argv, uint32_t* speed, char *port, uint8_t *tickPeriodMs, int *bot) {
 
     // The termios speed value
     int64_t termiosSpeed = 0;
@@ -97,7 +100,7 @@ void parseCommandLine(int argc, char*const* argv, uint32_t* speed, char *port) {
     int opt = 0;
 
     // Parsing command line arguments
-    while((opt = getopt(argc, argv, "hs:p:")) != -1) {
+    while((opt = getopt(argc, argv, "hbs:p:t:")) != -1) {
         switch(opt) {
 
         // Printing program help
@@ -137,6 +140,27 @@ void parseCommandLine(int argc, char*const* argv, uint32_t* speed, char *port) {
             strcpy(port, optarg);
             break;
 
+        // Setting the tick period of the game
+        case 't':
+
+            // Checking the range supported by the EFM32GG
+            if(atoi(optarg) < TICK_PERIOD_MIN_MS || atoi(optarg) > TICK_PERIOD_MAX_MS) {
+                fprintf(stderr, "ERROR: The tick period must be between %d and %d ms!\n",
+                        TICK_PERIOD_MIN_MS, TICK_PERIOD_MAX_MS);
+                break;
+            } else {
+                printf("INFO: Setting tick period to %d ms\n", atoi(optarg));
+            }
+
+            *tickPeriodMs = atoi(optarg);
+            break;
+
+        // Enabling the autoplayer
+        case 'b':
+            printf("INFO: Playing with the autoplayer\n");
+            *bot = 1;
+            break;
+
         default: break;
         };
     }
@@ -166,6 +190,24 @@ int64_t toTermiosSpeed(unsigned speed) {
     return g_speed[i].bnum;
 }
 
+/**
+ * @brief  Returns the baud-rate of the specified termios speed value.
+ * @param  [in] The termios speed value.
+ * @return The baud-rate (in bits/seconds) or 0 when not supported.
+ */
+uint32_t fromTermiosSpeed(uint32_t bnum) {
+
+    // Iterator to index g_speed[]
+    unsigned i;
+
+    // Searching g_speed for the termios value, the null termination
+    // terminates the search with 0
+    for (i = 0; g_speed[i].speed != 0 && g_speed[i].bnum != bnum; i++);
+
+    // Returning the baud-rate
+    return g_speed[i].speed;
+}
+
 /**
  * @brief Prints the command line usage help to STDOUT.
  */
@@ -176,6 +218,17 @@ void printHelp(void) {
            "-h: Prints this help.                                \n"
            "-s <baudrate>: Sets the baudrate.                    \n"
            "-p <portname>: Sets the portname (eg. /dev/ttyACM0). \n"
+           "-t <ms>: Sets the game tick period (5-100 ms).       \n"
+           "-b: Plays the games with the autoplayer, starting at \n"
+           "   the next game start (reset the EFM32GG).          \n"
+           "                                                     \n"
+           "Keys: w/a/s/d moves, space fires, q quits, t dumps   \n"
+           "the event trace of a trace build to a JSON file,     \n"
+           "h downloads the game history to a CSV file,          \n"
+           "+/- lengthens/shortens the tick period by 5 ms.      \n"
+           "                                                     \n"
+           "The fastest Baud-rate the link sustains is negotiated\n"
+           "with the EFM32GG, starting from the specified one.   \n"
            "                                                     \n"
            "Example usage:                                       \n"
            "sudo ./pep_hf_unix -p \"/dev/ttyACM0\" -s 115200   \n\n");
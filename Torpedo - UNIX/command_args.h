@@ -57,13 +57,15 @@ struct BNUM_speed {
 
 /**
  * @brief Parses the specified command line arguments and sets the
- *        termios speed and serial port name values.
+ *        termios speed, serial port name, tick period and bot mode values.
  * @param [in] The number of arguments.
  * @param [in] The string array of arguments.
  * @param [out] The termios speed value.
  * @param [out] The name of the serial port.
+ * @param [out] The requested tick period in milliseconds, unchanged if not specified.
+ * @param [out] Set to 1 if the autoplayer is requested, unchanged otherwise.
  */
-void parseCommandLine(int argc, char*const* argv, uint32_t* speed, char *port);
+void parseCommandLine(int argc, char*const* argv, uint32_t* speed, char *port, uint8_t *tickPeriodMs, int *bot);
 
 /**
  * @brief  Returns the termios equivalent value of the specified baud-rate.
@@ -72,6 +74,13 @@ void parseCommandLine(int argc, char*const* argv, uint32_t* speed, char *port);
  */
 int64_t toTermiosSpeed(unsigned speed);
 
+/**
+ * @brief  Returns the baud-rate of the specified termios speed value.
+ * @param  [in] The termios speed value.
+ * @return The baud-rate (in bits/seconds) or 0 when not supported.
+ */
+uint32_t fromTermiosSpeed(uint32_t bnum);
+
 /**
  * @brief Prints the command line usage help to STDOUT.
  */
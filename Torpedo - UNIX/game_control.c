@@ -38,18 +38,32 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <time.h>
 
 // Project includes
 #include "game_control.h"
+#include "command_args.h"
+#include "serial_link.h"
 
 
+/**
+ * @brief   Returns the milliseconds elapsed since the specified time.
+ * @param   [in] The start time.
+ * @returns The elapsed time in milliseconds.
+ */
+static long elapsedMs(const struct timespec *since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000 + (now.tv_nsec - since->tv_nsec) / 1000000;
+}
+
 /**
  * @brief   Task function that waits for STDIN to receive character
  *	        input, and forwards it to the EFM32GG.
  * @param   [in] The args param is a pointer to a controlParams
  *               structure - typecasted to void* - containing a
  *               pointer to the statisticsReleased semaphore,
- *               the terminal baudrate and port name.
+ *               the terminal baudrate, port name and tick period.
  * @returns NULL
  */
 void* controlTaskFunction(void *args) {
@@ -121,24 +135,59 @@ void* controlTaskFunction(void *args) {
     // Releasing the statistics thread to proceed after the terminal is initialized
     sem_post(statisticsReleased);
 
+    // Receiving the messages the EFM32GG stored while no host was attached
+    if(good) attachToBoard(terminalFileDescriptor);
+
+    // The baud-rate the EFM32GG starts with
+    uint32_t startBaudrate = fromTermiosSpeed(baudrate);
+
+    // Switching to the fastest baud-rate the link sustains, the
+    // answers of the EFM32GG are received by the statistics thread
+    uint32_t currentBaudrate = startBaudrate;
+    if(good) currentBaudrate = negotiateBaudrate(terminalFileDescriptor, &terminal, startBaudrate);
+
+    // Requesting the tick period specified on the command line
+    uint8_t tickPeriodMs = params->tickPeriodMs;
+    if(good && tickPeriodMs != 0) sendTickPeriodCommand(terminalFileDescriptor, tickPeriodMs);
+
+    // The time of the last heartbeat, counted from the attach command
+    struct timespec heartbeatTime;
+    clock_gettime(CLOCK_MONOTONIC, &heartbeatTime);
+
     // Repeat until stop is issued by sending the letter 'q'
     while(good) {
 
+        // Keeping the EFM32GG transmitting, also while keys are pressed
+        long heartbeatElapsedMs = elapsedMs(&heartbeatTime);
+        if(heartbeatElapsedMs >= LINK_HEARTBEAT_PERIOD_MS) {
+            if(sendHeartbeat(terminalFileDescriptor) == -1) break;
+            clock_gettime(CLOCK_MONOTONIC, &heartbeatTime);
+            heartbeatElapsedMs = 0;
+        }
+
         // Preparing for reading STDIN via select(2)
         fd_set fileDescriptors;
         FD_ZERO(&fileDescriptors);
         FD_SET(STDIN_FILENO, &fileDescriptors);
 
-        // Wait for a character to be ready on STDIN
-        int status = select(STDIN_FILENO + 1, &fileDescriptors, NULL, NULL, NULL);
+        // Wait for a character to be ready on STDIN, or for the next heartbeat
+        long remainingMs = LINK_HEARTBEAT_PERIOD_MS - heartbeatElapsedMs;
+        struct timeval timeout;
+        timeout.tv_sec = remainingMs / 1000;
+        timeout.tv_usec = (remainingMs % 1000) * 1000;
 
-        // Handling errors of select(2) - timeout NOT used
+        int status = select(STDIN_FILENO + 1, &fileDescriptors, NULL, NULL, &timeout);
+
+        // Handling errors of select(2)
         if(status == -1) {
             perror("The game control task has encountered an unexpected error "
                    "while waiting for STDIN input in select(2)");
             break;
         }
 
+        // Sending the heartbeat at the top of the loop
+        if(status == 0) continue;
+
         // Read the next character from STDIN
         unsigned char c;
         if(read(STDIN_FILENO, &c, 1) == -1) {
@@ -150,14 +199,38 @@ void* controlTaskFunction(void *args) {
         // Check character for stop command
         if(c == 'q' || c == 'Q') break;
 
+        // Adjusting the tick period, starting from the default of the EFM32GG
+        if(c == '+' || c == '-') {
+            if(tickPeriodMs == 0) tickPeriodMs = TICK_PERIOD_DEFAULT_MS;
+            if(c == '+' && tickPeriodMs + TICK_PERIOD_STEP_MS <= TICK_PERIOD_MAX_MS) tickPeriodMs += TICK_PERIOD_STEP_MS;
+            if(c == '-' && tickPeriodMs - TICK_PERIOD_STEP_MS >= TICK_PERIOD_MIN_MS) tickPeriodMs -= TICK_PERIOD_STEP_MS;
+
+            if(sendTickPeriodCommand(terminalFileDescriptor, tickPeriodMs) == -1) break;
+            continue;
+        }
+
+        // Downloading the game history stored by the EFM32GG
+        if(c == 'h' || c == 'H') {
+            if(requestHistory(terminalFileDescriptor) == -1) break;
+            continue;
+        }
+
         // Forward the character to the EFM32GG
-        if(write(terminalFileDescriptor, &c, 1) == -1) {
+        if(writeToBoard(terminalFileDescriptor, &c, 1) == -1) {
             perror("The game control task has encountered an unexpected error "
                    "while writing to the EFM32GG.");
             break;
         }
     }
 
+    // Restoring the start baud-rate, so the next session can connect
+    if(good && currentBaudrate != startBaudrate) {
+        switchBaudrate(terminalFileDescriptor, &terminal, currentBaudrate, startBaudrate);
+    }
+
+    // Letting the EFM32GG store its messages until the next session
+    if(good) detachFromBoard(terminalFileDescriptor);
+
     // Releasing resources
     close(terminalFileDescriptor);
 
@@ -46,6 +46,7 @@ struct controlParams {
     sem_t        *statisticsReleased;   /**< Mutex releasing the statistics task to proceed.        */
     const char   *portName;             /**< The name of the terminal port.                         */
     uint32_t      speed;                /**< The baudrate value of the terminal (in termios value). */
+    uint8_t       tickPeriodMs;         /**< The tick period requested for the game, or 0.          */
 };
 
 /**
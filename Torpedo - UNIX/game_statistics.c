@@ -38,22 +38,33 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <time.h>
 
 
 // Project includes
 #include "game_statistics.h"
+#include "trace_export.h"
+#include "serial_link.h"
+#include "map_index.h"
+#include "bot.h"
 
 
 // Global statistics values
 
 // The total number of shots fired
-uint8_t shotsTotal = 0;
+uint16_t shotsTotal = 0;
 
 // The time delay between game ticks in milliseconds
 uint8_t tickDelayMs = 0;
 
-// The game tick value at the last segment hit event
-uint32_t lastHitTick = 0;
+// The game time at the last segment hit event in milliseconds
+double lastHitMs = 0;
+
+// The game tick value when the current tick period was applied
+uint32_t periodStartTick = 0;
+
+// The game time when the current tick period was applied in milliseconds
+double periodStartMs = 0;
 
 // The total number of missed shots
 uint32_t missTotal = 0;
@@ -67,8 +78,44 @@ uint32_t stopTick = 0;
 // The index of the game map
 uint8_t mapIndex = 0;
 
-// The sum of time intervals between segment hit events
-uint32_t sumHitTimes = 0;
+// The number of game ticks that overran the tick period
+uint16_t tickOverruns = 0;
+
+// The largest delay of a game tick start in milliseconds
+uint16_t maxTickLatenessMs = 0;
+
+// The number of sleeps of the EFM32GG during the game
+uint32_t sleepCount = 0;
+
+// The idle time expected by the EFM32GG kernel during the game in milliseconds
+uint32_t expectedIdleMs = 0;
+
+// The time the EFM32GG actually slept during the game in milliseconds
+uint32_t actualIdleMs = 0;
+
+// The sum of time intervals between segment hit events in milliseconds
+double sumHitTimes = 0;
+
+// The sequence number expected in the next message
+uint16_t expectedSequence = 0;
+
+// Flag indicating that a sequence number was already received
+int sequenceReceived = 0;
+
+// The total number of messages lost since the program started
+uint32_t lostTotal = 0;
+
+// The number of stored messages still to be replayed
+uint16_t backlogRemaining = 0;
+
+// The uptime of the EFM32GG in the last backlog message in milliseconds
+uint32_t backlogUptimeMs = 0;
+
+// The time the last backlog message was received
+struct timespec backlogTime;
+
+// Flag indicating that a backlog message was already received
+int backlogReceived = 0;
 
 
 /**
@@ -106,6 +153,60 @@ int readByteFromTerminal(int terminalFileDescriptor, struct timeval timeout) {
     return c;
 }
 
+/**
+ * @brief  Converts a game tick of the current game to milliseconds since
+ *         the game start, accounting for every tick period change.
+ * @param  [in] The game tick, not before the last tick period change.
+ * @return The game time in milliseconds.
+ */
+static double gameTickToMs(uint32_t gameTick) {
+    return periodStartMs + (double)(gameTick - periodStartTick) * tickDelayMs;
+}
+
+/**
+ * @brief   Reads the sequence number following the message identifier
+ *          and accounts the messages lost since the previous one.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readMessageSequence(int terminalFileDescriptor) {
+
+    // Timeout between bytes of one message is 1ms
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 1000;
+
+    // Buffer for reading bytes from the terminal
+    int bytes[2] = {0};
+
+    // Reading bytes of the sequence number
+    bytes[0] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    bytes[1] = readByteFromTerminal(terminalFileDescriptor, timeout);
+
+    // Checking read errors
+    if(bytes[0] == READ_ERROR || bytes[0] == READ_TIMEOUT ||
+       bytes[1] == READ_ERROR || bytes[1] == READ_TIMEOUT)
+    {
+        return -1;
+    }
+
+    uint16_t sequence = bytes[0] | bytes[1] << 8;
+
+    if(sequenceReceived && sequence != expectedSequence) {
+        // Every skipped sequence number is a message lost on the EFM32GG
+        uint16_t lost = sequence - expectedSequence;
+        lostTotal += lost;
+
+        // Printing loss information
+        printf("[MESSAGES_LOST   ]: lost = %u, lostTotal = %u\n", lost, lostTotal);
+    }
+
+    sequenceReceived = 1;
+    expectedSequence = sequence + 1;
+
+    return 0;
+}
+
 /**
  * @brief   Reads one game-started message from the terminal.
  * @param   The file descriptor of the terminal.
@@ -121,11 +222,20 @@ int readGameStartedMessage(int terminalFileDescriptor) {
     // Resetting global statistics
     shotsTotal = 0;
     tickDelayMs = 0;
-    lastHitTick = 0;
+    lastHitMs = 0;
+    periodStartMs = 0;
     missTotal = 0;
     startTick = 0;
     stopTick = 0;
     sumHitTimes = 0;
+    tickOverruns = 0;
+    maxTickLatenessMs = 0;
+    sleepCount = 0;
+    expectedIdleMs = 0;
+    actualIdleMs = 0;
+
+    // Every map is a candidate of the new game
+    resetCandidateMaps();
 
     // Buffer for reading bytes from the terminal
     int bytes[4] = {0};
@@ -164,9 +274,15 @@ int readGameStartedMessage(int terminalFileDescriptor) {
     }
     else return -1;
 
+    // The tick period applies from the game start
+    periodStartTick = startTick;
+
     // Printing message information
     printf("[GAME_STARTED    ]: mapIndex = %u, startTick = %u, tickDelay = %u ms\n",
            mapIndex, startTick, tickDelayMs);
+
+    // Playing the first shot in bot mode
+    botGameStarted(terminalFileDescriptor);
     return 0;
 }
 
@@ -207,20 +323,45 @@ int readGameFinishedMessage(int terminalFileDescriptor) {
 
     // Reading shotsTotal
     bytes[0] = readByteFromTerminal(terminalFileDescriptor, timeout);
-    if(bytes[0] != READ_ERROR && bytes[0] != READ_TIMEOUT) {
-        shotsTotal = bytes[0];
+    bytes[1] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    if(bytes[0] != READ_ERROR && bytes[0] != READ_TIMEOUT &&
+       bytes[1] != READ_ERROR && bytes[1] != READ_TIMEOUT)
+    {
+        shotsTotal = bytes[0] | bytes[1] << 8;
+    }
+    else return -1;
+
+    // Reading tickOverruns
+    bytes[0] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    bytes[1] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    if(bytes[0] != READ_ERROR && bytes[0] != READ_TIMEOUT &&
+       bytes[1] != READ_ERROR && bytes[1] != READ_TIMEOUT)
+    {
+        tickOverruns = bytes[0] | bytes[1] << 8;
+    }
+    else return -1;
+
+    // Reading maxTickLatenessMs
+    bytes[0] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    bytes[1] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    if(bytes[0] != READ_ERROR && bytes[0] != READ_TIMEOUT &&
+       bytes[1] != READ_ERROR && bytes[1] != READ_TIMEOUT)
+    {
+        maxTickLatenessMs = bytes[0] | bytes[1] << 8;
     }
     else return -1;
 
     // Printing message information
-    printf("[GAME_FINISHED   ]: stopTick = %u, shotsTotal = %u\n\n",
-           stopTick, shotsTotal);
+    printf("[GAME_FINISHED   ]: stopTick = %u, shotsTotal = %u, tickOverruns = %u, maxTickLateness = %u ms\n\n",
+           stopTick, shotsTotal, tickOverruns, maxTickLatenessMs);
 
-    // Calculating statistics
+    // Calculating statistics, the game ticks are scheduled at fixed
+    // intervals on the EFM32GG, so ticks times the tick period of
+    // each interval is real time
     unsigned hitsTotal = shotsTotal - missTotal;
     double hitRate = 100.0f * hitsTotal / shotsTotal;
-    double averageHitTime = ((double)sumHitTimes / hitsTotal) * tickDelayMs / 1000.0f;
-    double gameTime = ((double)stopTick - startTick) / 1000.0f * tickDelayMs;
+    double averageHitTime = (sumHitTimes / hitsTotal) / 1000.0f;
+    double gameTime = gameTickToMs(stopTick) / 1000.0f;
 
     // Printing statistics
     printf("STATISTICS:                    \n"
@@ -230,15 +371,27 @@ int readGameFinishedMessage(int terminalFileDescriptor) {
            "Misses total:    %u            \n"
            "Hitrate:         %.2lf%%       \n"
            "Average hittime: %.2lf seconds \n"
-           "Game time:       %.2lf seconds \n\n\n",
+           "Game time:       %.2lf seconds \n"
+           "Tick overruns:   %u            \n"
+           "Max lateness:    %u ms         \n"
+           "Sleep time:      %.2lf of %.2lf seconds idle\n"
+           "Messages lost:   %u            \n\n\n",
            shotsTotal,
            hitsTotal,
            missTotal,
            hitRate,
            averageHitTime,
-           gameTime
+           gameTime,
+           tickOverruns,
+           maxTickLatenessMs,
+           actualIdleMs / 1000.0f,
+           expectedIdleMs / 1000.0f,
+           lostTotal
     );
 
+    // Reporting the game rate in bot mode
+    botGameFinished();
+
     return 0;
 }
 
@@ -298,6 +451,9 @@ int readSegmentMessage(int terminalFileDescriptor, MessageType type) {
         // Printing message information
         // printf("[SEGMENT_SELECTED]: segmentID = %u, gameTick = %u\n",
         //        segmentID, gameTick);
+
+        // Following the cursor in bot mode
+        botSegmentSelected(segmentID);
         break;
 
     case SegmentFiredMsg:
@@ -305,6 +461,9 @@ int readSegmentMessage(int terminalFileDescriptor, MessageType type) {
         // Printing message information
         printf("[SEGMENT_FIRED   ]: segmentID = %u, gameTick = %u\n",
                segmentID, gameTick);
+
+        // Following the cursor in bot mode
+        botSegmentSelected(segmentID);
         break;
 
     case SegmentHitMsg:
@@ -313,9 +472,16 @@ int readSegmentMessage(int terminalFileDescriptor, MessageType type) {
         printf("[SEGMENT_HIT     ]: segmentID = %u, gameTick = %u\n",
                segmentID, gameTick);
 
-        // Updating last hit tick
-        sumHitTimes += (gameTick - lastHitTick);
-        lastHitTick = gameTick;
+        // Updating last hit time
+        sumHitTimes += gameTickToMs(gameTick) - lastHitMs;
+        lastHitMs = gameTickToMs(gameTick);
+
+        // Keeping the maps with a ship on the segment
+        narrowCandidateMaps(segmentID, true);
+        printCandidateMaps();
+
+        // Playing the next shot in bot mode
+        botShotResult(terminalFileDescriptor, segmentID);
 
         break;
 
@@ -328,16 +494,512 @@ int readSegmentMessage(int terminalFileDescriptor, MessageType type) {
         // Increasing total number of misses
         missTotal++;
 
+        // Keeping the maps without a ship on the segment
+        narrowCandidateMaps(segmentID, false);
+        printCandidateMaps();
+
+        // Playing the next shot in bot mode
+        botShotResult(terminalFileDescriptor, segmentID);
+
         break;
 
     case GameStartedMsg:    // [[fallthrough]]
     case GameFinishedMsg:   // [[fallthrough]]
+    case TaskStatsMsg:      // [[fallthrough]]
+    case TraceDumpMsg:      // [[fallthrough]]
+    case TickPeriodMsg:     // [[fallthrough]]
+    case BaudrateAckMsg:    // [[fallthrough]]
+    case EchoMsg:           // [[fallthrough]]
+    case IdleStatsMsg:      // [[fallthrough]]
+    case BacklogMsg:        // [[fallthrough]]
+    case HistoryMsg:        // [[fallthrough]]
     default: break;
     };
 
     return 0;
 }
 
+/**
+ * @brief   Reads one task statistics message from the terminal.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readTaskStatsMessage(int terminalFileDescriptor) {
+
+    // Timeout between bytes of one message is 1ms
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 1000;
+
+    // The statistics of the task
+    TaskStatsMessage stats;
+    memset(&stats, 0, sizeof(stats));
+
+    // Buffer for reading bytes from the terminal
+    int bytes[2] = {0};
+
+    // Reading taskName
+    for(int i = 0; i < TASK_STATS_NAME_LENGTH; i++) {
+        bytes[0] = readByteFromTerminal(terminalFileDescriptor, timeout);
+        if(bytes[0] == READ_ERROR || bytes[0] == READ_TIMEOUT) return -1;
+        stats.taskName[i] = bytes[0];
+    }
+
+    // Reading cpuShare
+    bytes[0] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    bytes[1] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    if(bytes[0] != READ_ERROR && bytes[0] != READ_TIMEOUT &&
+       bytes[1] != READ_ERROR && bytes[1] != READ_TIMEOUT)
+    {
+        stats.cpuShare = bytes[0] | bytes[1] << 8;
+    }
+    else return -1;
+
+    // Reading stackHighWater
+    bytes[0] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    bytes[1] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    if(bytes[0] != READ_ERROR && bytes[0] != READ_TIMEOUT &&
+       bytes[1] != READ_ERROR && bytes[1] != READ_TIMEOUT)
+    {
+        stats.stackHighWater = bytes[0] | bytes[1] << 8;
+    }
+    else return -1;
+
+    // Printing message information
+    printf("[TASK_STATS      ]: task = %-*.*s, cpu = %5.1lf%%, stackFree = %u words\n",
+           TASK_STATS_NAME_LENGTH, TASK_STATS_NAME_LENGTH, stats.taskName,
+           stats.cpuShare / 10.0, stats.stackHighWater);
+    return 0;
+}
+
+/**
+ * @brief   Reads one event trace dump from the terminal, and writes it
+ *          as Chrome trace JSON to a new file in the working directory.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readTraceDumpMessage(int terminalFileDescriptor) {
+
+    // Timeout between bytes of one message is 1ms
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 1000;
+
+    // The trace dump
+    TraceDump dump;
+    memset(&dump, 0, sizeof(dump));
+
+    // Buffer for reading bytes from the terminal
+    int bytes[4] = {0};
+
+    // Reading bytes of clockHz
+    for(int i = 0; i < 4; i++) {
+        bytes[i] = readByteFromTerminal(terminalFileDescriptor, timeout);
+        if(bytes[i] == READ_ERROR || bytes[i] == READ_TIMEOUT) return -1;
+        dump.clockHz |= (uint32_t)bytes[i] << (8 * i);
+    }
+
+    // Reading taskCount
+    bytes[0] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    if(bytes[0] == READ_ERROR || bytes[0] == READ_TIMEOUT || bytes[0] > TRACE_MAX_TASKS) return -1;
+    dump.taskCount = bytes[0];
+
+    // Reading the task list
+    for(int i = 0; i < dump.taskCount; i++) {
+        for(int j = 0; j < 1 + TRACE_TASK_NAME_LENGTH; j++) {
+            bytes[0] = readByteFromTerminal(terminalFileDescriptor, timeout);
+            if(bytes[0] == READ_ERROR || bytes[0] == READ_TIMEOUT) return -1;
+
+            if(j == 0) dump.tasks[i].number = bytes[0];
+            else       dump.tasks[i].name[j - 1] = bytes[0];
+        }
+    }
+
+    // Reading eventCount
+    bytes[0] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    bytes[1] = readByteFromTerminal(terminalFileDescriptor, timeout);
+    if(bytes[0] != READ_ERROR && bytes[0] != READ_TIMEOUT &&
+       bytes[1] != READ_ERROR && bytes[1] != READ_TIMEOUT)
+    {
+        dump.eventCount = bytes[0] | bytes[1] << 8;
+    }
+    else return -1;
+
+    // Allocating the events
+    dump.events = calloc(dump.eventCount + 1, sizeof(TraceEvent));
+    if(dump.events == NULL) {
+        perror("Cannot allocate the event trace");
+        return -1;
+    }
+
+    // Reading the events
+    for(int i = 0; i < dump.eventCount; i++) {
+        int eventBytes[7];
+        for(int j = 0; j < 7; j++) {
+            eventBytes[j] = readByteFromTerminal(terminalFileDescriptor, timeout);
+            if(eventBytes[j] == READ_ERROR || eventBytes[j] == READ_TIMEOUT) {
+                free(dump.events);
+                return -1;
+            }
+        }
+
+        dump.events[i].timestamp = (uint32_t)eventBytes[0]       | (uint32_t)eventBytes[1] << 8 |
+                                   (uint32_t)eventBytes[2] << 16 | (uint32_t)eventBytes[3] << 24;
+        dump.events[i].event     = eventBytes[4];
+        dump.events[i].argument  = eventBytes[5] | eventBytes[6] << 8;
+    }
+
+    // Writing the trace to a new file
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "torpedo_trace_%ld.json", (long)time(NULL));
+
+    int status = -1;
+    FILE *file = fopen(fileName, "w");
+    if(file == NULL) {
+        perror("Cannot create the trace file");
+    } else {
+        status = writeChromeTrace(file, &dump);
+        fclose(file);
+    }
+
+    // Printing message information
+    if(status == 0) {
+        printf("[TRACE_DUMP      ]: %u events written to %s\n", dump.eventCount, fileName);
+    }
+
+    free(dump.events);
+
+    // A failed export does not corrupt the message stream
+    return 0;
+}
+
+/**
+ * @brief   Reads one tick period message from the terminal.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readTickPeriodMessage(int terminalFileDescriptor) {
+
+    // Timeout between bytes of one message is 1ms
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 1000;
+
+    // The value of the tick counter at the period change
+    uint32_t gameTick = 0;
+
+    // Buffer for reading bytes from the terminal
+    int bytes[5] = {0};
+
+    // Reading bytes of gameTick and tickDelayMs
+    for(int i = 0; i < 5; i++) {
+        bytes[i] = readByteFromTerminal(terminalFileDescriptor, timeout);
+        if(bytes[i] == READ_ERROR || bytes[i] == READ_TIMEOUT) return -1;
+    }
+
+    gameTick = bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+
+    // Closing the interval of the previous tick period
+    periodStartMs = gameTickToMs(gameTick);
+    periodStartTick = gameTick;
+    tickDelayMs = bytes[4];
+
+    // Printing message information
+    printf("[TICK_PERIOD     ]: gameTick = %u, tickDelay = %u ms\n",
+           gameTick, tickDelayMs);
+
+    return 0;
+}
+
+/**
+ * @brief   Reads one baud-rate acknowledge message from the terminal.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readBaudrateAckMessage(int terminalFileDescriptor) {
+
+    // Timeout between bytes of one message is 1ms
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 1000;
+
+    // Buffer for reading bytes from the terminal
+    int bytes[5] = {0};
+
+    // Reading bytes of baudrate and accepted
+    for(int i = 0; i < 5; i++) {
+        bytes[i] = readByteFromTerminal(terminalFileDescriptor, timeout);
+        if(bytes[i] == READ_ERROR || bytes[i] == READ_TIMEOUT) return -1;
+    }
+
+    // Passing the answer to the negotiation in the control task
+    notifyBaudrateAck(bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t)bytes[3] << 24, bytes[4]);
+
+    return 0;
+}
+
+/**
+ * @brief   Reads one echo message from the terminal.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readEchoMessage(int terminalFileDescriptor) {
+
+    // Timeout between bytes of one message is 1ms
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 1000;
+
+    // Reading the echoed value
+    int value = readByteFromTerminal(terminalFileDescriptor, timeout);
+    if(value == READ_ERROR || value == READ_TIMEOUT) return -1;
+
+    // Passing the answer to the negotiation in the control task
+    notifyEcho(value);
+
+    return 0;
+}
+
+/**
+ * @brief   Reads one idle statistics message from the terminal.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readIdleStatsMessage(int terminalFileDescriptor) {
+
+    // Timeout between bytes of one message is 1ms
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 1000;
+
+    // Buffer for reading bytes from the terminal
+    int bytes[12] = {0};
+
+    // Reading bytes of sleepCount, expectedIdleMs and actualIdleMs
+    for(int i = 0; i < 12; i++) {
+        bytes[i] = readByteFromTerminal(terminalFileDescriptor, timeout);
+        if(bytes[i] == READ_ERROR || bytes[i] == READ_TIMEOUT) return -1;
+    }
+
+    sleepCount     = bytes[0] | bytes[1] << 8 | bytes[2]  << 16 | (uint32_t)bytes[3]  << 24;
+    expectedIdleMs = bytes[4] | bytes[5] << 8 | bytes[6]  << 16 | (uint32_t)bytes[7]  << 24;
+    actualIdleMs   = bytes[8] | bytes[9] << 8 | bytes[10] << 16 | (uint32_t)bytes[11] << 24;
+
+    // Printing message information
+    printf("[IDLE_STATS      ]: sleeps = %u, expectedIdle = %u ms, actualIdle = %u ms\n",
+           sleepCount, expectedIdleMs, actualIdleMs);
+
+    return 0;
+}
+
+/**
+ * @brief Finishes the replay of the stored messages, and releases
+ *        the game control task waiting for it.
+ */
+static void finishBacklog(void) {
+
+    backlogReplaying = 0;
+    printf("[BACKLOG         ]: replay finished\n\n");
+
+    notifyBacklogFlushed();
+}
+
+/**
+ * @brief   Reads one backlog message from the terminal, and replays the
+ *          stored messages following it.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readBacklogMessage(int terminalFileDescriptor) {
+
+    // Timeout between bytes of one message is 1ms
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 1000;
+
+    // Buffer for reading bytes from the terminal
+    int bytes[6] = {0};
+
+    // Reading bytes of messageCount and uptimeMs
+    for(int i = 0; i < 6; i++) {
+        bytes[i] = readByteFromTerminal(terminalFileDescriptor, timeout);
+        if(bytes[i] == READ_ERROR || bytes[i] == READ_TIMEOUT) return -1;
+    }
+
+    BacklogMessage backlog;
+    backlog.messageCount = bytes[0] | bytes[1] << 8;
+    backlog.uptimeMs     = bytes[2] | bytes[3] << 8 | bytes[4] << 16 | (uint32_t)bytes[5] << 24;
+
+    // Printing message information
+    printf("[BACKLOG         ]: messages = %u, uptime = %.1lf s\n",
+           backlog.messageCount, backlog.uptimeMs / 1000.0);
+
+    // The EFM32GG sends a backlog message on every attach, also after a reset. Its uptime
+    // grows with the time the host was away, unless it was reset. The sequence numbers
+    // restart then, and the count is resynchronized instead of accounting lost messages.
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if(backlogReceived) {
+        double awayMs = (now.tv_sec - backlogTime.tv_sec) * 1000.0 +
+                        (now.tv_nsec - backlogTime.tv_nsec) / 1000000.0;
+
+        // Tolerating an EFM32GG clock running at half speed
+        if(backlog.uptimeMs < backlogUptimeMs + awayMs / 2) {
+            printf("[MESSAGES_RESYNC ]: the EFM32GG was reset, uptime = %.1lf s, expected = %.1lf s\n",
+                   backlog.uptimeMs / 1000.0, (backlogUptimeMs + awayMs) / 1000.0);
+            sequenceReceived = 0;
+        }
+    }
+
+    backlogReceived = 1;
+    backlogUptimeMs = backlog.uptimeMs;
+    backlogTime = now;
+
+    // The stored messages follow in order, the autoplayer only
+    // follows them, and resumes the running game after the replay
+    backlogRemaining = backlog.messageCount;
+    backlogReplaying = 1;
+    if(backlogRemaining == 0) finishBacklog();
+
+    return 0;
+}
+
+/**
+ * @brief   Reads a little-endian field of a message from the terminal.
+ * @param   [in] The file descriptor of the terminal.
+ * @param   [in] The timeout between the bytes.
+ * @param   [in] The length of the field in bytes, at most 4.
+ * @param   [out] The value of the field.
+ * @returns Zero on success, -1 on failure.
+ */
+static int readField(int terminalFileDescriptor, struct timeval timeout, int length, uint32_t *value) {
+
+    *value = 0;
+
+    for(int i = 0; i < length; i++) {
+        int byte = readByteFromTerminal(terminalFileDescriptor, timeout);
+        if(byte == READ_ERROR || byte == READ_TIMEOUT) return -1;
+        *value |= (uint32_t)byte << (8 * i);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Reads the game history stored in the flash of the EFM32GG,
+ *          writes the games as CSV to a new file in the working
+ *          directory, and prints the totals of every map.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readHistoryMessage(int terminalFileDescriptor) {
+
+    // Timeout between bytes of one message is 1ms
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 1000;
+
+    uint32_t pageSequence, mapCount, recordCount;
+
+    // Reading the sequence number of the active page, and the number of maps
+    if(readField(terminalFileDescriptor, timeout, 4, &pageSequence) == -1) return -1;
+    if(readField(terminalFileDescriptor, timeout, 1, &mapCount) == -1 || mapCount > PREDEFINED_MAP_COUNT) return -1;
+
+    // Reading the totals of the games no longer stored one by one
+    HistoryTotals totals[PREDEFINED_MAP_COUNT];
+    memset(totals, 0, sizeof(totals));
+
+    for(uint32_t i = 0; i < mapCount; i++) {
+        if(readField(terminalFileDescriptor, timeout, 4, &totals[i].games) == -1 ||
+           readField(terminalFileDescriptor, timeout, 4, &totals[i].gameTicks) == -1 ||
+           readField(terminalFileDescriptor, timeout, 4, &totals[i].shotsTotal) == -1 ||
+           readField(terminalFileDescriptor, timeout, 4, &totals[i].shotsMissed) == -1) return -1;
+    }
+
+    // Reading the stored games
+    if(readField(terminalFileDescriptor, timeout, 2, &recordCount) == -1) return -1;
+
+    HistoryRecord *records = calloc(recordCount + 1, sizeof(HistoryRecord));
+    if(records == NULL) {
+        perror("Cannot allocate the game history");
+        return -1;
+    }
+
+    for(uint32_t i = 0; i < recordCount; i++) {
+        uint32_t mapIndex, gameTicks, shotsTotal, shotsMissed;
+
+        if(readField(terminalFileDescriptor, timeout, 1, &mapIndex) == -1 ||
+           readField(terminalFileDescriptor, timeout, 4, &gameTicks) == -1 ||
+           readField(terminalFileDescriptor, timeout, 2, &shotsTotal) == -1 ||
+           readField(terminalFileDescriptor, timeout, 2, &shotsMissed) == -1)
+        {
+            free(records);
+            return -1;
+        }
+
+        records[i] = (HistoryRecord){mapIndex, gameTicks, shotsTotal, shotsMissed};
+    }
+
+    // Writing the stored games to a new file
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "torpedo_history_%ld.csv", (long)time(NULL));
+
+    FILE *file = fopen(fileName, "w");
+    if(file == NULL) {
+        perror("Cannot create the history file");
+    } else {
+        fprintf(file, "game,map,ticks,shots,misses\n");
+    }
+
+    // Adding the stored games to the totals, the lost ones are skipped
+    uint32_t archivedGames = 0, lostGames = 0;
+    for(uint32_t map = 0; map < PREDEFINED_MAP_COUNT; map++) archivedGames += totals[map].games;
+
+    for(uint32_t i = 0; i < recordCount; i++) {
+        if(records[i].mapIndex >= PREDEFINED_MAP_COUNT) {
+            lostGames++;
+            continue;
+        }
+
+        HistoryTotals *mapTotals = &totals[records[i].mapIndex];
+        mapTotals->games++;
+        mapTotals->gameTicks   += records[i].gameTicks;
+        mapTotals->shotsTotal  += records[i].shotsTotal;
+        mapTotals->shotsMissed += records[i].shotsMissed;
+
+        if(file != NULL) {
+            fprintf(file, "%u,%u,%u,%u,%u\n", i, records[i].mapIndex, records[i].gameTicks,
+                    records[i].shotsTotal, records[i].shotsMissed);
+        }
+    }
+
+    if(file != NULL) fclose(file);
+
+    // Printing message information
+    printf("[HISTORY         ]: stored games = %u, lost = %u, archived games = %u, pages activated = %u\n",
+           recordCount - lostGames, lostGames, archivedGames, pageSequence);
+
+    for(uint32_t map = 0; map < PREDEFINED_MAP_COUNT; map++) {
+        if(totals[map].games == 0) continue;
+
+        printf("[HISTORY         ]: map = %2u, games = %5u, ticks = %8.1lf avg, shots = %5.2lf avg, misses = %5.2lf avg\n",
+               map, totals[map].games,
+               (double)totals[map].gameTicks / totals[map].games,
+               (double)totals[map].shotsTotal / totals[map].games,
+               (double)totals[map].shotsMissed / totals[map].games);
+    }
+
+    if(file != NULL) {
+        printf("[HISTORY         ]: %u stored games written to %s\n\n", recordCount - lostGames, fileName);
+    }
+
+    free(records);
+
+    // A failed export does not corrupt the message stream
+    return 0;
+}
+
 /**
  * @brief 	Task function that receives messages from the EFM32GG,
  * 			displays them on STDOUT and logs statistics.
@@ -365,8 +1027,8 @@ void* statisticsTaskFunction(void *args) {
     // by the game control thread
     int terminalFileDescriptor;
 
-    // Opening terminal
-    terminalFileDescriptor = open("/dev/ttyACM0", O_RDONLY);
+    // Opening terminal, the bot also writes its inputs to it
+    terminalFileDescriptor = open(params->portName, botEnabled ? O_RDWR : O_RDONLY);
     if(terminalFileDescriptor == -1) {
         perror("Cannot open terminal");
         return NULL;
@@ -386,37 +1048,93 @@ void* statisticsTaskFunction(void *args) {
         // Reading message identifier
         int messageID = readByteFromTerminal(terminalFileDescriptor, timeout);
 
-        // Checking timeout and errors on read
-        if(messageID == READ_TIMEOUT) continue;
+        // Checking timeout and errors on read, the bot retries lost shots
+        if(messageID == READ_TIMEOUT) {
+            botIdle(terminalFileDescriptor);
+            continue;
+        }
         if(messageID == READ_ERROR) break;
 
-        // Differentiating based on messageID
-        switch(messageID) {
-        case GameStartedMsg:
-            status = readGameStartedMessage(terminalFileDescriptor);
-            break;
+        // Reading the sequence number of the queued messages
+        if(messageID != TraceDumpMsg && messageID != BacklogMsg && messageID != HistoryMsg) {
+            status = readMessageSequence(terminalFileDescriptor);
+        }
 
-        case GameFinishedMsg:
-            status = readGameFinishedMessage(terminalFileDescriptor);
-            break;
+        if(status == 0) {
 
-        case SegmentSelectedMsg:
-            status = readSegmentMessage(terminalFileDescriptor, SegmentSelectedMsg);
-            break;
+            // Differentiating based on messageID
+            switch(messageID) {
+            case GameStartedMsg:
+                status = readGameStartedMessage(terminalFileDescriptor);
+                break;
 
-        case SegmentFiredMsg:
-            status = readSegmentMessage(terminalFileDescriptor, SegmentFiredMsg);
-            break;
+            case GameFinishedMsg:
+                status = readGameFinishedMessage(terminalFileDescriptor);
+                break;
 
-        case SegmentHitMsg:
-            status = readSegmentMessage(terminalFileDescriptor, SegmentHitMsg);
-            break;
+            case SegmentSelectedMsg:
+                status = readSegmentMessage(terminalFileDescriptor, SegmentSelectedMsg);
+                break;
 
-        case SegmentMissedMsg:
-            status = readSegmentMessage(terminalFileDescriptor, SegmentMissedMsg);
-            break;
+            case SegmentFiredMsg:
+                status = readSegmentMessage(terminalFileDescriptor, SegmentFiredMsg);
+                break;
+
+            case SegmentHitMsg:
+                status = readSegmentMessage(terminalFileDescriptor, SegmentHitMsg);
+                break;
+
+            case SegmentMissedMsg:
+                status = readSegmentMessage(terminalFileDescriptor, SegmentMissedMsg);
+                break;
+
+            case TaskStatsMsg:
+                status = readTaskStatsMessage(terminalFileDescriptor);
+                break;
+
+            case TraceDumpMsg:
+                status = readTraceDumpMessage(terminalFileDescriptor);
+                break;
+
+            case TickPeriodMsg:
+                status = readTickPeriodMessage(terminalFileDescriptor);
+                break;
+
+            case BaudrateAckMsg:
+                status = readBaudrateAckMessage(terminalFileDescriptor);
+                break;
+
+            case EchoMsg:
+                status = readEchoMessage(terminalFileDescriptor);
+                break;
+
+            case IdleStatsMsg:
+                status = readIdleStatsMessage(terminalFileDescriptor);
+                break;
+
+            case BacklogMsg:
+                status = readBacklogMessage(terminalFileDescriptor);
+                break;
+
+            case HistoryMsg:
+                status = readHistoryMessage(terminalFileDescriptor);
+                break;
+
+            default: status = -1; break;
+            }
+        }
+
+        // Counting down the replayed messages, which carry sequence numbers
+        if(status == 0 && backlogRemaining > 0 && messageID != TraceDumpMsg && messageID != BacklogMsg &&
+           messageID != HistoryMsg) {
+            if(--backlogRemaining == 0) finishBacklog();
+        }
 
-        default: status = -1; break;
+        // Skipping garbage received while the baud-rate is switched,
+        // the sequence numbers are resynchronized by the next message
+        if(status == -1 && linkNegotiating) {
+            sequenceReceived = 0;
+            continue;
         }
 
         // Checking message read error status
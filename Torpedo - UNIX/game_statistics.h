@@ -50,6 +50,17 @@
 #define READ_TIMEOUT    (-2)
 
 
+/**
+ * @brief Defines the number of task name characters in a task statistics message.
+ */
+#define TASK_STATS_NAME_LENGTH  (8)
+
+/**
+ * @brief Defines the map index of the records sent as lost in a history message.
+ */
+#define HISTORY_LOST_RECORD     (0xFF)
+
+
 /**
  * @brief Describes the possible message types.
  */
@@ -59,7 +70,15 @@ typedef enum MessageType {
     SegmentSelectedMsg,
     SegmentFiredMsg,
     SegmentHitMsg,
-    SegmentMissedMsg
+    SegmentMissedMsg,
+    TaskStatsMsg,
+    TraceDumpMsg,
+    TickPeriodMsg,
+    BaudrateAckMsg,
+    EchoMsg,
+    IdleStatsMsg,
+    BacklogMsg,
+    HistoryMsg
 } MessageType;
 
 /**
@@ -76,7 +95,9 @@ typedef struct GameStartedMessage {
  */
 typedef struct GameFinishedMessage {
     uint32_t stopTick;		/**< The value of the game tick counter when the game finished.	*/
-    uint8_t  shotsTotal;	/**< The total number of shots fired when the game finished.	*/
+    uint16_t shotsTotal;	/**< The total number of shots fired when the game finished.	*/
+    uint16_t tickOverruns;      /**< The number of game ticks that overran the tick period.     */
+    uint16_t maxTickLatenessMs; /**< The largest delay of a game tick start in milliseconds.    */
 } GameFinishedMessage;
 
 /**
@@ -111,6 +132,77 @@ typedef struct SegmentMissedMessage {
     uint8_t  segmentID;		/**< The ID of the segment missed. 										*/
 } SegmentMissedMessage;
 
+/**
+ * @brief Describes the message sent periodically about each task in the runtime-stats build.
+ */
+typedef struct TaskStatsMessage {
+    char     taskName[TASK_STATS_NAME_LENGTH];  /**< The name of the task, zero padded.                                 */
+    uint16_t cpuShare;                          /**< The share of the CPU used by the task in the last period, in 0.1%. */
+    uint16_t stackHighWater;                    /**< The minimum free stack space of the task so far, in words.         */
+} TaskStatsMessage;
+
+/**
+ * @brief Describes the message sent when the game loop applies a new tick period.
+ */
+typedef struct TickPeriodMessage {
+    uint32_t gameTick;      /**< The value of the game tick counter when the period changed.   */
+    uint8_t  tickDelayMs;   /**< The new time delay between game ticks in milliseconds.         */
+} TickPeriodMessage;
+
+/**
+ * @brief Describes the answer to a proposed baud-rate.
+ */
+typedef struct BaudrateAckMessage {
+    uint32_t baudrate;      /**< The proposed baud-rate.                                */
+    uint8_t  accepted;      /**< Nonzero if the EFM32GG switches to the proposed rate.  */
+} BaudrateAckMessage;
+
+/**
+ * @brief Describes the answer to an echo command.
+ */
+typedef struct EchoMessage {
+    uint8_t  value;         /**< The value received in the echo command.    */
+} EchoMessage;
+
+/**
+ * @brief Describes the sleep report of the tickless idle, sent before the game-finished message.
+ */
+typedef struct IdleStatsMessage {
+    uint32_t sleepCount;        /**< The number of sleeps during the game.                          */
+    uint32_t expectedIdleMs;    /**< The sum of the idle times expected by the kernel in milliseconds. */
+    uint32_t actualIdleMs;      /**< The sum of the time actually slept in milliseconds.             */
+} IdleStatsMessage;
+
+/**
+ * @brief Describes the message preceding the messages stored by the EFM32GG
+ *        while the host was detached. It has no sequence number.
+ */
+typedef struct BacklogMessage {
+    uint16_t messageCount;  /**< The number of stored messages following.           */
+    uint32_t uptimeMs;      /**< The time since the EFM32GG started in milliseconds. */
+} BacklogMessage;
+
+/**
+ * @brief Describes the totals of the games played on a map, sent in the
+ *        history message for the games no longer stored one by one.
+ */
+typedef struct HistoryTotals {
+    uint32_t games;         /**< The number of games.                       */
+    uint32_t gameTicks;     /**< The sum of the game ticks of the games.    */
+    uint32_t shotsTotal;    /**< The sum of the shots fired.                */
+    uint32_t shotsMissed;   /**< The sum of the shots that missed.          */
+} HistoryTotals;
+
+/**
+ * @brief Describes one game summary stored in the flash of the EFM32GG.
+ */
+typedef struct HistoryRecord {
+    uint8_t  mapIndex;      /**< The index of the map, or HISTORY_LOST_RECORD.  */
+    uint32_t gameTicks;     /**< The number of game ticks the game lasted.      */
+    uint16_t shotsTotal;    /**< The number of shots fired.                     */
+    uint16_t shotsMissed;   /**< The number of shots that missed.               */
+} HistoryRecord;
+
 /**
  * @brief This structure is used to pass multiple parameters to
  *        the game statistics task.
@@ -118,6 +210,7 @@ typedef struct SegmentMissedMessage {
 struct statisticsParams {
     sem_t        *statisticsReleased;   /**< Mutex releasing the statistics task to proceed.        */
     volatile int *stopFlag;             /**< Flag indicating that the statistics task should stop.  */
+    const char   *portName;             /**< The name of the terminal port.                         */
 };
 
 
@@ -129,6 +222,14 @@ struct statisticsParams {
  */
 int readByteFromTerminal(int terminalFileDescriptor, struct timeval timeout);
 
+/**
+ * @brief   Reads the sequence number following the message identifier
+ *          and accounts the messages lost since the previous one.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readMessageSequence(int terminalFileDescriptor);
+
 /**
  * @brief   Reads one game-started message from the terminal.
  * @param   The file descriptor of the terminal.
@@ -151,6 +252,66 @@ int readGameFinishedMessage(int terminalFileDescriptor);
  */
 int readSegmentMessage(int terminalFileDescriptor, MessageType type);
 
+/**
+ * @brief   Reads one task statistics message from the terminal.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readTaskStatsMessage(int terminalFileDescriptor);
+
+/**
+ * @brief   Reads one event trace dump from the terminal, and writes it
+ *          as Chrome trace JSON to a new file in the working directory.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readTraceDumpMessage(int terminalFileDescriptor);
+
+/**
+ * @brief   Reads one tick period message from the terminal.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readTickPeriodMessage(int terminalFileDescriptor);
+
+/**
+ * @brief   Reads one baud-rate acknowledge message from the terminal.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readBaudrateAckMessage(int terminalFileDescriptor);
+
+/**
+ * @brief   Reads one echo message from the terminal.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readEchoMessage(int terminalFileDescriptor);
+
+/**
+ * @brief   Reads one idle statistics message from the terminal.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readIdleStatsMessage(int terminalFileDescriptor);
+
+/**
+ * @brief   Reads one backlog message from the terminal, and replays the
+ *          stored messages following it.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readBacklogMessage(int terminalFileDescriptor);
+
+/**
+ * @brief   Reads the game history stored in the flash of the EFM32GG,
+ *          writes the games as CSV to a new file in the working
+ *          directory, and prints the totals of every map.
+ * @param   The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int readHistoryMessage(int terminalFileDescriptor);
+
 /**
  * @brief 	Task function that receives messages from the EFM32GG,
  * 			displays them on STDOUT and logs statistics.
@@ -41,6 +41,8 @@
 #include "command_args.h"
 #include "game_control.h"
 #include "game_statistics.h"
+#include "map_index.h"
+#include "bot.h"
 
 
 /**
@@ -62,9 +64,10 @@ int main(int argc, char *argv[])
     // Command line parameters
     uint32_t speed = 0;
     char portName[PORTNAME_MAX_LENGTH + 1] = "";
+    uint8_t tickPeriodMs = 0;
 
     // Parsing command line
-    parseCommandLine(argc, argv, &speed, portName);
+    parseCommandLine(argc, argv, &speed, portName, &tickPeriodMs, &botEnabled);
 
     // Checking speed configuration
     if(speed == 0) exit(EXIT_FAILURE);
@@ -72,6 +75,9 @@ int main(int argc, char *argv[])
     // Checking port name configuration
     if(strlen(portName) == 0) exit(EXIT_FAILURE);
 
+    // Indexing the predefined maps for the map identification
+    initMapIndex();
+
     // Status variable for checking return values
     int status;
 
@@ -96,6 +102,7 @@ int main(int argc, char *argv[])
     cParams.statisticsReleased = &statisticsReleased;
     cParams.speed = speed;
     cParams.portName = portName;
+    cParams.tickPeriodMs = tickPeriodMs;
 
     // Creating the control task
     status = pthread_create(&controlTask, NULL, controlTaskFunction, (void*) &cParams);
@@ -110,6 +117,7 @@ int main(int argc, char *argv[])
     struct statisticsParams sParams;
     sParams.statisticsReleased = &statisticsReleased;
     sParams.stopFlag = &stopFlag;
+    sParams.portName = portName;
 
     // Creating the statistics task
     status = pthread_create(&statisticsTask, NULL, statisticsTaskFunction, (void*) &sParams);
@@ -0,0 +1,103 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    map_index.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Identification of the map of the running game from its shots.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdio.h>
+#include <string.h>
+
+// Project includes
+#include "map_index.h"
+
+
+/**
+ * @brief The bitset of the maps agreeing with every hit and miss of
+ *        the running game.
+ */
+uint16_t candidateMaps = ALL_CANDIDATE_MAPS;
+
+/**
+ * @brief The segments hit in the running game, and their number.
+ */
+SegmentMap hitSegments = {0};
+uint8_t hitCount = 0;
+
+/**
+ * @brief Builds the inverted index of the predefined maps, must be
+ *        called before the first game.
+ */
+void initMapIndex(void) {
+
+    // Indexing the maps and forgetting the solved candidate sets
+    initMapSolver();
+
+    resetCandidateMaps();
+}
+
+/**
+ * @brief Marks every map as candidate for a new game.
+ */
+void resetCandidateMaps(void) {
+    candidateMaps = ALL_CANDIDATE_MAPS;
+    memset(hitSegments, 0, sizeof(hitSegments));
+    hitCount = 0;
+}
+
+/**
+ * @brief   Returns the expected number of shots left in the running game
+ *          under optimal play.
+ * @returns The number of shots, or -1 if no map agrees with the shots
+ *          (e.g. a message was lost).
+ */
+double expectedRemainingShots(void) {
+
+    if(candidateMaps == 0) return -1;
+
+    return SHIP_SEGMENTS_COUNT - hitCount + expectedMisses(candidateMaps);
+}
+
+/**
+ * @brief Prints the candidate maps and the expected remaining shots.
+ */
+void printCandidateMaps(void) {
+
+    if(candidateMaps == 0) {
+        printf("[CANDIDATE_MAPS  ]: none, the shots match no map\n");
+        return;
+    }
+
+    // Listing the candidate map indices
+    printf("[CANDIDATE_MAPS  ]: maps =");
+    for(uint8_t map = 0; map < PREDEFINED_MAP_COUNT; map++) {
+        if(candidateMaps & (1U << map)) printf(" %u", map);
+    }
+    printf(", expected remaining shots = %.2lf\n", expectedRemainingShots());
+}
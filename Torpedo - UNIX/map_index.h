@@ -0,0 +1,102 @@
+#pragma once
+#ifndef MAP_INDEX_H
+#define MAP_INDEX_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    map_index.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Identification of the map of the running game from its shots.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// Project includes
+#include "game_core.h"
+#include "map_solver.h"
+
+
+/**
+ * @brief The bitset of the maps agreeing with every hit and miss of
+ *        the running game.
+ */
+extern uint16_t candidateMaps;
+
+/**
+ * @brief The segments hit in the running game, and their number.
+ */
+extern SegmentMap hitSegments;
+extern uint8_t hitCount;
+
+/**
+ * @brief Builds the inverted index of the predefined maps, must be
+ *        called before the first game.
+ */
+void initMapIndex(void);
+
+/**
+ * @brief Marks every map as candidate for a new game.
+ */
+void resetCandidateMaps(void);
+
+/**
+ * @brief Narrows the candidate maps with the result of a shot.
+ * @param [in] The ID of the segment fired at.
+ * @param [in] True if the shot hit a ship.
+ */
+static inline void narrowCandidateMaps(uint8_t segment, bool hit) {
+
+    // Ignoring corrupted segment IDs
+    if(segment >= LCD_SEGMENTS_COUNT) return;
+
+    // A hit keeps the maps with a ship on the segment, a miss the others
+    candidateMaps &= hit ? segmentMaps[segment] : (uint16_t) ~segmentMaps[segment];
+
+    // Counting every ship part once
+    if(hit && !segmentMapTest(hitSegments, segment)) {
+        segmentMapSet(hitSegments, segment);
+        hitCount++;
+    }
+}
+
+/**
+ * @brief   Returns the expected number of shots left in the running game
+ *          under optimal play.
+ * @returns The number of shots, or -1 if no map agrees with the shots
+ *          (e.g. a message was lost).
+ */
+double expectedRemainingShots(void);
+
+/**
+ * @brief Prints the candidate maps and the expected remaining shots.
+ */
+void printCandidateMaps(void);
+
+#endif // MAP_INDEX_H
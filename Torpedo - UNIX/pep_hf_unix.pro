@@ -3,15 +3,30 @@ CONFIG += console
 CONFIG -= app_bundle
 CONFIG -= qt
 
+INCLUDEPATH += \
+    "$$PWD/../Torpedo - EFM32GG/src"
+
 SOURCES += main.c \
     game_control.c \
     game_statistics.c \
-    command_args.c
+    trace_export.c \
+    serial_link.c \
+    command_args.c \
+    map_index.c \
+    bot.c \
+    "$$PWD/../Torpedo - EFM32GG/src/game_core.c" \
+    "$$PWD/../Torpedo - EFM32GG/src/map_solver.c"
 
 HEADERS += \
     game_control.h \
     game_statistics.h \
-    command_args.h
+    trace_export.h \
+    serial_link.h \
+    command_args.h \
+    map_index.h \
+    bot.h \
+    "$$PWD/../Torpedo - EFM32GG/src/game_core.h" \
+    "$$PWD/../Torpedo - EFM32GG/src/map_solver.h"
 
 LIBS += \
     -pthread
@@ -0,0 +1,301 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    serial_link.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Host to EFM32GG command implementation and baud-rate negotiation.
+ ********************************************************************************/
+
+// Standard includes
+#include <pthread.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+
+// Project includes
+#include "serial_link.h"
+#include "command_args.h"
+
+
+/**
+ * @brief The baud-rates proposed to the EFM32GG, fastest first.
+ */
+static const uint32_t proposedBaudrates[] = { 921600, 460800, 230400, 0 };
+
+// Flag indicating that the baud-rate is being switched
+volatile int linkNegotiating = 0;
+
+// Flag indicating that the stored messages are being replayed
+volatile int backlogReplaying = 0;
+
+// Protects the answers below, which are set by the statistics task
+static pthread_mutex_t answerMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t answerReceived = PTHREAD_COND_INITIALIZER;
+
+// The last baud-rate acknowledge
+static int ackReceived = 0;
+static int ackAccepted = 0;
+static uint32_t ackBaudrate = 0;
+
+// The last echo answer
+static int echoReceived = 0;
+static uint8_t echoValue = 0;
+
+// Flag indicating that the stored messages were replayed
+static int backlogFlushed = 0;
+
+
+/**
+ * @brief   Writes a command frame to the terminal.
+ * @param   [in] The file descriptor of the terminal.
+ * @param   [in] The command identifier.
+ * @param   [in] The command fields.
+ * @param   [in] The number of bytes in the command fields.
+ * @returns Zero on success, -1 on failure.
+ */
+static int sendCommand(int terminalFileDescriptor, CommandType command,
+                       const uint8_t *fields, size_t length) {
+
+    // Assembling the frame
+    uint8_t frame[2 + 4];
+    frame[0] = COMMAND_START;
+    frame[1] = command;
+    for(size_t i = 0; i < length; i++) frame[2 + i] = fields[i];
+
+    return writeToBoard(terminalFileDescriptor, frame, 2 + length);
+}
+
+/**
+ * @brief   Waits for an answer flag to be set by the statistics task.
+ * @param   [in] The flag to wait for, protected by answerMutex.
+ * @param   [in] The timeout in milliseconds.
+ * @returns Nonzero if the flag was set in time.
+ */
+static int waitForAnswer(int *flag, unsigned timeoutMs) {
+
+    // Calculating the absolute deadline
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeoutMs / 1000;
+    deadline.tv_nsec += (timeoutMs % 1000) * 1000000L;
+    if(deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&answerMutex);
+    while(!*flag) {
+        if(pthread_cond_timedwait(&answerReceived, &answerMutex, &deadline) == ETIMEDOUT) break;
+    }
+    int received = *flag;
+    pthread_mutex_unlock(&answerMutex);
+
+    return received;
+}
+
+/**
+ * @brief   Sends an echo command and waits for the answer.
+ * @param   [in] The file descriptor of the terminal.
+ * @param   [in] The value to send.
+ * @returns Nonzero if the value came back in time.
+ */
+static int verifyEcho(int terminalFileDescriptor, uint8_t value) {
+
+    pthread_mutex_lock(&answerMutex);
+    echoReceived = 0;
+    pthread_mutex_unlock(&answerMutex);
+
+    if(sendCommand(terminalFileDescriptor, CommandEcho, &value, 1) == -1) return 0;
+
+    if(!waitForAnswer(&echoReceived, LINK_ANSWER_TIMEOUT_MS)) return 0;
+
+    pthread_mutex_lock(&answerMutex);
+    int matching = echoValue == value;
+    pthread_mutex_unlock(&answerMutex);
+
+    return matching;
+}
+
+/**
+ * @brief   Applies the specified baud-rate to the terminal.
+ * @param   [in] The file descriptor of the terminal.
+ * @param   [in] The termios structure applied to the terminal.
+ * @param   [in] The baud-rate (in bits/seconds).
+ * @returns Zero on success, -1 on failure.
+ */
+static int setTerminalBaudrate(int terminalFileDescriptor, struct termios *terminal, uint32_t baudrate) {
+
+    // Waiting for the pending bytes to leave at the current rate
+    tcdrain(terminalFileDescriptor);
+
+    cfsetospeed(terminal, toTermiosSpeed(baudrate));
+    cfsetispeed(terminal, toTermiosSpeed(baudrate));
+
+    if(tcsetattr(terminalFileDescriptor, TCSANOW, terminal) == -1) {
+        perror("Cannot set up terminal baud-rate");
+        return -1;
+    }
+
+    return 0;
+}
+
+int writeToBoard(int terminalFileDescriptor, const uint8_t *data, size_t length) {
+
+    // Prefixing the data with the wake byte, so the first byte is
+    // not lost if the EFM32GG sleeps in EM2
+    uint8_t buffer[1 + WRITE_MAX_LENGTH];
+    buffer[0] = WAKE_BYTE;
+    for(size_t i = 0; i < length && i < sizeof(buffer) - 1; i++) buffer[1 + i] = data[i];
+
+    if(length > sizeof(buffer) - 1 ||
+       write(terminalFileDescriptor, buffer, 1 + length) != (ssize_t)(1 + length))
+    {
+        perror("Cannot write to the EFM32GG");
+        return -1;
+    }
+
+    return 0;
+}
+
+int sendTickPeriodCommand(int terminalFileDescriptor, uint8_t tickPeriodMs) {
+    return sendCommand(terminalFileDescriptor, CommandSetTickPeriod, &tickPeriodMs, 1);
+}
+
+int attachToBoard(int terminalFileDescriptor) {
+
+    pthread_mutex_lock(&answerMutex);
+    backlogFlushed = 0;
+    pthread_mutex_unlock(&answerMutex);
+
+    if(sendCommand(terminalFileDescriptor, CommandAttach, NULL, 0) == -1) return -1;
+
+    // The stored messages are replayed by the statistics task
+    if(!waitForAnswer(&backlogFlushed, LINK_BACKLOG_TIMEOUT_MS)) {
+        fprintf(stderr, "WARNING: The EFM32GG did not flush its stored messages.\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int sendHeartbeat(int terminalFileDescriptor) {
+    return sendCommand(terminalFileDescriptor, CommandAttach, NULL, 0);
+}
+
+int detachFromBoard(int terminalFileDescriptor) {
+    return sendCommand(terminalFileDescriptor, CommandDetach, NULL, 0);
+}
+
+int requestHistory(int terminalFileDescriptor) {
+    return sendCommand(terminalFileDescriptor, CommandReadHistory, NULL, 0);
+}
+
+void notifyBacklogFlushed(void) {
+    pthread_mutex_lock(&answerMutex);
+    backlogFlushed = 1;
+    pthread_cond_broadcast(&answerReceived);
+    pthread_mutex_unlock(&answerMutex);
+}
+
+void notifyBaudrateAck(uint32_t baudrate, int accepted) {
+    pthread_mutex_lock(&answerMutex);
+    ackBaudrate = baudrate;
+    ackAccepted = accepted;
+    ackReceived = 1;
+    pthread_cond_broadcast(&answerReceived);
+    pthread_mutex_unlock(&answerMutex);
+}
+
+void notifyEcho(uint8_t value) {
+    pthread_mutex_lock(&answerMutex);
+    echoValue = value;
+    echoReceived = 1;
+    pthread_cond_broadcast(&answerReceived);
+    pthread_mutex_unlock(&answerMutex);
+}
+
+int switchBaudrate(int terminalFileDescriptor, struct termios *terminal,
+                   uint32_t currentBaudrate, uint32_t baudrate) {
+
+    // The value sent in the next echo, changed to tell stale answers apart
+    static uint8_t echoCounter = 0;
+
+    // Checking termios support
+    if(toTermiosSpeed(baudrate) == 0) return -1;
+
+    pthread_mutex_lock(&answerMutex);
+    ackReceived = 0;
+    pthread_mutex_unlock(&answerMutex);
+
+    // Proposing the baud-rate at the current rate
+    uint8_t fields[4] = { baudrate, baudrate >> 8, baudrate >> 16, baudrate >> 24 };
+    if(sendCommand(terminalFileDescriptor, CommandProposeBaudrate, fields, 4) == -1) return -1;
+
+    if(!waitForAnswer(&ackReceived, LINK_ANSWER_TIMEOUT_MS)) {
+        fprintf(stderr, "WARNING: The EFM32GG did not answer the Baud-rate proposal.\n");
+        return -1;
+    }
+
+    pthread_mutex_lock(&answerMutex);
+    int accepted = ackAccepted && ackBaudrate == baudrate;
+    pthread_mutex_unlock(&answerMutex);
+
+    if(!accepted) return -1;
+
+    // Switching the host side and verifying the link at the new rate
+    linkNegotiating = 1;
+    int status = setTerminalBaudrate(terminalFileDescriptor, terminal, baudrate);
+    if(status == 0 && verifyEcho(terminalFileDescriptor, ++echoCounter)) {
+        linkNegotiating = 0;
+        printf("INFO: Baud-rate switched to %u\n", baudrate);
+        return 0;
+    }
+
+    // Falling back to the current rate after the EFM32GG gave up waiting
+    setTerminalBaudrate(terminalFileDescriptor, terminal, currentBaudrate);
+    usleep((LINK_VERIFY_TIMEOUT_MS + LINK_ANSWER_TIMEOUT_MS) * 1000);
+    if(!verifyEcho(terminalFileDescriptor, ++echoCounter)) {
+        fprintf(stderr, "ERROR: The link to the EFM32GG is lost, please reset the device.\n");
+    }
+    linkNegotiating = 0;
+
+    fprintf(stderr, "WARNING: The link does not sustain %u Baud.\n", baudrate);
+    return -1;
+}
+
+uint32_t negotiateBaudrate(int terminalFileDescriptor, struct termios *terminal, uint32_t baudrate) {
+
+    // Trying the faster baud-rates, fastest first
+    for(unsigned i = 0; proposedBaudrates[i] > baudrate; i++) {
+        if(switchBaudrate(terminalFileDescriptor, terminal, baudrate, proposedBaudrates[i]) == 0) {
+            return proposedBaudrates[i];
+        }
+    }
+
+    return baudrate;
+}
@@ -0,0 +1,215 @@
+#pragma once
+#ifndef SERIAL_LINK_H
+#define SERIAL_LINK_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    serial_link.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.22
+ * @license	MIT License
+ *
+ * @brief   Host to EFM32GG command declarations and baud-rate negotiation.
+ ********************************************************************************/
+
+// Standard includes
+#include <termios.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/**
+ * @brief Defines the byte starting a command frame to the EFM32GG.
+ */
+#define COMMAND_START               (0xFF)
+
+/**
+ * @brief Defines the byte sent before every write to wake the EFM32GG from EM2.
+ *        The EFM32GG loses it while waking up, or ignores it.
+ */
+#define WAKE_BYTE                   (0x00)
+
+/**
+ * @brief Defines the longest data written to the EFM32GG at once, the
+ *        length of its input ring.
+ */
+#define WRITE_MAX_LENGTH            (16)
+
+/**
+ * @brief Defines the time the EFM32GG waits for the echo at a new baud-rate.
+ */
+#define LINK_VERIFY_TIMEOUT_MS      (500)
+
+/**
+ * @brief Defines the time the host waits for an answer of the EFM32GG.
+ */
+#define LINK_ANSWER_TIMEOUT_MS      (200)
+
+/**
+ * @brief Defines the period of the attach command repeated as a heartbeat.
+ *        The EFM32GG stores its messages if the host is silent for 3 seconds.
+ */
+#define LINK_HEARTBEAT_PERIOD_MS    (1000)
+
+/**
+ * @brief Defines the time the host waits for the EFM32GG to flush the
+ *        messages it stored: a full transmit buffer at 115200 Baud.
+ */
+#define LINK_BACKLOG_TIMEOUT_MS     (1000)
+
+/**
+ * @brief Defines the tick period of the EFM32GG after reset.
+ */
+#define TICK_PERIOD_DEFAULT_MS      (10)
+
+/**
+ * @brief Defines the shortest and longest tick period that can be requested.
+ */
+#define TICK_PERIOD_MIN_MS          (5)
+#define TICK_PERIOD_MAX_MS          (100)
+
+/**
+ * @brief Defines the change of the tick period per +/- key press.
+ */
+#define TICK_PERIOD_STEP_MS         (5)
+
+/**
+ * @brief Describes the commands sent to the EFM32GG.
+ */
+typedef enum CommandType {
+    CommandSetTickPeriod = 1,   /**< uint8_t tick period in milliseconds.   */
+    CommandProposeBaudrate,     /**< uint32_t baud-rate to switch to.       */
+    CommandEcho,                /**< uint8_t value to send back.            */
+    CommandAttach,              /**< No fields, repeated as a heartbeat.    */
+    CommandDetach,              /**< No fields, the host leaves.            */
+    CommandReadHistory          /**< No fields, the history is sent back.   */
+} CommandType;
+
+/**
+ * @brief Flag indicating that the baud-rate is being switched, and
+ *        garbage may be received by the statistics task.
+ */
+extern volatile int linkNegotiating;
+
+/**
+ * @brief Flag indicating that the messages stored by the EFM32GG while
+ *        the host was detached are being replayed by the statistics task.
+ */
+extern volatile int backlogReplaying;
+
+
+/**
+ * @brief   Writes the specified bytes to the EFM32GG, preceded by a wake byte.
+ * @param   [in] The file descriptor of the terminal.
+ * @param   [in] The bytes to write, at most WRITE_MAX_LENGTH.
+ * @param   [in] The number of bytes.
+ * @returns Zero on success, -1 on failure.
+ */
+int writeToBoard(int terminalFileDescriptor, const uint8_t *data, size_t length);
+
+/**
+ * @brief   Sends a tick period command to the EFM32GG.
+ * @param   [in] The file descriptor of the terminal.
+ * @param   [in] The tick period in milliseconds.
+ * @returns Zero on success, -1 on failure.
+ */
+int sendTickPeriodCommand(int terminalFileDescriptor, uint8_t tickPeriodMs);
+
+/**
+ * @brief   Attaches the host to the EFM32GG, and waits until the messages
+ *          stored by the EFM32GG are replayed.
+ * @param   [in] The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int attachToBoard(int terminalFileDescriptor);
+
+/**
+ * @brief   Repeats the attach command as a heartbeat, the EFM32GG keeps
+ *          transmitting its messages while the heartbeat is received.
+ * @param   [in] The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int sendHeartbeat(int terminalFileDescriptor);
+
+/**
+ * @brief   Detaches the host, the EFM32GG stores its messages until the
+ *          next attach.
+ * @param   [in] The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int detachFromBoard(int terminalFileDescriptor);
+
+/**
+ * @brief   Requests the game history stored in the flash of the EFM32GG,
+ *          received by the statistics task.
+ * @param   [in] The file descriptor of the terminal.
+ * @returns Zero on success, -1 on failure.
+ */
+int requestHistory(int terminalFileDescriptor);
+
+/**
+ * @brief Passes the end of the replay from the statistics task to the
+ *        waiting attach.
+ */
+void notifyBacklogFlushed(void);
+
+/**
+ * @brief Passes a baud-rate acknowledge from the statistics task to the
+ *        waiting negotiation.
+ * @param [in] The acknowledged baud-rate.
+ * @param [in] Nonzero if the EFM32GG switches to the baud-rate.
+ */
+void notifyBaudrateAck(uint32_t baudrate, int accepted);
+
+/**
+ * @brief Passes an echo answer from the statistics task to the waiting
+ *        negotiation.
+ * @param [in] The value sent back by the EFM32GG.
+ */
+void notifyEcho(uint8_t value);
+
+/**
+ * @brief   Switches the terminal and the EFM32GG to the fastest baud-rate
+ *          both of them support. Every rate is verified with an echo, and
+ *          both ends fall back to the current rate on failure.
+ * @param   [in] The file descriptor of the terminal.
+ * @param   [in] The termios structure applied to the terminal.
+ * @param   [in] The current baud-rate (in bits/seconds).
+ * @returns The baud-rate in use after the negotiation.
+ */
+uint32_t negotiateBaudrate(int terminalFileDescriptor, struct termios *terminal, uint32_t baudrate);
+
+/**
+ * @brief   Switches the terminal and the EFM32GG to the specified baud-rate.
+ * @param   [in] The file descriptor of the terminal.
+ * @param   [in] The termios structure applied to the terminal.
+ * @param   [in] The current baud-rate (in bits/seconds).
+ * @param   [in] The new baud-rate (in bits/seconds).
+ * @returns Zero on success, -1 if the current baud-rate is kept.
+ */
+int switchBaudrate(int terminalFileDescriptor, struct termios *terminal,
+                   uint32_t currentBaudrate, uint32_t baudrate);
+
+#endif // SERIAL_LINK_H
@@ -0,0 +1,176 @@
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    trace_export.c
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.21
+ * @license	MIT License
+ *
+ * @brief   Chrome trace JSON export implementation.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdint.h>
+#include <stdio.h>
+
+// Project includes
+#include "trace_export.h"
+
+
+/**
+ * @brief Defines the track ID offset of the interrupts.
+ */
+#define TRACE_ISR_TRACK     (1000)
+
+
+/**
+ * @brief Names of the instant events, indexed by TraceEventType.
+ */
+static const char *traceEventNames[] = {
+    [TraceTaskDelay]              = "delay",
+    [TraceQueueSend]              = "queue send",
+    [TraceQueueSendFailed]        = "queue send failed",
+    [TraceQueueSendFromISR]       = "queue send from ISR",
+    [TraceQueueReceive]           = "queue receive",
+    [TraceQueueBlockingOnSend]    = "blocking on queue send",
+    [TraceQueueBlockingOnReceive] = "blocking on queue receive",
+    [TraceTaskNotify]             = "notify",
+    [TraceTaskNotifyFromISR]      = "notify from ISR",
+    [TraceTaskNotifyWait]         = "notify wait"
+};
+
+/**
+ * @brief  Returns the name of the task with the specified number.
+ * @param  [in] The trace dump.
+ * @param  [in] The number of the task.
+ * @return The name of the task or "task".
+ */
+static const char* taskName(const TraceDump *dump, unsigned number) {
+    for(unsigned i = 0; i < dump->taskCount; i++) {
+        if(dump->tasks[i].number == number) return dump->tasks[i].name;
+    }
+    return "task";
+}
+
+/**
+ * @brief   Writes the specified trace dump as Chrome trace JSON, which
+ *          can be opened by chrome://tracing or ui.perfetto.dev.
+ * @details Every task gets its own track with its running intervals,
+ *          queue and notification events are instant events on the
+ *          track of the running task, interrupts get their own tracks.
+ * @param   [in] The output file.
+ * @param   [in] The trace dump to write.
+ * @returns Zero on success, -1 on failure.
+ */
+int writeChromeTrace(FILE *file, const TraceDump *dump) {
+
+    // Checking the clock frequency
+    if(dump->clockHz == 0) return -1;
+
+    // Microseconds per cycle
+    double usPerCycle = 1e6 / dump->clockHz;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                  "\"args\":{\"name\":\"EFM32GG\"}}");
+
+    // Naming the task tracks
+    for(unsigned i = 0; i < dump->taskCount; i++) {
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                      "\"args\":{\"name\":\"%s\"}}",
+                dump->tasks[i].number, dump->tasks[i].name);
+    }
+
+    // The cycle counter extended to 64 bits
+    uint64_t cycles = 0;
+    uint32_t previousTimestamp = dump->eventCount > 0 ? dump->events[0].timestamp : 0;
+
+    // The running task and the start of its interval
+    int runningTask = -1;
+    double runningSince = 0;
+
+    // The interrupt being handled or -1
+    int runningISR = -1;
+
+    for(unsigned i = 0; i < dump->eventCount; i++) {
+        const TraceEvent *event = &dump->events[i];
+
+        // Unwrapping the 32 bit cycle counter
+        cycles += (uint32_t)(event->timestamp - previousTimestamp);
+        previousTimestamp = event->timestamp;
+        double ts = cycles * usPerCycle;
+
+        switch(event->event) {
+        case TraceTaskSwitchedIn:
+
+            // Closing the interval of the previous task
+            if(runningTask != -1) {
+                fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                              "\"ts\":%.3lf,\"dur\":%.3lf}",
+                        taskName(dump, runningTask), runningTask, runningSince, ts - runningSince);
+            }
+
+            runningTask = event->argument;
+            runningSince = ts;
+            break;
+
+        case TraceISREnter:
+            fprintf(file, ",\n{\"name\":\"IRQ %u\",\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3lf}",
+                    event->argument, TRACE_ISR_TRACK + event->argument, ts);
+            runningISR = event->argument;
+            break;
+
+        case TraceISRExit:
+            fprintf(file, ",\n{\"name\":\"IRQ %u\",\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3lf}",
+                    event->argument, TRACE_ISR_TRACK + event->argument, ts);
+            runningISR = -1;
+            break;
+
+        default:
+
+            // Skipping unknown events
+            if(event->event >= sizeof(traceEventNames) / sizeof(traceEventNames[0])) break;
+
+            // Placing the event on the track of the interrupt or the running task
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,"
+                          "\"ts\":%.3lf,\"args\":{\"argument\":\"0x%04x\"}}",
+                    traceEventNames[event->event],
+                    runningISR != -1 ? TRACE_ISR_TRACK + runningISR : (runningTask != -1 ? runningTask : 0),
+                    ts, event->argument);
+            break;
+        }
+    }
+
+    // Closing the interval of the last task
+    if(runningTask != -1) {
+        double ts = cycles * usPerCycle;
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                      "\"ts\":%.3lf,\"dur\":%.3lf}",
+                taskName(dump, runningTask), runningTask, runningSince, ts - runningSince);
+    }
+
+    fprintf(file, "\n]}\n");
+
+    return ferror(file) ? -1 : 0;
+}
@@ -0,0 +1,114 @@
+#pragma once
+#ifndef TRACE_EXPORT_H
+#define TRACE_EXPORT_H
+
+/*********************************************************************************
+ * Copyright (c) 2020 Peter Gyulai, Balazs Zombó
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ * OR OTHER DEALINGS IN THE SOFTWARE.
+ *********************************************************************************/
+
+/*********************************************************************************
+ * @file    trace_export.h
+ * @author  Peter Gyulai, Balazs Zombó
+ * @version 1.0.0
+ * @date    2020.05.21
+ * @license	MIT License
+ *
+ * @brief   Event trace types and Chrome trace JSON export declarations.
+ ********************************************************************************/
+
+// Standard includes
+#include <stdint.h>
+#include <stdio.h>
+
+
+/**
+ * @brief Defines the number of task name characters in a trace dump.
+ */
+#define TRACE_TASK_NAME_LENGTH  (8)
+
+/**
+ * @brief Defines the maximum number of tasks listed in a trace dump.
+ */
+#define TRACE_MAX_TASKS         (8)
+
+
+/**
+ * @brief Describes the possible trace event types, in the order
+ *        defined by the firmware.
+ */
+typedef enum TraceEventType {
+    TraceTaskSwitchedIn,
+    TraceTaskDelay,
+    TraceQueueSend,
+    TraceQueueSendFailed,
+    TraceQueueSendFromISR,
+    TraceQueueReceive,
+    TraceQueueBlockingOnSend,
+    TraceQueueBlockingOnReceive,
+    TraceTaskNotify,
+    TraceTaskNotifyFromISR,
+    TraceTaskNotifyWait,
+    TraceISREnter,
+    TraceISRExit
+} TraceEventType;
+
+/**
+ * @brief Describes one task listed in a trace dump.
+ */
+typedef struct TraceTask {
+    uint8_t number;                             /**< The unique number of the task.    */
+    char    name[TRACE_TASK_NAME_LENGTH + 1];   /**< The name of the task.             */
+} TraceTask;
+
+/**
+ * @brief Describes one recorded trace event.
+ */
+typedef struct TraceEvent {
+    uint32_t timestamp;     /**< The value of the cycle counter when the event was recorded.   */
+    uint8_t  event;         /**< The type of the event.                                         */
+    uint16_t argument;      /**< The argument of the event (task number, queue or IRQ number).  */
+} TraceEvent;
+
+/**
+ * @brief Describes a complete trace dump received from the EFM32GG.
+ */
+typedef struct TraceDump {
+    uint32_t   clockHz;                     /**< The frequency of the cycle counter.   */
+    uint8_t    taskCount;                   /**< The number of tasks listed.           */
+    TraceTask  tasks[TRACE_MAX_TASKS];      /**< The tasks listed.                     */
+    uint16_t   eventCount;                  /**< The number of events recorded.        */
+    TraceEvent *events;                     /**< The events from the oldest.           */
+} TraceDump;
+
+
+/**
+ * @brief   Writes the specified trace dump as Chrome trace JSON, which
+ *          can be opened by chrome://tracing or ui.perfetto.dev.
+ * @details Every task gets its own track with its running intervals,
+ *          queue and notification events are instant events on the
+ *          track of the running task, interrupts get their own tracks.
+ * @param   [in] The output file.
+ * @param   [in] The trace dump to write.
+ * @returns Zero on success, -1 on failure.
+ */
+int writeChromeTrace(FILE *file, const TraceDump *dump);
+
+#endif // TRACE_EXPORT_H